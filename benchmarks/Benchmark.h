@@ -0,0 +1,68 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Minimal micro-benchmark harness: function is run in batches, batch size is grown until a batch
+// takes at least minBatchTime, then the fastest of several batches is reported per call
+
+namespace bench {
+
+const double minBatchTime = 0.01;
+const unsigned int batchCount = 10;
+
+// keeps value (and computation producing it) from being optimized away
+template <typename T>
+inline void DoNotOptimize (const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile ("" : : "m" (value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+template <typename F>
+double MeasureBatch (F& function, uint64_t iterations)
+{
+    auto start = std::chrono::steady_clock::now ();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        function ();
+    }
+    auto end = std::chrono::steady_clock::now ();
+
+    return std::chrono::duration<double> (end - start).count ();
+}
+
+template <typename F>
+void Run (const char* name, F function)
+{
+    uint64_t iterations = 1;
+    std::vector<double> batchTimes;
+
+    // calibrate batch size (also warms up caches)
+    while (MeasureBatch (function, iterations) < minBatchTime)
+    {
+        iterations *= 2;
+    }
+
+    for (unsigned int i = 0; i < batchCount; i++)
+    {
+        batchTimes.push_back (MeasureBatch (function, iterations));
+    }
+
+    // minimum is least disturbed by other processes
+    double time = *std::min_element (batchTimes.begin (), batchTimes.end ()) / iterations;
+
+    std::printf ("  %-44s %12.1f ns\n", name, time * 1.0e9);
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,300 @@
+#include "cilantroengine.h"
+#include "math/AABB.h"
+#include "math/AABBTree.h"
+#include "math/Frustum.h"
+#include "math/Mathf.h"
+#include "math/Vector3f.h"
+#include "math/Matrix4f.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace cilantro;
+
+// Compares AABBTree queries (frustum, box, sphere and ray) against testing every object (brute force)
+// for scenes of 1k, 10k and 100k randomly placed boxes
+
+namespace {
+
+const float worldSize = 1000.0f;
+const unsigned int queryCount = 64;
+const float sphereRadius = 50.0f;
+const float rayLength = 2.0f * worldSize;
+
+struct SBox
+{
+    Vector3f lower;
+    Vector3f upper;
+};
+
+struct SRay
+{
+    Vector3f origin;
+    Vector3f direction;
+};
+
+template <typename F>
+double MeasureMs (F function)
+{
+    auto start = std::chrono::steady_clock::now ();
+    function ();
+    auto end = std::chrono::steady_clock::now ();
+
+    return std::chrono::duration<double, std::milli> (end - start).count ();
+}
+
+std::vector<SBox> GenerateBoxes (size_t count, std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> position (-worldSize * 0.5f, worldSize * 0.5f);
+    std::uniform_real_distribution<float> size (0.5f, 5.0f);
+    std::vector<SBox> boxes (count);
+
+    for (auto&& box : boxes)
+    {
+        box.lower = Vector3f (position (generator), position (generator), position (generator));
+        box.upper = box.lower + Vector3f (size (generator), size (generator), size (generator));
+    }
+
+    return boxes;
+}
+
+std::vector<Frustum> GenerateFrustums (std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> position (-worldSize * 0.5f, worldSize * 0.5f);
+    Matrix4f projection = Mathf::GenPerspectiveProjectionMatrix (16.0f / 9.0f, Mathf::Deg2Rad (60.0f), 0.1f, 200.0f);
+    std::vector<Frustum> frustums;
+
+    for (unsigned int i = 0; i < queryCount; i++)
+    {
+        Vector3f eye (position (generator), position (generator), position (generator));
+        Vector3f target (position (generator), position (generator), position (generator));
+
+        frustums.push_back (Frustum (projection * Mathf::GenCameraViewMatrix (eye, target, Vector3f (0.0f, 1.0f, 0.0f))));
+    }
+
+    return frustums;
+}
+
+void Run (size_t objectCount)
+{
+    std::mt19937 generator (1234);
+    std::vector<SBox> boxes = GenerateBoxes (objectCount, generator);
+    std::vector<Frustum> frustums = GenerateFrustums (generator);
+    std::vector<handle_t> result;
+    size_t bruteHits = 0;
+    size_t treeHits = 0;
+    AABBTree tree;
+    std::vector<int32_t> proxies (objectCount);
+
+    std::printf ("objects: %zu\n", objectCount);
+
+    double buildMs = MeasureMs ([&] ()
+    {
+        for (size_t i = 0; i < objectCount; i++)
+        {
+            proxies[i] = tree.Insert (AABB (boxes[i].lower, boxes[i].upper), i);
+        }
+    });
+    std::printf ("  build                 %10.3f ms (height %d)\n", buildMs, tree.GetHeight ());
+
+    // frustum queries
+    double bruteFrustumMs = MeasureMs ([&] ()
+    {
+        for (auto&& frustum : frustums)
+        {
+            result.clear ();
+            for (size_t i = 0; i < objectCount; i++)
+            {
+                if (frustum.Intersects ((boxes[i].lower + boxes[i].upper) * 0.5f, (boxes[i].upper - boxes[i].lower) * 0.5f))
+                {
+                    result.push_back (i);
+                }
+            }
+            bruteHits += result.size ();
+        }
+    });
+
+    double treeFrustumMs = MeasureMs ([&] ()
+    {
+        for (auto&& frustum : frustums)
+        {
+            result.clear ();
+            tree.QueryFrustum (frustum, result);
+            treeHits += result.size ();
+        }
+    });
+
+    std::printf ("  frustum brute force   %10.3f ms / query (%zu hits)\n", bruteFrustumMs / queryCount, bruteHits / queryCount);
+    std::printf ("  frustum tree          %10.3f ms / query (%zu hits)\n", treeFrustumMs / queryCount, treeHits / queryCount);
+
+    // box queries
+    std::uniform_real_distribution<float> position (-worldSize * 0.5f, worldSize * 0.5f);
+    std::vector<SBox> queryBoxes;
+    for (unsigned int i = 0; i < queryCount; i++)
+    {
+        Vector3f lower (position (generator), position (generator), position (generator));
+        queryBoxes.push_back ({ lower, lower + Vector3f (50.0f, 50.0f, 50.0f) });
+    }
+
+    bruteHits = treeHits = 0;
+    double bruteBoxMs = MeasureMs ([&] ()
+    {
+        for (auto&& q : queryBoxes)
+        {
+            result.clear ();
+            for (size_t i = 0; i < objectCount; i++)
+            {
+                const SBox& b = boxes[i];
+                if (b.lower[0] <= q.upper[0] && b.upper[0] >= q.lower[0] &&
+                    b.lower[1] <= q.upper[1] && b.upper[1] >= q.lower[1] &&
+                    b.lower[2] <= q.upper[2] && b.upper[2] >= q.lower[2])
+                {
+                    result.push_back (i);
+                }
+            }
+            bruteHits += result.size ();
+        }
+    });
+
+    double treeBoxMs = MeasureMs ([&] ()
+    {
+        for (auto&& q : queryBoxes)
+        {
+            result.clear ();
+            tree.QueryBox (AABB (q.lower, q.upper), result);
+            treeHits += result.size ();
+        }
+    });
+
+    std::printf ("  box brute force       %10.3f ms / query (%zu hits)\n", bruteBoxMs / queryCount, bruteHits / queryCount);
+    std::printf ("  box tree              %10.3f ms / query (%zu hits)\n", treeBoxMs / queryCount, treeHits / queryCount);
+
+    // sphere queries
+    std::vector<Vector3f> sphereCenters;
+    for (unsigned int i = 0; i < queryCount; i++)
+    {
+        sphereCenters.push_back (Vector3f (position (generator), position (generator), position (generator)));
+    }
+
+    bruteHits = treeHits = 0;
+    double bruteSphereMs = MeasureMs ([&] ()
+    {
+        for (auto&& c : sphereCenters)
+        {
+            result.clear ();
+            for (size_t i = 0; i < objectCount; i++)
+            {
+                // squared distance from sphere center to closest point of the box
+                float distanceSquared = 0.0f;
+                for (unsigned int a = 0; a < 3; a++)
+                {
+                    float d = std::max (std::max (boxes[i].lower[a] - c[a], 0.0f), c[a] - boxes[i].upper[a]);
+                    distanceSquared += d * d;
+                }
+
+                if (distanceSquared <= sphereRadius * sphereRadius)
+                {
+                    result.push_back (i);
+                }
+            }
+            bruteHits += result.size ();
+        }
+    });
+
+    double treeSphereMs = MeasureMs ([&] ()
+    {
+        for (auto&& c : sphereCenters)
+        {
+            result.clear ();
+            tree.QuerySphere (c, sphereRadius, result);
+            treeHits += result.size ();
+        }
+    });
+
+    std::printf ("  sphere brute force    %10.3f ms / query (%zu hits)\n", bruteSphereMs / queryCount, bruteHits / queryCount);
+    std::printf ("  sphere tree           %10.3f ms / query (%zu hits)\n", treeSphereMs / queryCount, treeHits / queryCount);
+
+    // ray queries (like picking: each ray is aimed at the center of a random object)
+    std::uniform_int_distribution<size_t> target (0, objectCount - 1);
+    std::vector<SRay> rays;
+    for (unsigned int i = 0; i < queryCount; i++)
+    {
+        Vector3f origin (position (generator), position (generator), position (generator));
+        SBox& box = boxes[target (generator)];
+        rays.push_back ({ origin, Mathf::Normalize ((box.lower + box.upper) * 0.5f - origin) });
+    }
+
+    bruteHits = treeHits = 0;
+    double bruteRayMs = MeasureMs ([&] ()
+    {
+        for (auto&& ray : rays)
+        {
+            result.clear ();
+            for (size_t i = 0; i < objectCount; i++)
+            {
+                // slab test
+                float tMin = 0.0f;
+                float tMax = rayLength;
+                for (unsigned int a = 0; a < 3; a++)
+                {
+                    float invD = 1.0f / ray.direction[a];
+                    float t1 = (boxes[i].lower[a] - ray.origin[a]) * invD;
+                    float t2 = (boxes[i].upper[a] - ray.origin[a]) * invD;
+
+                    tMin = std::max (tMin, std::min (t1, t2));
+                    tMax = std::min (tMax, std::max (t1, t2));
+                }
+
+                if (tMin <= tMax)
+                {
+                    result.push_back (i);
+                }
+            }
+            bruteHits += result.size ();
+        }
+    });
+
+    double treeRayMs = MeasureMs ([&] ()
+    {
+        for (auto&& ray : rays)
+        {
+            result.clear ();
+            tree.QueryRay (ray.origin, ray.direction, rayLength, result);
+            treeHits += result.size ();
+        }
+    });
+
+    std::printf ("  ray brute force       %10.3f ms / query (%zu hits)\n", bruteRayMs / queryCount, bruteHits / queryCount);
+    std::printf ("  ray tree              %10.3f ms / query (%zu hits)\n", treeRayMs / queryCount, treeHits / queryCount);
+
+    // move every tenth object slightly (mostly absorbed by fattened bounds)
+    std::uniform_real_distribution<float> offset (-0.2f, 0.2f);
+    size_t reinserted = 0;
+    double updateMs = MeasureMs ([&] ()
+    {
+        for (size_t i = 0; i < objectCount; i += 10)
+        {
+            Vector3f delta (offset (generator), offset (generator), offset (generator));
+            boxes[i].lower += delta;
+            boxes[i].upper += delta;
+            reinserted += tree.Update (proxies[i], AABB (boxes[i].lower, boxes[i].upper)) ? 1 : 0;
+        }
+    });
+
+    std::printf ("  update 10%%            %10.3f ms (%zu reinserted)\n", updateMs, reinserted);
+}
+
+} // namespace
+
+int main ()
+{
+    for (size_t objectCount : { 1000, 10000, 100000 })
+    {
+        Run (objectCount);
+    }
+
+    return 0;
+}
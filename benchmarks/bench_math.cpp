@@ -0,0 +1,130 @@
+#include "cilantroengine.h"
+#include "math/AABB.h"
+#include "math/BSpline.h"
+#include "math/Mathf.h"
+#include "math/Matrix4f.h"
+#include "math/Quaternion.h"
+#include "math/Triangle.h"
+#include "math/Vector3f.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace cilantro;
+
+// Times single calls of math routines used every frame (per-object transforms, culling,
+// animation), reported as nanoseconds per call
+
+namespace {
+
+// inputs are cycled, so that results can not be computed once and reused
+const size_t inputCount = 256;
+const unsigned int clipTriangleCount = 64;
+const unsigned int splineControlPoints = 32;
+
+Quaternion RandomRotation (std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> angle (-180.0f, 180.0f);
+
+    return Mathf::EulerToQuaternion (Vector3f (Mathf::Deg2Rad (angle (generator)), Mathf::Deg2Rad (angle (generator)), Mathf::Deg2Rad (angle (generator))));
+}
+
+Matrix4f RandomTransform (std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> position (-100.0f, 100.0f);
+    std::uniform_real_distribution<float> scale (0.5f, 2.0f);
+
+    return Mathf::GenTranslationMatrix (position (generator), position (generator), position (generator))
+        * Mathf::GenRotationMatrix (RandomRotation (generator))
+        * Mathf::GenScalingMatrix (scale (generator), scale (generator), scale (generator));
+}
+
+} // namespace
+
+int main ()
+{
+    std::mt19937 generator (1234);
+    std::uniform_real_distribution<float> coordinate (-1.5f, 1.5f);
+    std::uniform_real_distribution<float> parameter (0.0f, 1.0f);
+
+    std::vector<Matrix4f> matrices;
+    std::vector<Quaternion> rotations;
+    std::vector<float> parameters;
+    std::vector<AABB> boxes;
+    size_t i = 0;
+
+    for (size_t n = 0; n < inputCount; n++)
+    {
+        Vector3f lower (coordinate (generator), coordinate (generator), coordinate (generator));
+
+        matrices.push_back (RandomTransform (generator));
+        rotations.push_back (RandomRotation (generator));
+        parameters.push_back (parameter (generator));
+        boxes.push_back (AABB (lower, lower + Vector3f (1.0f, 1.0f, 1.0f)));
+    }
+
+    // triangles around clip volume, partially outside of it
+    std::vector<Triangle<Vector3f>> triangles;
+    for (unsigned int n = 0; n < clipTriangleCount; n++)
+    {
+        triangles.push_back (Triangle<Vector3f> (
+            Vector3f (coordinate (generator), coordinate (generator), coordinate (generator)),
+            Vector3f (coordinate (generator), coordinate (generator), coordinate (generator)),
+            Vector3f (coordinate (generator), coordinate (generator), coordinate (generator))));
+    }
+
+    BSpline<Vector3f, 3> spline;
+    for (unsigned int n = 0; n < splineControlPoints; n++)
+    {
+        spline.AddControlPoint (Vector3f (coordinate (generator), coordinate (generator), coordinate (generator)));
+    }
+    spline.CalculateKnotVector ();
+
+    std::printf ("math:\n");
+
+    bench::Run ("Matrix4f multiply", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (matrices[i] * matrices[inputCount - 1 - i]);
+    });
+
+    bench::Run ("Mathf::Invert (Matrix4f)", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (Mathf::Invert (matrices[i]));
+    });
+
+    bench::Run ("Mathf::GenRotationMatrix", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (Mathf::GenRotationMatrix (rotations[i]));
+    });
+
+    bench::Run ("Mathf::Slerp", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (Mathf::Slerp (rotations[i], rotations[inputCount - 1 - i], parameters[i]));
+    });
+
+    bench::Run ("Mathf::QuaternionToEuler", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (Mathf::QuaternionToEuler (rotations[i]));
+    });
+
+    bench::Run ("AABB::ToSpace", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (boxes[i].ToSpace (matrices[i]));
+    });
+
+    // clipping is done in place, so each call starts with copy of input triangles
+    bench::Run ("Mathf::ClipTrianglesToPlanes (64 triangles)", [&] () {
+        std::vector<Triangle<Vector3f>> clipped = triangles;
+        Mathf::ClipTrianglesToPlanes (clipped, Vector3f (-1.0f, -1.0f, -1.0f), Vector3f (1.0f, 1.0f, 1.0f));
+        bench::DoNotOptimize (clipped);
+    });
+
+    bench::Run ("BSpline<Vector3f,3>::GetCurvePoint", [&] () {
+        i = (i + 1) % inputCount;
+        bench::DoNotOptimize (spline.GetCurvePoint (parameters[i]));
+    });
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "cilantroengine.h"
+#include "scene/GameScene.h"
+#include "scene/PerspectiveCamera.h"
+#include "scene/PBRMaterial.h"
+#include "scene/MeshObject.h"
+#include "scene/PointLight.h"
+#include "scene/DirectionalLight.h"
+#include "scene/Primitives.h"
+#include "resource/AssimpModelLoader.h"
+#include "resource/Mesh.h"
+#include "resource/ResourceManager.h"
+#include "graphics/EGLRenderer.h"
+#include "graphics/SurfaceRenderStage.h"
+#include "math/Mathf.h"
+#include "math/Vector2f.h"
+#include "math/Vector3f.h"
+#include "system/Game.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace cilantro;
+
+// Renders a scene offscreen (EGL, works with Mesa llvmpipe without display or GPU) while camera
+// orbits it on a fixed path, and reports frame time percentiles
+//
+// usage: bench_render [frames] [width] [height] [model]
+// without model, a procedural grid of primitives lit by point lights is rendered
+
+namespace {
+
+const unsigned int warmupFrames = 60;
+const float orbitRadius = 12.0f;
+const float orbitHeight = 4.0f;
+const int gridSize = 12;
+
+void CreateProceduralScene (std::shared_ptr<Game> game, std::shared_ptr<GameScene> scene)
+{
+    Primitives::GenerateCube (game->GetResourceManager ()->Create<Mesh> ("cubeMesh"));
+    Primitives::GenerateSphere (game->GetResourceManager ()->Create<Mesh> ("sphereMesh"), 3);
+
+    scene->Create<PBRMaterial> ("floorMaterial")
+        ->SetAlbedo (Vector3f (0.1f, 0.4f, 0.1f))
+        ->SetRoughness (0.6f)
+        ->SetMetallic (0.0f);
+
+    scene->Create<PBRMaterial> ("objectMaterial")
+        ->SetAlbedo (Vector3f (0.53f, 0.29f, 0.02f))
+        ->SetRoughness (0.3f)
+        ->SetMetallic (0.8f);
+
+    scene->Create<MeshObject> ("floor", "cubeMesh", "floorMaterial")
+        ->GetModelTransform ()->Scale (gridSize * 1.0f, 0.05f, gridSize * 1.0f)->Translate (0.0f, -0.05f, 0.0f);
+
+    for (int x = 0; x < gridSize; x++)
+    {
+        for (int z = 0; z < gridSize; z++)
+        {
+            std::string name = "object" + std::to_string (x) + "_" + std::to_string (z);
+
+            scene->Create<MeshObject> (name, (x + z) % 2 == 0 ? "cubeMesh" : "sphereMesh", "objectMaterial")
+                ->GetModelTransform ()->Scale (0.4f)->Translate (x * 2.0f - gridSize + 1.0f, 0.4f, z * 2.0f - gridSize + 1.0f);
+        }
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        float angle = Mathf::Deg2Rad (45.0f * i);
+
+        scene->Create<PointLight> ("pointLight" + std::to_string (i))
+            ->SetLinearAttenuationFactor (0.0f)
+            ->SetQuadraticAttenuationFactor (1.0f)
+            ->SetColor (Vector3f (5.0f, 5.0f, 5.0f))
+            ->SetEnabled (true)
+            ->GetModelTransform ()->Translate (std::cos (angle) * gridSize * 0.5f, 1.5f, std::sin (angle) * gridSize * 0.5f);
+    }
+}
+
+double GetPercentile (const std::vector<double>& sortedTimes, double percentile)
+{
+    size_t index = static_cast<size_t> (std::ceil (percentile / 100.0 * sortedTimes.size ()));
+
+    return sortedTimes[std::clamp<size_t> (index, 1, sortedTimes.size ()) - 1];
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+{
+    unsigned int frameCount = argc > 1 ? std::max (std::atoi (argv[1]), 1) : 1000;
+    unsigned int width = argc > 2 ? std::atoi (argv[2]) : 1280;
+    unsigned int height = argc > 3 ? std::atoi (argv[3]) : 720;
+    std::string modelPath = argc > 4 ? argv[4] : "";
+    std::vector<double> frameTimes;
+
+    auto game = std::make_shared<Game> ();
+    game->Initialize ();
+
+    auto scene = game->Create<GameScene> ("scene");
+    auto renderer = scene->Create<EGLRenderer> (width, height, true, true);
+
+    renderer->Create<SurfaceRenderStage> ("hdr_postprocess")
+        ->SetShaderProgram ("post_hdr_shader")
+        ->SetColorAttachmentsFramebufferLink (EPipelineLink::LINK_THIRD);
+
+    renderer->Create<SurfaceRenderStage> ("fxaa_postprocess")
+        ->SetShaderProgram ("post_fxaa_shader")
+        ->SetRenderStageParameterFloat ("fMaxSpan", 4.0f)
+        ->SetRenderStageParameterVector2f ("vInvResolution", Vector2f (1.0f / renderer->GetWidth (), 1.0f / renderer->GetHeight ()))
+        ->SetColorAttachmentsFramebufferLink (EPipelineLink::LINK_PREVIOUS);
+
+    renderer->Create<SurfaceRenderStage> ("gamma_postprocess+screen")
+        ->SetShaderProgram ("post_gamma_shader")
+        ->SetRenderStageParameterFloat ("fGamma", 2.1f)
+        ->SetColorAttachmentsFramebufferLink (EPipelineLink::LINK_PREVIOUS)
+        ->SetFramebufferEnabled (false);
+
+    if (modelPath.empty ())
+    {
+        CreateProceduralScene (game, scene);
+    }
+    else
+    {
+        AssimpModelLoader modelLoader (game);
+        modelLoader.Load ("scene", modelPath);
+    }
+
+    scene->Create<DirectionalLight> ("sun")
+        ->SetColor (Vector3f (2.0f, 2.0f, 2.0f))
+        ->SetEnabled (true)
+        ->GetModelTransform ()->Rotate (45.0f, -135.0f, 0.0f);
+
+    auto camera = scene->Create<PerspectiveCamera> ("camera", 60.0f, 0.1f, 100.0f);
+    scene->SetActiveCamera ("camera");
+
+    scene->OnStart ();
+
+    // camera position depends on frame index only, so that every run renders the same frames
+    for (unsigned int i = 0; i < warmupFrames + frameCount; i++)
+    {
+        float yaw = 360.0f * i / (warmupFrames + frameCount);
+        float angle = Mathf::Deg2Rad (yaw);
+
+        camera->GetModelTransform ()
+            ->Translate (orbitRadius * std::sin (angle), orbitHeight, orbitRadius * std::cos (angle))
+            ->Rotate (-Mathf::Rad2Deg (std::atan2 (orbitHeight, orbitRadius)), yaw, 0.0f);
+
+        auto start = std::chrono::steady_clock::now ();
+        game->Step ();
+        auto end = std::chrono::steady_clock::now ();
+
+        // first frames link shaders and fill caches
+        if (i >= warmupFrames)
+        {
+            frameTimes.push_back (std::chrono::duration<double, std::milli> (end - start).count ());
+        }
+    }
+
+    scene->OnEnd ();
+
+    std::sort (frameTimes.begin (), frameTimes.end ());
+
+    std::printf ("frames: %u (%ux%u)\n", frameCount, width, height);
+    std::printf ("  mean                  %10.3f ms\n", std::accumulate (frameTimes.begin (), frameTimes.end (), 0.0) / frameTimes.size ());
+    std::printf ("  p50                   %10.3f ms\n", GetPercentile (frameTimes, 50.0));
+    std::printf ("  p90                   %10.3f ms\n", GetPercentile (frameTimes, 90.0));
+    std::printf ("  p95                   %10.3f ms\n", GetPercentile (frameTimes, 95.0));
+    std::printf ("  p99                   %10.3f ms\n", GetPercentile (frameTimes, 99.0));
+    std::printf ("  max                   %10.3f ms\n", frameTimes.back ());
+
+    game->Deinitialize ();
+
+    return 0;
+}
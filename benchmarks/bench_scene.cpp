@@ -0,0 +1,165 @@
+#include "cilantroengine.h"
+#include "scene/AnimationObject.h"
+#include "scene/AnimationProperty.h"
+#include "scene/GameObject.h"
+#include "scene/GameScene.h"
+#include "scene/Primitives.h"
+#include "scene/Transform.h"
+#include "resource/Mesh.h"
+#include "resource/ResourceManager.h"
+#include "math/Mathf.h"
+#include "math/Quaternion.h"
+#include "math/Vector3f.h"
+#include "system/Game.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using namespace cilantro;
+
+// Times scene updates done every frame: transform setters (alone and with game object
+// hook dispatch), world transform propagation through hierarchies, mesh attribute
+// recalculation and keyframe animation sampling (no renderer is created)
+
+namespace {
+
+const unsigned int deepHierarchyLevels = 100;
+const unsigned int wideHierarchyChildren = 1000;
+const unsigned int sphereSubdivisions = 4;
+const unsigned int keyframeCount = 1000;
+const float keyframeInterval = 0.1f;
+
+} // namespace
+
+int main ()
+{
+    auto game = std::make_shared<Game> ();
+    game->Initialize ();
+
+    auto scene = game->Create<GameScene> ("scene");
+    float t = 0.0f;
+
+    std::printf ("transform:\n");
+
+    // transform with single subscriber doing nothing measures setter and hook overhead only
+    auto transform = std::make_shared<Transform> ();
+    transform->SubscribeHook ("OnUpdateTransform", [] () {});
+
+    bench::Run ("Transform::Translate", [&] () {
+        t += 0.001f;
+        transform->Translate (t, 1.0f, 2.0f);
+    });
+
+    bench::Run ("Transform::Rotate (euler)", [&] () {
+        t += 0.001f;
+        transform->Rotate (t, 45.0f, 0.0f);
+    });
+
+    bench::Run ("Transform::Scale", [&] () {
+        t += 0.001f;
+        transform->Scale (1.0f + t, 1.0f, 1.0f);
+    });
+
+    bench::Run ("Transform::GetTransformMatrix", [&] () {
+        t += 0.001f;
+        transform->Translate (t, 1.0f, 2.0f);
+        bench::DoNotOptimize (transform->GetTransformMatrix ());
+    });
+
+    // game object hook recalculates world transform and publishes TransformUpdateMessage
+    auto object = scene->Create<GameObject> ("object");
+
+    bench::Run ("GameObject Translate (hook dispatch)", [&] () {
+        t += 0.001f;
+        object->GetModelTransform ()->Translate (t, 1.0f, 2.0f);
+    });
+
+    bench::Run ("GameObject Rotate (hook dispatch)", [&] () {
+        t += 0.001f;
+        object->GetModelTransform ()->Rotate (t, 45.0f, 0.0f);
+    });
+
+    std::printf ("hierarchy:\n");
+
+    // chain of objects, each one child of previous
+    auto deepTop = scene->Create<GameObject> ("deep0");
+    for (unsigned int i = 1; i < deepHierarchyLevels; i++)
+    {
+        scene->Create<GameObject> ("deep" + std::to_string (i))
+            ->SetParentObject ("deep" + std::to_string (i - 1))
+            ->GetModelTransform ()->Translate (0.0f, 1.0f, 0.0f)->Rotate (0.0f, 5.0f, 0.0f);
+    }
+
+    bench::Run ("CalculateWorldTransformMatrix (deep, 100)", [&] () {
+        deepTop->CalculateWorldTransformMatrix ();
+    });
+
+    // single parent with many children
+    auto wideTop = scene->Create<GameObject> ("wide");
+    for (unsigned int i = 0; i < wideHierarchyChildren; i++)
+    {
+        scene->Create<GameObject> ("wide" + std::to_string (i))
+            ->SetParentObject ("wide")
+            ->GetModelTransform ()->Translate (i * 1.0f, 0.0f, 0.0f);
+    }
+
+    bench::Run ("CalculateWorldTransformMatrix (wide, 1000)", [&] () {
+        wideTop->CalculateWorldTransformMatrix ();
+    });
+
+    std::printf ("mesh:\n");
+
+    auto sphere = game->GetResourceManager ()->Create<Mesh> ("sphere");
+    Primitives::GenerateSphere (sphere, sphereSubdivisions);
+    std::printf ("  (sphere: %zu vertices, %zu faces)\n", sphere->GetVertexCount (), sphere->GetFaceCount ());
+
+    bench::Run ("Mesh::CalculateVertexNormals", [&] () {
+        sphere->CalculateVertexNormals ();
+    });
+
+    bench::Run ("Mesh::CalculateTangentsBitangents", [&] () {
+        sphere->CalculateTangentsBitangents ();
+    });
+
+    std::printf ("animation:\n");
+
+    // properties are sampled directly, update functions are not called
+    auto animation = scene->Create<AnimationObject> ("animation");
+
+    auto positionProperty = animation->AddAnimationProperty<Vector3f> (
+        "position", Vector3f (0.0f, 0.0f, 0.0f),
+        [] (Vector3f) {},
+        [] (Vector3f v0, Vector3f v1, float u) { return Mathf::Lerp (v0, v1, u); });
+
+    auto rotationProperty = animation->AddAnimationProperty<Quaternion> (
+        "rotation", Mathf::EulerToQuaternion (Vector3f (0.0f, 0.0f, 0.0f)),
+        [] (Quaternion) {},
+        [] (Quaternion q0, Quaternion q1, float u) { return Mathf::Slerp (q0, q1, u); });
+
+    for (unsigned int i = 1; i <= keyframeCount; i++)
+    {
+        float angle = Mathf::Deg2Rad (i * 10.0f);
+
+        positionProperty->AddKeyframe (i * keyframeInterval, Vector3f (i * 1.0f, 0.0f, 0.0f));
+        rotationProperty->AddKeyframe (i * keyframeInterval, Mathf::EulerToQuaternion (Vector3f (0.0f, angle, 0.0f)));
+    }
+
+    float animationLength = keyframeCount * keyframeInterval;
+    float time = 0.0f;
+
+    bench::Run ("AnimationProperty<Vector3f>::GetFrame (1000)", [&] () {
+        time = time + 0.0137f > animationLength ? 0.0f : time + 0.0137f;
+        bench::DoNotOptimize (positionProperty->GetFrame (time));
+    });
+
+    bench::Run ("AnimationProperty<Quaternion>::GetFrame (1000)", [&] () {
+        time = time + 0.0137f > animationLength ? 0.0f : time + 0.0137f;
+        bench::DoNotOptimize (rotationProperty->GetFrame (time));
+    });
+
+    game->Deinitialize ();
+
+    return 0;
+}
@@ -6,21 +6,41 @@ typedef size_t handle_t;
 // defines
 #define CILANTRO_FPS                        60.0f
 #define CILANTRO_VBO_COUNT                  7
-#define CILANTRO_GLOBAL_UBO_COUNT           7
+#define CILANTRO_GLOBAL_UBO_COUNT           9
 #define CILANTRO_MAX_VERTICES               65536
 #define CILANTRO_MAX_TEXTURE_UNITS          16
 #define CILANTRO_MAX_POINT_LIGHTS           32
 #define CILANTRO_MAX_DIRECTIONAL_LIGHTS     32
 #define CILANTRO_MAX_SPOT_LIGHTS            32
+#define CILANTRO_LIGHT_CLUSTERS_X           16
+#define CILANTRO_LIGHT_CLUSTERS_Y           9
+#define CILANTRO_LIGHT_CLUSTERS_Z           24
+#define CILANTRO_LIGHT_CLUSTER_THRESHOLD    0.01f
+#define CILANTRO_MAX_MATERIALS              256
+#define CILANTRO_MATERIAL_BLOCK_SIZE        256
 #define CILANTRO_MAX_FRAMEBUFFER_TEXTURES   8
 #define CILANTRO_MAX_BONES                  128
 #define CILANTRO_MAX_BONE_INFLUENCES        4
+#define CILANTRO_GBUFFER_DEPTH_BINDING      4
 #define CILANTRO_SHADOW_MAP_BINDING         5
 #define CILANTRO_SHADOW_MAP_SIZE            4096
+#define CILANTRO_SHADOW_MAP_MIN_TILE_SIZE   128
+#define CILANTRO_SHADOW_MAP_MAX_TILE_SIZE   2048
+#define CILANTRO_SHADOW_CASCADE_TILE_SIZE   1024
+#define CILANTRO_MAX_SHADOW_CASCADES        4
 #define CILANTRO_SHADOW_MAP_DEPTH           32
 #define CILANTRO_SHADOW_BIAS                0.0025f
 #define CILANTRO_MULTISAMPLE                4
 #define CILANTRO_COMPUTE_GROUP_SIZE         256
+#define CILANTRO_BUFFERED_FRAMES            3
+#define CILANTRO_MIN_RENDER_SCALE           0.5f
+#define CILANTRO_RING_BUFFER_REGION_SIZE    4194304
+#define CILANTRO_GEOMETRY_POOL_VERTICES     131072
+#define CILANTRO_GEOMETRY_POOL_INDICES      393216
+#define CILANTRO_AABB_TREE_MARGIN           0.1f
+#define CILANTRO_SHADER_CACHE_PATH          "shadercache"
+#define CILANTRO_PROFILER_EVENTS            65536
+#define CILANTRO_PROFILER_NAME_LENGTH       48
 
 // linking
 #if defined _WIN32 || defined __CYGWIN__
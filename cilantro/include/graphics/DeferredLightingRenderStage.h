@@ -13,6 +13,12 @@ public:
 
     __EAPI virtual void OnFrame () override;
 
+    // shader program drawing light volumes of point and spot lights (used when enabled in renderer)
+    __EAPI std::shared_ptr<DeferredLightingRenderStage> SetLightVolumeShaderProgram (const std::string& shaderProgramName);
+
+private:
+    std::shared_ptr<ShaderProgram> m_lightVolumeShaderProgram;
+
 };
 
-} // namespace cilantro
\ No newline at end of file
+} // namespace cilantro
@@ -0,0 +1,57 @@
+#ifndef _EGLRENDERER_H_
+#define _EGLRENDERER_H_
+
+#include "cilantroengine.h"
+#include "glad/gl.h"
+
+// EGL platform header must not pull in X11 (its macros collide with engine names)
+#ifndef EGL_NO_X11
+  #define EGL_NO_X11
+#endif
+#ifndef MESA_EGL_NO_X11_HEADERS
+  #define MESA_EGL_NO_X11_HEADERS
+#endif
+#include "EGL/egl.h"
+#include "graphics/GLRenderer.h"
+
+namespace cilantro {
+
+// renderer without window, GL context is created through EGL (surfaceless if supported, pbuffer otherwise)
+// and frames are rendered into offscreen framebuffer used in place of default one
+class __CEAPI EGLRenderer : public GLRenderer
+{
+public:
+
+    __EAPI EGLRenderer (std::shared_ptr<GameScene> gameScene, unsigned int width, unsigned int height, bool shadowMappingEnabled, bool deferredRenderingEnabled);
+    __EAPI virtual ~EGLRenderer ();
+
+    __EAPI virtual void Initialize () override;
+    __EAPI virtual void Deinitialize () override;
+
+    __EAPI virtual std::shared_ptr<IRenderer> SetResolution (unsigned int width, unsigned int height) override;
+
+    __EAPI virtual void RenderFrame () override;
+
+    __EAPI virtual void BindDefaultFramebuffer () override;
+
+    // framebuffer holding rendered frames
+    __EAPI std::shared_ptr<IFramebuffer> GetOffscreenFramebuffer () const;
+
+private:
+
+    EGLDisplay GetDisplay () const;
+    EGLContext CreateContext (EGLConfig config) const;
+
+    // EGL context
+    EGLDisplay m_display;
+    EGLContext m_context;
+    EGLSurface m_surface;
+
+    // target of stage drawing to screen
+    std::shared_ptr<IFramebuffer> m_offscreenFramebuffer;
+
+};
+
+} // namespace cilantro
+
+#endif
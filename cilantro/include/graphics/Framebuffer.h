@@ -9,6 +9,7 @@ class __CEAPI Framebuffer : public IFramebuffer
 {
 public:
     __EAPI Framebuffer (unsigned int bufferWidth, unsigned int bufferHeight, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayLayerCount, bool depthStencilRenderbufferEnabled);
+    __EAPI Framebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled);
     __EAPI virtual ~Framebuffer () {};
 
     ///////////////////////////////////////////////////////////////////////////
@@ -20,21 +21,23 @@ public:
     __EAPI virtual unsigned int GetRGBTextureCount () const override final;
     __EAPI virtual unsigned int GetRGBATextureCount () const override final;
     __EAPI virtual unsigned int GetDepthArrayLayerCount () const override final;
+    __EAPI virtual const std::vector<EFramebufferTextureFormat>& GetColorTextureFormats () const override final;
 
     __EAPI virtual bool IsDepthStencilRenderbufferEnabled () const override final;
     __EAPI virtual bool IsDepthTextureArrayEnabled () const override final;
+    __EAPI virtual bool IsDepthStencilTextureEnabled () const override final;
 
     __EAPI void SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight) override;
 
     ///////////////////////////////////////////////////////////////////////////
 
 protected:
-    unsigned int    m_rgbTextureCount;
-    unsigned int    m_rgbaTextureCount;
+    std::vector<EFramebufferTextureFormat> m_colorTextureFormats;
     unsigned int    m_depthBufferArrayLayerCount;
     unsigned int    m_bufferWidth;
     unsigned int    m_bufferHeight;
     bool            m_depthStencilRenderbufferEnabled;
+    bool            m_depthStencilTextureEnabled;
 };
 
 } // namespace cilantro
\ No newline at end of file
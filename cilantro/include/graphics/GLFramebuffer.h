@@ -15,12 +15,16 @@ struct GLBuffers
     GLuint colorAttachments[CILANTRO_MAX_FRAMEBUFFER_TEXTURES];
     GLuint colorNone;
     GLuint depthTextureArray;
+    GLuint depthStencilTexture;
+    GLuint depthStencilCopyTexture;
+    GLuint depthStencilCopyFBO;
 };
 
 class __CEAPI GLFramebuffer : public Framebuffer
 {
 public:
     __EAPI GLFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayLayerCount, bool depthStencilRenderbufferEnabled);
+    __EAPI GLFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled);
     __EAPI virtual ~GLFramebuffer () {};
 
     ///////////////////////////////////////////////////////////////////////////
@@ -33,10 +37,12 @@ public:
     __EAPI virtual void BindFramebufferDepthTextureArrayAsColor (unsigned int index) const override;
     __EAPI virtual void BindFramebufferDepthTextureArrayAsDepth () const override;
     __EAPI virtual void BindFramebufferRenderbuffer () const override;
+    __EAPI virtual void BindFramebufferDepthStencilTextureAsColor (unsigned int index) const override;
+    __EAPI virtual void BindFramebufferDepthStencilTextureAsDepthStencil () const override;
 
     __EAPI virtual void UnbindFramebuffer () const override;    
 
-    __EAPI virtual void BlitFramebuffer () const override {};
+    __EAPI virtual void BlitFramebuffer () const override;
 
     __EAPI virtual void SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight) override;
 
@@ -47,9 +53,16 @@ public:
     __EAPI GLuint virtual GetFramebufferGLId () const;
 
 protected:
+    // GL internal format, pixel format and type of color texture
+    static void GetGLTextureFormat (EFramebufferTextureFormat format, GLenum& internalFormat, GLenum& pixelFormat, GLenum& type);
+
 
     GLBuffers m_glBuffers;
 
+    // depth and stencil texture is copied after drawing and the copy is sampled,
+    // so that the texture can stay attached for stencil test while depth is read
+    bool m_depthStencilCopyEnabled;
+
 };
 
 } // namespace cilantro
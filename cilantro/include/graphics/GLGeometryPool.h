@@ -0,0 +1,80 @@
+#ifndef _GLGEOMETRYPOOL_H_
+#define _GLGEOMETRYPOOL_H_
+
+#include "cilantroengine.h"
+#include "glad/gl.h"
+#include <map>
+
+namespace cilantro {
+
+// interleaved vertex layout of pooled geometry (attribute locations as in EGlVBOType)
+struct SGlVertex
+{
+    GLfloat position[3];
+    GLfloat normal[3];
+    GLfloat uv[2];
+    GLfloat tangent[3];
+    GLfloat bitangent[3];
+    GLuint boneIndices[CILANTRO_MAX_BONE_INFLUENCES];
+    GLfloat boneWeights[CILANTRO_MAX_BONE_INFLUENCES];
+};
+
+// range of vertices and indices suballocated from the pool
+struct SGlGeometryAllocation
+{
+    GLint baseVertex;
+    GLuint firstIndex;
+    GLuint vertexCount;
+    GLuint indexCount;
+};
+
+// (offset, count) of free ranges in pool buffers
+typedef std::map<size_t, size_t> TGeometryPoolFreeRanges;
+
+// Shared storage for mesh geometry
+// All meshes are suballocated from one interleaved vertex buffer and one index buffer,
+// which share a single Vertex Array Object. Buffers grow (by doubling) when exhausted.
+class __CEAPI GLGeometryPool
+{
+public:
+    __EAPI GLGeometryPool (size_t vertexCapacity, size_t indexCapacity);
+    __EAPI virtual ~GLGeometryPool ();
+
+    __EAPI void Initialize ();
+    __EAPI void Deinitialize ();
+
+    // reserve and release space for a mesh
+    __EAPI SGlGeometryAllocation Allocate (size_t vertexCount, size_t indexCount);
+    __EAPI void Free (const SGlGeometryAllocation& allocation);
+
+    // load mesh data to reserved space (indices are relative to allocation's base vertex)
+    __EAPI void Load (const SGlGeometryAllocation& allocation, const SGlVertex* vertices, const GLuint* indices);
+
+    // bind shared Vertex Array Object
+    __EAPI void Bind () const;
+    __EAPI void Unbind () const;
+
+    __EAPI GLuint GetVertexArrayGLId () const;
+
+private:
+    void InitializeVertexArray ();
+    void GrowBuffer (GLuint& buffer, size_t& capacity, size_t elementSize, size_t requiredCount, TGeometryPoolFreeRanges& freeRanges);
+
+    static bool AllocateRange (TGeometryPoolFreeRanges& freeRanges, size_t count, size_t& offset);
+    static void FreeRange (TGeometryPoolFreeRanges& freeRanges, size_t offset, size_t count);
+
+private:
+    GLuint m_VAO;
+    GLuint m_VBO;
+    GLuint m_EBO;
+
+    size_t m_vertexCapacity;
+    size_t m_indexCapacity;
+
+    TGeometryPoolFreeRanges m_freeVertexRanges;
+    TGeometryPoolFreeRanges m_freeIndexRanges;
+};
+
+} // namespace cilantro
+
+#endif
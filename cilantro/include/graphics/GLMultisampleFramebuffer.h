@@ -11,6 +11,7 @@ class __CEAPI GLMultisampleFramebuffer : public GLFramebuffer
 {
 public:
     __EAPI GLMultisampleFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayLayerCount, bool hasDepthStencilRB);
+    __EAPI GLMultisampleFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled);
     __EAPI virtual ~GLMultisampleFramebuffer () {};
 
     ///////////////////////////////////////////////////////////////////////////
@@ -19,6 +20,7 @@ public:
     __EAPI virtual void Deinitialize () override;
 
     __EAPI virtual void BindFramebuffer () const override;
+    __EAPI virtual void BindFramebufferDepthStencilTextureAsDepthStencil () const override;
     __EAPI virtual void BlitFramebuffer () const override;
 
     __EAPI virtual void SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight) override;
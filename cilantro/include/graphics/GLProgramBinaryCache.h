@@ -0,0 +1,53 @@
+#ifndef _GLPROGRAMBINARYCACHE_H_
+#define _GLPROGRAMBINARYCACHE_H_
+
+#include "cilantroengine.h"
+#include "glad/gl.h"
+#include <cstdint>
+#include <string>
+
+namespace cilantro {
+
+// On-disk cache of linked shader program binaries (glGetProgramBinary)
+// Entries are keyed by a hash of preprocessed sources of linked shaders, their static parameters
+// and the driver (vendor, renderer, GL version), so that any change leads to a cache miss
+// Binaries rejected by the driver are treated as a miss and the program is compiled and linked again
+class __CEAPI GLProgramBinaryCache
+{
+public:
+    __EAPI GLProgramBinaryCache (const std::string& directory);
+    __EAPI virtual ~GLProgramBinaryCache ();
+
+    // query driver support, must be called with current GL context
+    __EAPI void Initialize ();
+
+    // false if driver supports no program binary formats (cache is a no-op)
+    __EAPI bool IsEnabled () const;
+
+    // hash of driver identification, initial value of program keys
+    __EAPI uint64_t GetDriverKey () const;
+
+    // load cached binary of program, returns false if there is no valid entry
+    __EAPI bool Load (GLuint programId, uint64_t programKey) const;
+
+    // store binary of linked program (program must be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    __EAPI void Store (GLuint programId, uint64_t programKey) const;
+
+    // FNV-1a hash of data, chained with previous hash value
+    __EAPI static uint64_t Hash (const void* data, size_t size, uint64_t hash);
+    __EAPI static uint64_t Hash (const std::string& data, uint64_t hash);
+
+private:
+    // path of cache entry
+    std::string GetEntryPath (uint64_t programKey) const;
+
+private:
+    std::string m_directory;
+
+    bool m_isEnabled;
+    uint64_t m_driverKey;
+};
+
+} // namespace cilantro
+
+#endif
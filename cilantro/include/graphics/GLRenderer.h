@@ -3,46 +3,83 @@
 #include "cilantroengine.h"
 #include "glad/gl.h"
 #include "graphics/Renderer.h"
+#include "graphics/GLRingBuffer.h"
+#include "graphics/GLGeometryPool.h"
+#include "graphics/GLProgramBinaryCache.h"
+#include "graphics/RenderQueue.h"
+#include "graphics/ShadowAtlas.h"
 #include "math/AABB.h"
+#include <vector>
+#include <unordered_set>
 
 namespace cilantro {
 
 class GameScene;
+class Mesh;
 class MeshObject;
+class Material;
 class Camera;
+class GLShaderProgram;
+class Texture;
+class InstancedMeshObject;
 
 enum EGlVBOType { VBO_VERTICES = 0, VBO_NORMALS, VBO_UVS, VBO_TANGENTS, VBO_BITANGENTS, VBO_BONES, VBO_BONEWEIGHTS };
-enum EGlUBOType { UBO_MATRICES = 0, UBO_POINTLIGHTS, UBO_DIRECTIONALLIGHTS, UBO_SPOTLIGHTS, UBO_DIRECTIONALLIGHTVIEWMATRICES, UBO_SPOTLIGHTVIEWMATRICES, UBO_POINTLIGHTVIEWMATRICES, UBO_BONETRANSFORMATIONS };
-enum EGlSSBOType { SSBO_VERTICES = 0, SSBO_BONEINDICES, SSBO_BONEWEIGHTS, SSBO_AABB };
+enum EGlUBOType { UBO_MATRICES = 0, UBO_POINTLIGHTS, UBO_DIRECTIONALLIGHTS, UBO_SPOTLIGHTS, UBO_DIRECTIONALLIGHTVIEWMATRICES, UBO_SPOTLIGHTVIEWMATRICES, UBO_POINTLIGHTVIEWMATRICES, UBO_BONETRANSFORMATIONS, UBO_MATERIALS };
+enum EGlSSBOType { SSBO_VERTICES = 0, SSBO_BONEINDICES, SSBO_BONEWEIGHTS, SSBO_AABB, SSBO_OBJECTTRANSFORMS, SSBO_CULLOBJECTS, SSBO_DRAWCOMMANDS, SSBO_INSTANCETRANSFORMS, SSBO_POINTLIGHTS, SSBO_SPOTLIGHTS, SSBO_LIGHTCLUSTERS, SSBO_LIGHTINDICES };
+enum EGlACBType { ACB_DRAWCOUNT = 0 };
+enum EGlLightVolumeType { LIGHTVOLUME_NONE = 0, LIGHTVOLUME_POINT, LIGHTVOLUME_SPOT };
 
 struct SGlGeometryBuffers;
+struct SGlMeshGeometryBuffers;
 struct SGlMaterialTextureUnits;
+struct SGlTexture;
 
 typedef std::unordered_map <handle_t, SGlGeometryBuffers*> TObjectGeometryBufferMap;
+typedef std::unordered_map <handle_t, SGlMeshGeometryBuffers*> TMeshGeometryBufferMap;
 typedef std::unordered_map <handle_t, SGlMaterialTextureUnits*> TMaterialTextureUnitsMap;
+typedef std::unordered_map <const Texture*, SGlTexture*> TTextureMap;
 typedef std::unordered_map <handle_t, size_t> TLightHandleIdxMap;
+typedef std::unordered_map <handle_t, size_t> TMaterialHandleIdxMap;
+
+struct SGlMeshGeometryBuffers
+{
+    // number of scene objects drawing this mesh
+    size_t referenceCount;
+    // version of mesh the buffers were loaded from
+    size_t meshVersion;
+    // range in shared geometry pool
+    SGlGeometryAllocation geometryAllocation;
+    // AABB compute shader input (vertex positions, bone indices, bone weights) and result
+    GLuint vertexPositionsSSBO;
+    GLuint boneIndicesSSBO;
+    GLuint boneWeightsSSBO;
+    GLuint aabbSSBO;
+};
 
 struct SGlGeometryBuffers
 {
     // number of vertices
     size_t indexCount;
+    // geometry of object's mesh (scene objects only, shared by all objects drawing the same mesh)
+    handle_t meshHandle;
+    SGlMeshGeometryBuffers* meshGeometry;
     // Vertex Buffer Objects (vertices, normals, uvs, tangents, bitangents, bone indices, bone weights)
     GLuint VBO[CILANTRO_VBO_COUNT];
     // Element Buffer Object (face indices)
     GLuint EBO;
     // Vertex Array Object
     GLuint VAO;
-    // Bone transformation buffers
-    GLuint vertexPositionsSSBO;
-    GLuint boneTransformationsUBO;
-    GLuint boneIndicesSSBO;
-    GLuint boneWeightsSSBO;
-    GLuint aabbSSBO;
+    // Bone transformation palette (offset in bone transformations ring buffer and frame it was loaded in)
+    GLintptr boneTransformationsOffset;
+    size_t boneTransformationsFrame;
+    // Per-instance transformations (instanced objects only) and version of instances they were loaded from
+    GLuint instanceTransformsSSBO;
+    size_t instanceTransformsVersion;
 };
 
 struct SGlUniformBuffers
 {
-    // Uniform Buffer Objects (view & projection matrices, point lights, directional lights, spot lights, directional light view transforms, spot light view transforms, point light view transforms, bone transformations)
+    // Uniform Buffer Objects (view & projection matrices, point lights, directional lights, spot lights, directional light view transforms, spot light view transforms, point light view transforms, identity bone transformations, material properties)
     GLuint UBO[CILANTRO_GLOBAL_UBO_COUNT];
 };
 
@@ -52,24 +89,49 @@ struct SGlUniformMatrixBuffer
     GLfloat viewMatrix[16];
     // projection matrix
     GLfloat projectionMatrix[16];
+    // inverse of view-projection matrix (reconstruction of positions from depth)
+    GLfloat inverseViewProjectionMatrix[16];
 };
 
 struct SGlUniformLightViewMatrixBuffer
 {
-    // directional light view matrices
-    GLfloat directionalLightView[16 * CILANTRO_MAX_DIRECTIONAL_LIGHTS];
+    // directional light view matrices (one per shadow cascade)
+    GLfloat directionalLightView[16 * CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS];
     // spot light view matrices
     GLfloat spotLightView[16 * CILANTRO_MAX_SPOT_LIGHTS];
     // point light view matrices (cube maps)
     GLfloat pointLightView[16 * 6 * CILANTRO_MAX_POINT_LIGHTS];
+    // shadow atlas tiles of lights (xy - offset, z - size, in texture coordinates, w - 1 if tile is redrawn in current frame)
+    GLfloat directionalLightTile[4 * CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS];
+    GLfloat spotLightTile[4 * CILANTRO_MAX_SPOT_LIGHTS];
+    GLfloat pointLightTile[4 * 6 * CILANTRO_MAX_POINT_LIGHTS];
+    // view depth of far end of each directional light cascade (unused cascades repeat the last one)
+    GLfloat directionalLightCascadeSplits[CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS];
+    // plane of camera view depth (xyz - normal, w - offset)
+    GLfloat cascadeDepthPlane[4];
+};
+
+static_assert (CILANTRO_MAX_SHADOW_CASCADES == 4, "Cascade splits of directional light are loaded to shaders as vec4");
+
+struct SGlTexture
+{
+    // texture resource loaded to texture object
+    const Texture* resource;
+    // number of material texture units referencing the texture
+    size_t referenceCount;
+    // texture object and dimensions of its (immutable) storage
+    GLuint texture;
+    GLsizei width;
+    GLsizei height;
+    GLenum internalFormat;
 };
 
 struct SGlMaterialTextureUnits
 {
     // how many units in use 
     unsigned int unitsCount;
-    // using 16 texture units, as per minimum defined in OpenGL 3.x
-    GLuint textureUnits[CILANTRO_MAX_TEXTURE_UNITS];
+    // using 16 texture units, as per minimum defined in OpenGL 3.x (textures are shared between materials)
+    SGlTexture* textureUnits[CILANTRO_MAX_TEXTURE_UNITS];
 };
 
 struct SGlPointLightStruct
@@ -80,6 +142,7 @@ struct SGlPointLightStruct
     GLfloat attenuationConst;
     GLfloat attenuationLinear;
     GLfloat attenuationQuadratic;
+    GLfloat pad2[2];
 };
 
 struct SGlDirectionalLightStruct
@@ -110,8 +173,8 @@ struct SGlUniformPointLightBuffer
     GLuint pointLightCount;
     // pad to std140 specification
     GLint pad[3];
-    // array of active point lights
-    SGlPointLightStruct pointLights[CILANTRO_MAX_POINT_LIGHTS];
+    // array of active point lights (limited to CILANTRO_MAX_POINT_LIGHTS in uniform buffer only)
+    std::vector<SGlPointLightStruct> pointLights;
 };
 
 struct SGlUniformDirectionalLightBuffer
@@ -130,8 +193,76 @@ struct SGlUniformSpotLightBuffer
     GLuint spotLightCount;
     // pad to std140 specification
     GLint pad[3];
-    // array of active point lights
-    SGlSpotLightStruct spotLights[CILANTRO_MAX_SPOT_LIGHTS];
+    // array of active spot lights (limited to CILANTRO_MAX_SPOT_LIGHTS in uniform buffer only)
+    std::vector<SGlSpotLightStruct> spotLights;
+};
+
+struct SGlLightClustersHeader
+{
+    // view space depth range of clusters and scale converting log (depth / nearPlane) to depth slice
+    GLfloat nearPlane;
+    GLfloat farPlane;
+    GLfloat sliceScale;
+    // pad to std430 alignment of cluster array
+    GLfloat pad;
+};
+
+struct SGlLightCluster
+{
+    // ranges in light index list of point and spot lights overlapping the cluster
+    GLuint pointLightOffset;
+    GLuint pointLightCount;
+    GLuint spotLightOffset;
+    GLuint spotLightCount;
+};
+
+struct SGlLightClusterRange
+{
+    // first and last cluster overlapped by light's bounding sphere (x, y - screen tile, z - depth slice)
+    GLuint minCluster[3];
+    GLuint maxCluster[3];
+    // false if bounding sphere is outside of view frustum
+    bool isVisible;
+};
+
+struct SGlObjectTransform
+{
+    // model matrix (column-major)
+    GLfloat modelMatrix[16];
+    // normal matrix (column-major, std430 mat3 columns are padded to vec4)
+    GLfloat normalMatrix[12];
+    // lights of drawn type the object casts shadows for (bit per light, shadow map passes only)
+    GLuint shadowCasterMask;
+    GLuint padding[3];
+};
+
+struct SGlShadowTile
+{
+    // region of shadow map atlas
+    SShadowAtlasTile region;
+    // contents are out of date, but light did not affect the view when the tile was to be redrawn
+    bool isPending;
+};
+
+struct SGlDrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+struct SGlCullObject
+{
+    // model space bounds (w unused)
+    GLfloat center[4];
+    GLfloat extents[4];
+    // draw range, base instance is index of object's transforms
+    GLuint count;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
 };
 
 struct SGlEncodedAABB {
@@ -141,6 +272,15 @@ struct SGlEncodedAABB {
     GLuint pad2;
 };
 
+struct SGlRenderStageTimer
+{
+    // elapsed time queries of last buffered frames
+    GLuint queries[CILANTRO_BUFFERED_FRAMES];
+    bool isIssued[CILANTRO_BUFFERED_FRAMES];
+};
+
+typedef std::unordered_map<handle_t, SGlRenderStageTimer> TRenderStageTimerMap;
+
 class __CEAPI GLRenderer : public Renderer
 {
 public:
@@ -159,7 +299,14 @@ public:
     __EAPI virtual void Draw (std::shared_ptr<MeshObject> meshObject) override;
     __EAPI virtual void DrawSurface () override;
     __EAPI virtual void DrawSceneGeometryBuffers (std::shared_ptr<IShaderProgram> shader) override;
+    __EAPI virtual void DrawShadowCasters (ELightType lightType, std::shared_ptr<IShaderProgram> shader) override;
     __EAPI virtual void DrawAABBGeometryBuffers (std::shared_ptr<IShaderProgram> shader) override;
+    __EAPI virtual void DrawLightVolumes (std::shared_ptr<IShaderProgram> shader) override;
+
+    __EAPI virtual void BeginDrawBatch () override;
+    __EAPI virtual void EndDrawBatch () override;
+
+    __EAPI virtual bool IsGPUCulling () const override;
     
     __EAPI virtual void Update (std::shared_ptr<MeshObject> meshObject) override;
     __EAPI virtual void UpdateAABBBuffers (std::shared_ptr<MeshObject> meshObject) override;
@@ -174,12 +321,14 @@ public:
     
     __EAPI virtual void UpdateCameraBuffers (std::shared_ptr<Camera> camera) override;
     __EAPI virtual void UpdateLightViewBuffers () override;
+    __EAPI virtual bool IsShadowMapStale (ELightType lightType) const override;
     
     __EAPI virtual size_t GetPointLightCount () const override;
     __EAPI virtual size_t GetDirectionalLightCount () const override;
     __EAPI virtual size_t GetSpotLightCount () const override;
 
     __EAPI virtual std::shared_ptr<IFramebuffer> CreateFramebuffer (unsigned int width, unsigned int height, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayTextureCount, bool depthStencilRenderbufferEnabled, bool multisampleEnabled) override;
+    __EAPI virtual std::shared_ptr<IFramebuffer> CreateFramebuffer (unsigned int width, unsigned int height, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled, bool multisampleEnabled) override;
     __EAPI virtual void BindDefaultFramebuffer () override;
     __EAPI virtual void BindDefaultDepthBuffer () override;
     __EAPI virtual void BindDefaultStencilBuffer () override;
@@ -194,6 +343,7 @@ public:
     __EAPI virtual void SetFaceCullingEnabled (bool value) override;
     __EAPI virtual void SetFaceCullingMode (EFaceCullingFace face, EFaceCullingDirection direction) override;
     __EAPI virtual void SetMultisamplingEnabled (bool value) override;
+    __EAPI virtual void SetClipDistancesEnabled (unsigned int count) override;
     
     __EAPI virtual void SetStencilTestEnabled (bool value) override;
     __EAPI virtual void SetStencilTestFunction (EStencilTestFunction testFunction, int testValue) override;
@@ -201,8 +351,19 @@ public:
 
     ///////////////////////////////////////////////////////////////////////////
 
+protected:
+    // GPU time and render scale of frame completed since last call (CPU render time if timer queries are not supported)
+    virtual bool GetMeasuredFrameTime (float& frameTime, float& renderScale) override;
+
+    // elapsed time query and debug group around render stage
+    virtual void BeginRenderStage (handle_t renderStageHandle, const std::string& renderStageName) override;
+    virtual void EndRenderStage (handle_t renderStageHandle) override;
+
 private:
     void InitializeShaderLibrary ();
+
+    void InitializeFrameTimerQueries ();
+    void DeinitializeFrameTimerQueries ();
     
     void InitializeMatrixUniformBuffers ();
     void LoadMatrixUniformBuffers (std::shared_ptr<Camera> camera);
@@ -212,27 +373,126 @@ private:
     void LoadLightViewMatrixUniformBuffers ();
     void DeinitializeLightViewMatrixUniformBuffers ();
 
+    void CollectShadowCasterBoundsRecursive (handle_t objectHandle);
+    bool IsLightInView (const GLfloat* position, float radius) const;
+    unsigned int CalculateShadowTileSize (const Matrix4f& view, const Matrix4f& projection, float nearPlane, float farPlane, const GLfloat* position, float radius) const;
+    bool UpdateShadowTile (SGlShadowTile& tile, unsigned int tileSize, const Matrix4f& lightViewProjection, bool isVisible, GLfloat* bufferMatrix, GLfloat* bufferTile);
+    void CullShadowCasters (size_t directionalLightCount, size_t spotLightCount, size_t pointLightCount);
+    void ClearShadowTiles (const GLfloat* bufferTiles, size_t tileCount);
+    void RepackShadowAtlas ();
+
     void InitializeObjectBuffers ();
     void DeinitializeObjectBuffers ();
 
+    SGlMeshGeometryBuffers* AcquireMeshGeometryBuffers (std::shared_ptr<Mesh> mesh);
+    void LoadMeshGeometryBuffers (std::shared_ptr<Mesh> mesh, SGlMeshGeometryBuffers* buffers);
+    void ReleaseMeshGeometryBuffers (handle_t meshHandle);
+
     void InitializeQuadGeometryBuffer ();
     void DeinitializeQuadGeometryBuffer ();
+
+    void InitializeLightVolumeGeometryBuffers ();
+    void LoadLightVolumeGeometryBuffer (SGlGeometryBuffers* buffer, const std::vector<float>& vertices, const std::vector<GLuint>& indices);
+    void DeinitializeLightVolumeGeometryBuffers ();
+    void RenderLightVolume (std::shared_ptr<IShaderProgram> shader, EGlLightVolumeType type, size_t lightId, const Matrix4f& model, SGlGeometryBuffers* volume, const float* ndcMin, const float* ndcMax);
     
     void InitializeLightUniformBuffers ();
     void DeinitializeLightUniformBuffers ();
     void UpdateLightBufferRecursive (handle_t objectHandle);
+    void LoadLightStorageBuffer (GLuint buffer, GLsizeiptr& bufferSize, GLuint lightCount, const void* lights, size_t lightSize, size_t lightId);
+
+    void InitializeLightClusterBuffers ();
+    void LoadLightClusterBuffers (std::shared_ptr<Camera> camera);
+    void DeinitializeLightClusterBuffers ();
+    SGlLightClusterRange CalculateLightClusterRange (const Matrix4f& view, const Matrix4f& projection, const GLfloat* position, float radius) const;
+    void CalculateViewDepthRange (std::shared_ptr<Camera> camera, float& nearPlane, float& farPlane) const;
+    bool CalculateLightScreenBounds (const Matrix4f& view, const Matrix4f& projection, float nearPlane, float farPlane, const GLfloat* position, float radius, float* ndcMin, float* ndcMax) const;
+
+    void InitializeBoneTransformationBuffers ();
+    void LoadBoneTransformationBuffer (std::shared_ptr<MeshObject> meshObject, SGlGeometryBuffers* buffer, bool reuseFrameAllocation);
+    void DeinitializeBoneTransformationBuffers ();
+
+    void InitializeMaterialUniformBuffers ();
+    void LoadMaterialUniformBuffer (std::shared_ptr<Material> material, std::shared_ptr<GLShaderProgram> shaderProgram);
+    void DeinitializeMaterialUniformBuffers ();
+
+    SGlTexture* AcquireTexture (std::shared_ptr<Texture> texture);
+    void LoadTexture (std::shared_ptr<Texture> texture, SGlTexture* buffer);
+    void ReleaseTexture (SGlTexture* buffer);
+    void DeinitializeTextures ();
+
+    std::shared_ptr<GLShaderProgram> UseMaterial (std::shared_ptr<Material> material);
+    void LoadObjectTransform (SGlObjectTransform& transform, std::shared_ptr<MeshObject> meshObject);
+    void LoadObjectTransform (SGlObjectTransform& transform, const Matrix4f& modelMatrix);
+    void LoadInstanceTransformBuffer (std::shared_ptr<InstancedMeshObject> instancedMeshObject, SGlGeometryBuffers* buffer);
 
     void RenderGeometryBuffer (SGlGeometryBuffers* buffer, GLuint type); 
+    void RenderMeshObject (std::shared_ptr<IShaderProgram> shader, std::shared_ptr<MeshObject> meshObject, bool loadNormalMatrix);
+    void RenderMeshObjectsIndirect (std::shared_ptr<IShaderProgram> shader, const std::vector<handle_t>& meshObjects, bool isCulled);
+    void RenderMeshObjectsIndirect (std::shared_ptr<IShaderProgram> shader, const handle_t* meshObjects, size_t meshObjectCount, bool isCulled);
+    void RenderMeshObjects (std::shared_ptr<IShaderProgram> shader, const std::vector<handle_t>& meshObjects);
+    GLuint GetShadowCasterMask (handle_t objectHandle) const;
+    void CullDrawCommands (GLsizei drawCount, bool compactDrawCommands);
 
 private:
-    // buffers with geometry data to be passed to GPU (key is object handle)
+    // per-object buffers (key is object handle) and geometry shared by objects drawing the same mesh (key is mesh handle)
     TObjectGeometryBufferMap m_sceneGeometryBuffers;
+    TMeshGeometryBufferMap m_meshGeometryBuffers;
     TObjectGeometryBufferMap m_aabbGeometryBuffers;
     SGlGeometryBuffers* m_surfaceGeometryBuffer;
 
+    // unit sphere and unit cone (apex at origin, base at z = 1) scaled to range of point and spot lights
+    SGlGeometryBuffers* m_sphereGeometryBuffer;
+    SGlGeometryBuffers* m_coneGeometryBuffer;
+
+    // current viewport (x, y, width, height)
+    GLint m_viewport[4];
+
     // Buffers for uniforms shared by entire scene
     SGlUniformBuffers* m_uniformBuffers;
 
+    // timestamp queries at start and end of last buffered frames (results are read back when next frame uses the same pair)
+    bool m_isFrameTimerEnabled;
+    GLuint m_frameTimerQueries[CILANTRO_BUFFERED_FRAMES][2];
+    float m_frameTimerRenderScales[CILANTRO_BUFFERED_FRAMES];
+    unsigned int m_frameTimerIndex;
+    float m_gpuFrameTime;
+    float m_gpuFrameRenderScale;
+    bool m_isGpuFrameTimeNew;
+
+    // elapsed time queries of render stages (key is stage handle, queries use same slot as frame timer)
+    TRenderStageTimerMap m_renderStageTimers;
+    bool m_isDebugGroupEnabled;
+
+    // on-disk cache of linked shader programs
+    std::shared_ptr<GLProgramBinaryCache> m_programBinaryCache;
+
+    // streaming buffer for per-object bone transformation palettes
+    GLRingBuffer* m_boneTransformationsRingBuffer;
+
+    // shared storage for geometry of all scene objects
+    GLGeometryPool* m_geometryPool;
+
+    // streaming buffers for indirect draws (per-draw transforms and draw commands)
+    GLRingBuffer* m_objectTransformsRingBuffer;
+    GLRingBuffer* m_drawCommandsRingBuffer;
+
+    // draws collected between BeginDrawBatch and EndDrawBatch, submitted in sort key order
+    bool m_isDrawBatchActive;
+    RenderQueue m_renderQueue;
+    std::vector<SGlObjectTransform> m_drawObjectTransforms;
+    std::vector<SGlDrawElementsIndirectCommand> m_drawCommands;
+    std::vector<handle_t> m_unskinnedMeshObjects;
+
+    // single identity transformation bound for non-instanced draws
+    GLuint m_identityInstanceTransformBuffer;
+
+    // GPU culling: bounds of indirect draws and draw commands written by culling compute shader (with their count)
+    std::vector<SGlCullObject> m_cullObjects;
+    GLuint m_culledDrawCommandsBuffer;
+    GLsizeiptr m_culledDrawCommandsBufferSize;
+    GLuint m_drawCountBuffer;
+
     // data structures for uniforms
     SGlUniformMatrixBuffer* m_uniformMatrixBuffer;
     SGlUniformLightViewMatrixBuffer* m_uniformLightViewMatrixBuffer;
@@ -240,8 +500,17 @@ private:
     SGlUniformDirectionalLightBuffer* m_uniformDirectionalLightBuffer;
     SGlUniformSpotLightBuffer* m_uniformSpotLightBuffer;
 
-    // materials texture units (key is material handle)
+    // materials texture units (key is material handle) and texture objects they reference (key is texture resource)
     TMaterialTextureUnitsMap m_materialTextureUnits;
+    TTextureMap m_textures;
+
+    // maps material handle to index of its properties block in materials uniform buffer
+    // materials modified since their block was loaded are reloaded on next use
+    TMaterialHandleIdxMap m_materials;
+    std::unordered_set<handle_t> m_invalidatedMaterials;
+
+    // distance between material blocks (block size rounded up to uniform buffer offset alignment)
+    GLsizeiptr m_materialBlockStride;
 
     // maps gameobject handle to index in 
     // uniformPointLightBuffer
@@ -251,6 +520,47 @@ private:
     TLightHandleIdxMap m_directionalLights;
     TLightHandleIdxMap m_spotLights;
 
+    // bounding sphere radii of point and spot lights (indexed as light buffers)
+    std::vector<float> m_pointLightRadii;
+    std::vector<float> m_spotLightRadii;
+
+    // storage buffers for point and spot lights (GLSL 4.3+ only, grown as lights are added)
+    GLuint m_pointLightsBuffer;
+    GLsizeiptr m_pointLightsBufferSize;
+    GLuint m_spotLightsBuffer;
+    GLsizeiptr m_spotLightsBufferSize;
+
+    // light clusters (froxel grid of view frustum) and light index list referenced by clusters, rebuilt for active camera every frame
+    SGlLightClustersHeader m_lightClustersHeader;
+    std::vector<SGlLightCluster> m_lightClusters;
+    std::vector<SGlLightClusterRange> m_lightClusterRanges;
+    std::vector<GLuint> m_lightIndices;
+    GLuint m_lightClustersBuffer;
+    GLuint m_lightIndicesBuffer;
+    GLsizeiptr m_lightIndicesBufferSize;
+
+    // shadow map atlas and tiles of shadow casting lights (indexed as light view matrices, a tile per directional light cascade, 6 tiles per point light)
+    ShadowAtlas m_shadowAtlas;
+    std::vector<SGlShadowTile> m_directionalLightShadowTiles;
+    std::vector<SGlShadowTile> m_spotLightShadowTiles;
+    std::vector<SGlShadowTile> m_pointLightShadowTiles;
+    GLint m_shadowAtlasResolution;
+
+    // cached tiles are redrawn only when their light view changes or a moved shadow caster overlaps them
+    // (last known bounds of shadow casters and bounds they moved from or to since previous frame)
+    std::unordered_map<handle_t, AABB> m_shadowCasterBounds;
+    std::vector<AABB> m_changedShadowCasterBounds;
+    bool m_isShadowAtlasInvalid;
+    bool m_isShadowMapStale[3];
+
+    // meshes casting shadows into redrawn tiles (for each light type) with masks of lights they cast shadows for,
+    // masks of light type being drawn are loaded with object transformations
+    std::vector<handle_t> m_shadowCasters[3];
+    std::unordered_map<handle_t, GLuint> m_shadowCasterMasks[3];
+    const std::unordered_map<handle_t, GLuint>* m_drawnShadowCasterMasks;
+    std::vector<handle_t> m_queriedShadowCasters;
+    std::vector<handle_t> m_drawnMeshObjects;
+
 };
 
 } // namespace cilantro
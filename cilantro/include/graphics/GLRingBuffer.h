@@ -0,0 +1,72 @@
+#ifndef _GLRINGBUFFER_H_
+#define _GLRINGBUFFER_H_
+
+#include "cilantroengine.h"
+#include "glad/gl.h"
+#include <vector>
+
+namespace cilantro {
+
+// Streaming buffer for per-draw data (e.g. bone transformation palettes)
+// Buffer is split into regions, one per frame in flight, and each region is guarded by a fence,
+// so CPU never overwrites data which GPU has not consumed yet
+// With OpenGL 4.4 the buffer is persistently mapped and written directly,
+// otherwise data is loaded with glBufferSubData (buffer is never re-specified)
+class __CEAPI GLRingBuffer
+{
+public:
+    __EAPI GLRingBuffer (GLenum target, GLsizeiptr regionSize, unsigned int regionCount);
+    __EAPI virtual ~GLRingBuffer ();
+
+    __EAPI void Initialize ();
+    __EAPI void Deinitialize ();
+
+    // copy dataSize bytes to the buffer and return offset of the allocation
+    // reservedSize bytes are reserved, so that the allocation can be bound as a complete block
+    __EAPI GLintptr Allocate (const void* data, GLsizeiptr dataSize, GLsizeiptr reservedSize);
+
+    // make sure that next allocationCount allocations of total size bytes fit current region without wrapping
+    // (wraps now if needed), so that none of them overwrites another one before it is drawn
+    __EAPI void Reserve (GLsizeiptr size, unsigned int allocationCount);
+
+    // largest size of allocationCount allocations which can be reserved at once
+    __EAPI GLsizeiptr GetMaxReservedSize (unsigned int allocationCount) const;
+
+    // bind allocation to indexed binding point of buffer target
+    __EAPI void BindRange (GLuint index, GLintptr offset, GLsizeiptr size) const;
+
+    // fence current region and move to the next one (waits if GPU still reads from it)
+    __EAPI void NextFrame ();
+
+    // serial number of current frame (starts from 1, also advances when region is restarted within frame)
+    __EAPI size_t GetFrameSerial () const;
+
+    __EAPI GLuint GetBufferGLId () const;
+
+private:
+    void WaitForRegion (unsigned int region);
+
+    // wait until GPU consumed current region and start writing at its beginning
+    void RestartRegion ();
+
+private:
+    GLenum m_target;
+    GLuint m_buffer;
+
+    GLsizeiptr m_regionSize;
+    unsigned int m_regionCount;
+    std::vector<GLsync> m_regionFences;
+
+    unsigned int m_currentRegion;
+    GLsizeiptr m_currentOffset;
+    GLint m_offsetAlignment;
+
+    bool m_isPersistentlyMapped;
+    GLubyte* m_mappedData;
+
+    size_t m_frameSerial;
+};
+
+} // namespace cilantro
+
+#endif
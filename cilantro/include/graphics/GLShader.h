@@ -3,6 +3,7 @@
 #include "cilantroengine.h"
 #include "glad/gl.h"
 #include "graphics/Shader.h"
+#include <cstdint>
 #include <string>
 
 namespace cilantro {
@@ -15,6 +16,7 @@ public:
 
     ///////////////////////////////////////////////////////////////////////////
 
+    // compilation is deferred until a program using the shader is linked and not found in program binary cache
     virtual void Compile () override;
     virtual void SetDefaults () override;
 
@@ -22,11 +24,23 @@ public:
 
     GLuint GetShaderId () const;
 
+    // start compilation of current source if it was not compiled yet (status is not queried)
+    void CompileSource ();
+
+    // wait for compilation and exit with error log if it failed
+    void CheckCompileStatus ();
+
+    // hash of shader type, static parameters and preprocessed source chained with previous hash value
+    uint64_t GetSourceKey (uint64_t hash) const;
+
 private:
 
     // GL id of a shader
     GLuint m_glShaderId;
 
+    // current source was compiled
+    bool m_isCompiled;
+
 };
 
 } // namespace cilantro
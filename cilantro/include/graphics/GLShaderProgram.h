@@ -4,21 +4,72 @@
 #include "glad/gl.h"
 #include "graphics/ShaderProgram.h"
 #include "graphics/GLRenderer.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace cilantro {
 
 struct IShaderProgram;
+class GLShader;
+class GLProgramBinaryCache;
+class GLShaderProgram;
+
+enum class EGlProgramLinkState { UNLINKED, LINKING, LINKED };
+
+// uniforms loaded by renderer for every draw or frame, their handles are resolved when program is linked
+enum EGlUniformType { UNIFORM_MODEL = 0, UNIFORM_NORMAL, UNIFORM_SHADOWCASTERMASK, UNIFORM_EYEPOSITION, UNIFORM_SHADOWMAPENABLED, UNIFORM_LIGHTVOLUMETYPE, UNIFORM_LIGHTVOLUMEIDX, UNIFORM_FRUSTUMPLANES, UNIFORM_OBJECTCOUNT, UNIFORM_COMPACTDRAWCOMMANDS, UNIFORM_COUNT };
+
+// called after each successful link (bindings of samplers and blocks are reset by linking)
+typedef std::function<void (GLShaderProgram&)> TProgramLinkCallback;
+
+// active uniform reflected after linking
+struct SGlUniform
+{
+    size_t nameHash;
+    std::string name;
+    GLint location;
+    GLenum type;
+    GLint size;
+
+    // last value loaded to the uniform (raw bytes)
+    bool isValueSet;
+    std::vector<GLubyte> value;
+};
+
+// active uniform block reflected after linking
+struct SGlUniformBlock
+{
+    size_t nameHash;
+    std::string name;
+    GLuint index;
+    GLint dataSize;
+};
+
+// active member of uniform block reflected after linking
+struct SGlUniformBlockMember
+{
+    size_t nameHash;
+    std::string name;
+    GLuint blockIndex;
+    GLint offset;
+    GLenum type;
+};
 
 class __CEAPI GLShaderProgram : public ShaderProgram
 {
 public:
-    __EAPI GLShaderProgram ();
+    // programs with binary cache are loaded from it when their shaders did not change
+    __EAPI GLShaderProgram (std::shared_ptr<GLProgramBinaryCache> binaryCache = nullptr);
     __EAPI virtual ~GLShaderProgram () {};
 
     ///////////////////////////////////////////////////////////////////////////
 
     __EAPI virtual void AttachShader (const std::shared_ptr<IShader> shader) override;
     __EAPI virtual void Link () override;
+    __EAPI virtual void Prepare () override;
 
     __EAPI virtual bool HasUniform (const std::string& uniformName) const override;
     __EAPI virtual IShaderProgram& SetUniformInt (const std::string& uniformName, int uniformValue) override;
@@ -38,6 +89,34 @@ public:
 
     ///////////////////////////////////////////////////////////////////////////
 
+    // uniform handles are valid until program is linked again
+    // setters taking a handle skip loading when value is unchanged
+    __EAPI GLint GetUniformHandle (const std::string& uniformName) const;
+    // handle of renderer uniform (-1 if program does not use it, setters then do nothing)
+    __EAPI GLint GetUniformHandle (EGlUniformType uniform) const;
+    __EAPI IShaderProgram& SetUniformInt (GLint uniformHandle, int uniformValue);
+    __EAPI IShaderProgram& SetUniformUInt (GLint uniformHandle, unsigned int uniformValue);
+    __EAPI IShaderProgram& SetUniformFloat (GLint uniformHandle, float uniformValue);
+    __EAPI IShaderProgram& SetUniformFloatv (GLint uniformHandle, const float* uniformValue, size_t count);
+    __EAPI IShaderProgram& SetUniformVector2f (GLint uniformHandle, const Vector2f& uniformValue);
+    __EAPI IShaderProgram& SetUniformVector3f (GLint uniformHandle, const Vector3f& uniformValue);
+    __EAPI IShaderProgram& SetUniformVector4f (GLint uniformHandle, const Vector4f& uniformValue);
+    __EAPI IShaderProgram& SetUniformMatrix3f (GLint uniformHandle, const Matrix3f& uniformValue);
+    __EAPI IShaderProgram& SetUniformMatrix4f (GLint uniformHandle, const Matrix4f& uniformValue);
+    __EAPI IShaderProgram& SetUniformMatrix3fv (GLint uniformHandle, const float* uniformValue, size_t count);
+    __EAPI IShaderProgram& SetUniformMatrix4fv (GLint uniformHandle, const float* uniformValue, size_t count);
+
+    // FNV-1a hash of uniform (block) name
+    __EAPI static size_t GetNameHash (const std::string& name);
+
+    // attribute locations (applied before linking) and setup of linked program
+    __EAPI void BindAttribLocation (GLuint index, const std::string& attributeName);
+    __EAPI void SetLinkCallback (TProgramLinkCallback callback);
+
+    __EAPI EGlProgramLinkState GetLinkState () const;
+
+    ///////////////////////////////////////////////////////////////////////////
+
     // return GL ids
     GLuint GetProgramId () const;
     GLuint GetUniformLocationId (const std::string& uniformName) const;
@@ -46,9 +125,50 @@ public:
     void BindUniformBlock (const std::string& blockName, EGlUBOType bp);
     void BindShaderStorageBlock (const std::string& blockName, EGlSSBOType bp);
 
+    // layout of uniform block (-1 if block or member is not active)
+    GLint GetUniformBlockSize (const std::string& blockName) const;
+    GLint GetUniformBlockMemberOffset (const std::string& blockName, const std::string& memberName, GLenum& memberType) const;
+
+private:
+    // wait for pending link (starting it if needed), programs are linked lazily on first use
+    void EnsureLinked () const;
+    void FinishLink ();
+
+    // query active uniforms and uniform blocks
+    void ReflectUniforms ();
+
+    // find reflected uniform (-1 if not active)
+    GLint FindUniform (const std::string& uniformName) const;
+
+    // find reflected uniform block (nullptr if not active)
+    const SGlUniformBlock* FindUniformBlock (const std::string& blockName) const;
+
+    // store value in uniform's shadow copy, return false if value is unchanged
+    bool UpdateUniformValue (GLint uniformHandle, const void* value, size_t valueSize);
+
 private:
     // ID of a shader program
     GLuint m_glShaderProgramId;
+
+    // attached shaders, compiled on link if program is not found in binary cache
+    std::vector<std::shared_ptr<GLShader>> m_shaders;
+    std::shared_ptr<GLProgramBinaryCache> m_binaryCache;
+
+    std::vector<std::pair<GLuint, std::string>> m_attribLocations;
+    TProgramLinkCallback m_linkCallback;
+
+    // program is linked when it is first used or prepared
+    EGlProgramLinkState m_linkState;
+    bool m_isLoadedFromCache;
+    uint64_t m_programKey;
+
+    // reflected uniforms, uniform blocks and their members (sorted by name hash)
+    std::vector<SGlUniform> m_uniforms;
+    std::vector<SGlUniformBlock> m_uniformBlocks;
+    std::vector<SGlUniformBlockMember> m_uniformBlockMembers;
+
+    // handles of renderer uniforms (indexed by EGlUniformType)
+    std::array<GLint, UNIFORM_COUNT> m_rendererUniformHandles;
 };
 
 } // namespace cilantro
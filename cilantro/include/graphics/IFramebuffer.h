@@ -3,9 +3,13 @@
 #include "cilantroengine.h"
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace cilantro {
 
+// formats of color textures (half float for lit and post-processed images, normalized for compact g-buffer)
+enum class EFramebufferTextureFormat { FORMAT_RGB16F, FORMAT_RGBA16F, FORMAT_RG16, FORMAT_RGBA8 };
+
 struct IFramebuffer 
 {
     virtual ~IFramebuffer () {};
@@ -18,6 +22,8 @@ struct IFramebuffer
     virtual void BindFramebufferDepthTextureArrayAsColor (unsigned int index) const = 0;
     virtual void BindFramebufferDepthTextureArrayAsDepth () const = 0;
     virtual void BindFramebufferRenderbuffer () const = 0;
+    virtual void BindFramebufferDepthStencilTextureAsColor (unsigned int index) const = 0;
+    virtual void BindFramebufferDepthStencilTextureAsDepthStencil () const = 0;
     
     virtual void UnbindFramebuffer () const = 0;    
 
@@ -30,9 +36,11 @@ struct IFramebuffer
     virtual unsigned int GetRGBTextureCount () const = 0;
     virtual unsigned int GetRGBATextureCount () const = 0;
     virtual unsigned int GetDepthArrayLayerCount () const = 0;
+    virtual const std::vector<EFramebufferTextureFormat>& GetColorTextureFormats () const = 0;
 
     virtual bool IsDepthStencilRenderbufferEnabled () const = 0;
     virtual bool IsDepthTextureArrayEnabled () const = 0;
+    virtual bool IsDepthStencilTextureEnabled () const = 0;
 
     virtual void SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight) = 0;
 };
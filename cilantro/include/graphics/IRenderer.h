@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cilantroengine.h"
+#include "graphics/IFramebuffer.h"
 #include "resource/ResourceManager.h"
 #include <set>
 #include <vector>
@@ -29,6 +30,7 @@ enum class EStencilTestFunction { FUNCTION_NEVER, FUNCTION_LESS, FUNCTION_LEQUAL
 enum class EStencilTestOperation { OP_KEEP, OP_ZERO, OP_REPLACE, OP_INC, OP_INC_WRAP, OP_DEC, OP_DEC_WRAP, OP_INV };
 enum class EFaceCullingFace { FACE_FRONT, FACE_BACK };
 enum class EFaceCullingDirection { DIR_CW, DIR_CCW };
+enum class ELightType { LIGHT_DIRECTIONAL, LIGHT_SPOT, LIGHT_POINT };
 
 typedef ResourceManager<ShaderProgram> TShaderProgramManager;
 typedef ResourceManager<RenderStage> TRenderStageManager;
@@ -67,11 +69,23 @@ struct IRenderer
     // render current frame
     virtual void RenderFrame () = 0;
 
+    // visibility (view frustum culling against camera)
+    virtual void CullScene (std::shared_ptr<Camera> camera) = 0;
+    virtual const std::vector<handle_t>& GetVisibleObjects () const = 0;
+    virtual bool IsVisible (handle_t objectHandle) const = 0;
+
     // geometry
     virtual void Draw (std::shared_ptr<MeshObject> meshObject) = 0;
     virtual void DrawSurface () = 0;
     virtual void DrawSceneGeometryBuffers (std::shared_ptr<IShaderProgram> shader) = 0;
+    // draw meshes casting shadows into redrawn shadow map tiles of lights of given type (valid after UpdateLightViewBuffers)
+    virtual void DrawShadowCasters (ELightType lightType, std::shared_ptr<IShaderProgram> shader) = 0;
     virtual void DrawAABBGeometryBuffers (std::shared_ptr<IShaderProgram> shader) = 0;
+    virtual void DrawLightVolumes (std::shared_ptr<IShaderProgram> shader) = 0;
+
+    // collect draws of a stage and submit them sorted by state
+    virtual void BeginDrawBatch () = 0;
+    virtual void EndDrawBatch () = 0;
 
     virtual void Update (std::shared_ptr<MeshObject> meshObject) = 0;
     virtual void UpdateAABBBuffers (std::shared_ptr<MeshObject> meshObject) = 0;
@@ -86,6 +100,9 @@ struct IRenderer
     virtual void UpdateCameraBuffers (std::shared_ptr<Camera> camera) = 0;
     virtual void UpdateLightViewBuffers () = 0;
 
+    // true if shadow map tiles of any light of given type are redrawn in current frame (valid after UpdateLightViewBuffers)
+    virtual bool IsShadowMapStale (ELightType lightType) const = 0;
+
     // object counts
     virtual size_t GetPointLightCount () const = 0;
     virtual size_t GetDirectionalLightCount () const = 0;
@@ -95,8 +112,26 @@ struct IRenderer
     virtual bool IsDeferredRendering () const = 0;
     virtual bool IsShadowMapping () const = 0;
 
+    // frustum test of batched meshes on GPU instead of CPU
+    virtual void SetGPUCullingEnabled (bool value) = 0;
+    virtual bool IsGPUCulling () const = 0;
+
+    // deferred lighting of point and spot lights by drawing their bounding volumes instead of full-screen quad
+    virtual void SetLightVolumesEnabled (bool value) = 0;
+    virtual bool IsLightVolumes () const = 0;
+
+    // dynamic resolution: stages render into scaled part of their framebuffers, so that frame time stays at target (stage drawing to window upscales)
+    virtual void SetDynamicResolutionEnabled (bool value) = 0;
+    virtual bool IsDynamicResolution () const = 0;
+    virtual void SetTargetFrameTime (float frameTime) = 0;
+    virtual float GetRenderScale () const = 0;
+
+    // rolling average of GPU time spent in render stage (seconds, 0 if not measured)
+    virtual float GetRenderStageGPUTime (handle_t renderStageHandle) const = 0;
+
     // framebuffer control
     virtual std::shared_ptr<IFramebuffer> CreateFramebuffer (unsigned int width, unsigned int height, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayTextureCount, bool depthStencilRenderbufferEnabled, bool multisampleEnabled) = 0;
+    virtual std::shared_ptr<IFramebuffer> CreateFramebuffer (unsigned int width, unsigned int height, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled, bool multisampleEnabled) = 0;
     virtual void BindDefaultFramebuffer () = 0;
     virtual void BindDefaultDepthBuffer () = 0;
     virtual void BindDefaultStencilBuffer () = 0;
@@ -111,6 +146,7 @@ struct IRenderer
     virtual void SetFaceCullingEnabled (bool value) = 0;
     virtual void SetFaceCullingMode (EFaceCullingFace face, EFaceCullingDirection direction) = 0;
     virtual void SetMultisamplingEnabled (bool value) = 0;
+    virtual void SetClipDistancesEnabled (unsigned int count) = 0;
     
     virtual void SetStencilTestEnabled (bool value) = 0;
     virtual void SetStencilTestFunction (EStencilTestFunction testFunction, int testValue) = 0;
@@ -17,9 +17,10 @@ struct IShaderProgram
 {
     virtual ~IShaderProgram () {};
 
-    // linking
+    // linking (programs are linked on first use, Prepare starts compilation and linking ahead of it)
     virtual void AttachShader (const std::shared_ptr<IShader> shader) = 0;  
     virtual void Link () = 0;
+    virtual void Prepare () = 0;
 
     // uniform manipulation
     virtual bool HasUniform (const std::string& uniformName) const = 0;
@@ -0,0 +1,53 @@
+#ifndef _RENDERQUEUE_H_
+#define _RENDERQUEUE_H_
+
+#include "cilantroengine.h"
+#include <cstdint>
+#include <vector>
+
+namespace cilantro {
+
+// sort key layout (most significant field first)
+// | stencil (8) | shader program (8) | material (16) | geometry (8) | depth (24) |
+#define CILANTRO_RENDER_KEY_STENCIL_SHIFT   56
+#define CILANTRO_RENDER_KEY_PROGRAM_SHIFT   48
+#define CILANTRO_RENDER_KEY_MATERIAL_SHIFT  32
+#define CILANTRO_RENDER_KEY_GEOMETRY_SHIFT  24
+#define CILANTRO_RENDER_KEY_DEPTH_SHIFT     0
+
+struct SRenderQueueItem
+{
+    uint64_t key;
+    handle_t objectHandle;
+    handle_t materialHandle;
+};
+
+// Queue of draws collected during a render stage
+// Draws are sorted by 64-bit keys, so that draws sharing state end up adjacent
+// and draws within the same state are ordered front to back
+class __CEAPI RenderQueue
+{
+public:
+    __EAPI RenderQueue ();
+    __EAPI virtual ~RenderQueue ();
+
+    __EAPI void Clear ();
+    __EAPI void Push (uint64_t key, handle_t objectHandle, handle_t materialHandle);
+
+    // radix sort of queued draws (stable, ascending keys)
+    __EAPI void Sort ();
+
+    __EAPI const std::vector<SRenderQueueItem>& GetItems () const;
+
+    // pack key fields (values are truncated to field widths)
+    __EAPI static uint64_t MakeKey (unsigned int stencil, handle_t program, handle_t material, unsigned int geometry, float depth);
+    __EAPI static unsigned int GetGeometry (uint64_t key);
+
+private:
+    std::vector<SRenderQueueItem> m_items;
+    std::vector<SRenderQueueItem> m_sortBuffer;
+};
+
+} // namespace cilantro
+
+#endif
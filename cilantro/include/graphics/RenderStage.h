@@ -68,6 +68,7 @@ protected:
     bool m_isDepthTestEnabled;    
     bool m_isFaceCullingEnabled;
     bool m_isFramebufferEnabled;
+    bool m_isRenderScaleEnabled;
 
     bool m_isClearColorOnFrameEnabled;
     bool m_isClearDepthOnFrameEnabled;
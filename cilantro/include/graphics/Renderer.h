@@ -5,10 +5,14 @@
 #include "resource/ResourceManager.h"
 #include "graphics/IRenderer.h"
 #include "graphics/IRenderStage.h"
+#include "math/AABB.h"
+#include "math/Frustum.h"
+#include <array>
 #include <string>
 #include <vector>
 #include <set>
 #include <unordered_set>
+#include <unordered_map>
 #include <memory>
 
 namespace cilantro {
@@ -16,6 +20,19 @@ namespace cilantro {
 class GameScene;
 class GameObject;
 
+// render pipeline stage with its framebuffer links resolved (compiled from pipeline when it changes)
+struct SRenderGraphNode
+{
+    handle_t stageHandle;
+    std::shared_ptr<RenderStage> stage;
+    std::string stageName;
+    // stage linked by each EPipelineLink (nullptr if out of pipeline bounds), framebuffers are taken from them in frame
+    // as stages may recreate their framebuffers
+    std::array<RenderStage*, static_cast<size_t> (EPipelineLink::LINK_LAST) + 1> linkedStages;
+};
+
+typedef std::vector<SRenderGraphNode> TRenderGraph;
+
 class __CEAPI Renderer : public IRenderer, public std::enable_shared_from_this<Renderer>
 {
 public:
@@ -44,6 +61,10 @@ public:
     __EAPI virtual std::shared_ptr<IFramebuffer> GetPipelineFramebuffer (EPipelineLink link) override final;
 
     __EAPI virtual void RenderFrame () override;   
+
+    __EAPI virtual void CullScene (std::shared_ptr<Camera> camera) override;
+    __EAPI virtual const std::vector<handle_t>& GetVisibleObjects () const override final;
+    __EAPI virtual bool IsVisible (handle_t objectHandle) const override final;
     
     __EAPI virtual AABB CalculateAABB (std::shared_ptr<MeshObject> meshObject) override;
 
@@ -52,6 +73,19 @@ public:
     __EAPI virtual bool IsDeferredRendering () const override;
     __EAPI virtual bool IsShadowMapping () const override;
 
+    __EAPI virtual void SetGPUCullingEnabled (bool value) override;
+    __EAPI virtual bool IsGPUCulling () const override;
+
+    __EAPI virtual void SetLightVolumesEnabled (bool value) override;
+    __EAPI virtual bool IsLightVolumes () const override;
+
+    __EAPI virtual void SetDynamicResolutionEnabled (bool value) override;
+    __EAPI virtual bool IsDynamicResolution () const override;
+    __EAPI virtual void SetTargetFrameTime (float frameTime) override;
+    __EAPI virtual float GetRenderScale () const override final;
+
+    __EAPI virtual float GetRenderStageGPUTime (handle_t renderStageHandle) const override final;
+
     template <typename T, typename ...Params>
     std::shared_ptr<T> Create (const std::string& name, Params&&... params)
     requires (std::is_base_of_v<IRenderStage,T>);
@@ -60,6 +94,21 @@ public:
     std::shared_ptr<T> Create (const std::string& name, Params&&... params)
     requires (std::is_base_of_v<IShaderProgram,T>);        
 
+protected:
+    // frame time driving dynamic resolution and render scale the measured frame was rendered at
+    // (CPU render time of last frame, renderers measuring GPU time override this), false if there is no new measurement
+    virtual bool GetMeasuredFrameTime (float& frameTime, float& renderScale);
+
+    // adjust render scale so that frame time approaches target (frame time was measured at given render scale)
+    void UpdateRenderScale (float frameTime, float renderScale);
+
+    // called around each stage run by RenderFrame (renderers place GPU timers and debug markers here, name is kept by render graph)
+    virtual void BeginRenderStage (handle_t renderStageHandle, const std::string& renderStageName);
+    virtual void EndRenderStage (handle_t renderStageHandle);
+
+    // add measured GPU time of render stage to its rolling average
+    void UpdateRenderStageGPUTime (handle_t renderStageHandle, float time);
+
 protected:
     // game scene being rendered
     std::weak_ptr<GameScene> m_gameScene;
@@ -67,12 +116,23 @@ protected:
     // objects with invalidated transformation
     std::unordered_set<handle_t> m_invalidatedObjects;
 
+    // objects passing view frustum test in current frame (flags indexed by object handle)
+    std::vector<handle_t> m_visibleObjects;
+    std::vector<bool> m_isObjectVisible;
+
+    // frustum of camera used for culling in current frame
+    Frustum m_viewFrustum;
+
     // render pipeline
     size_t m_currentRenderStageIdx;
     std::shared_ptr<IRenderStage> m_currentRenderStage;
     std::shared_ptr<TRenderStageManager> m_renderStageManager;
     TRenderPipeline m_renderPipeline;
 
+    // pipeline compiled for RenderFrame, recompiled before next frame when pipeline is changed
+    TRenderGraph m_renderGraph;
+    bool m_isRenderGraphDirty;
+
     // shader library
     std::shared_ptr<TShaderProgramManager> m_shaderProgramManager;
 
@@ -87,6 +147,13 @@ protected:
     // flags
     bool m_isDeferredRendering;
     bool m_isShadowMapping;
+    bool m_isGPUCulling;
+    bool m_isLightVolumes;
+    bool m_isDynamicResolution;
+
+    // dynamic resolution (scale of render resolution and frame time it is driven to)
+    float m_renderScale;
+    float m_targetFrameTime;
 
     // timing data
     long int m_totalRenderedFrames;
@@ -94,11 +161,17 @@ protected:
     float m_totalRenderTime;
     float m_totalFrameRenderTime;
 
+    // rolling average of GPU time of render stages (key is stage handle)
+    std::unordered_map<handle_t, float> m_renderStageGPUTimes;
+
 private:
 
     // initialize and deinitialize all required internal renderstages
     void InitializeRenderStages ();
     void DeinitializeRenderStages ();
+
+    // resolve stages and their pipeline links to render graph
+    void CompileRenderGraph ();
 };
 
 template <typename T, typename ...Params>
@@ -110,6 +183,7 @@ std::shared_ptr<T> Renderer::Create (const std::string& name, Params&&... params
     // initialize
     renderStage->Initialize ();
     m_renderPipeline.push_back (renderStage->GetHandle ());
+    m_isRenderGraphDirty = true;
 
     // return stage
     return renderStage;
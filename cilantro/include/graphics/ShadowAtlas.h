@@ -0,0 +1,55 @@
+#ifndef _SHADOWATLAS_H_
+#define _SHADOWATLAS_H_
+
+#include "cilantroengine.h"
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace cilantro {
+
+// square region of atlas in texels (size 0 if no region is assigned)
+struct SShadowAtlasTile
+{
+    unsigned int x;
+    unsigned int y;
+    unsigned int size;
+};
+
+// Allocator of shadow map tiles in a square depth texture
+// Tiles are power of two sized quadrants of the atlas (quadtree buddy allocation),
+// freed tiles are merged with their free siblings
+class __CEAPI ShadowAtlas
+{
+public:
+    __EAPI ShadowAtlas (unsigned int size, unsigned int minTileSize);
+    __EAPI virtual ~ShadowAtlas ();
+
+    // reserve tile of at least given size (rounded up to power of two and clamped to atlas and minimum tile size)
+    // returns tile of size 0 if atlas has no free region large enough
+    __EAPI SShadowAtlasTile Allocate (unsigned int size);
+    __EAPI void Free (const SShadowAtlasTile& tile);
+
+    // release all tiles
+    __EAPI void Clear ();
+
+    __EAPI unsigned int GetSize () const;
+    __EAPI unsigned int GetMinTileSize () const;
+
+    // size of tile which would be allocated for given size
+    __EAPI unsigned int GetTileSize (unsigned int size) const;
+
+private:
+    unsigned int GetLevel (unsigned int tileSize) const;
+
+private:
+    unsigned int m_size;
+    unsigned int m_minTileSize;
+
+    // free tiles (x, y) of each level, level 0 is the whole atlas and every next level halves tile size
+    std::vector<std::set<std::pair<unsigned int, unsigned int>>> m_freeTiles;
+};
+
+} // namespace cilantro
+
+#endif
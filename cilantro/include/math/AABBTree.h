@@ -0,0 +1,89 @@
+#ifndef _AABBTREE_H_
+#define _AABBTREE_H_
+
+#include "cilantroengine.h"
+#include "math/AABB.h"
+#include "math/Vector3f.h"
+#include "math/Frustum.h"
+#include <cstdint>
+#include <vector>
+
+namespace cilantro {
+
+#define CILANTRO_AABB_TREE_NULL_NODE        -1
+
+struct SAABBTreeNode
+{
+    // bounds (fattened for leaves)
+    float lowerBound[3];
+    float upperBound[3];
+
+    // object stored in a leaf
+    handle_t userData;
+
+    // parent node (next free node when node is unused)
+    int32_t parent;
+    int32_t child1;
+    int32_t child2;
+
+    // leaf = 0, free node = -1
+    int32_t height;
+};
+
+// Dynamic bounding volume hierarchy
+// Leaves store fattened AABBs, so that small movements do not require tree update
+// Leaves are inserted next to the sibling which minimizes surface area growth (SAH)
+// and the tree is kept balanced by rotations
+class __CEAPI AABBTree
+{
+public:
+    __EAPI AABBTree (float margin = CILANTRO_AABB_TREE_MARGIN);
+    __EAPI virtual ~AABBTree ();
+
+    // insert object and return proxy id of its leaf
+    __EAPI int32_t Insert (const AABB& aabb, handle_t userData);
+    __EAPI void Remove (int32_t proxy);
+
+    // move object, returns true if leaf was reinserted (bounds left fattened AABB)
+    __EAPI bool Update (int32_t proxy, const AABB& aabb);
+
+    __EAPI void Clear ();
+
+    __EAPI handle_t GetUserData (int32_t proxy) const;
+    __EAPI int32_t GetHeight () const;
+
+    // queries append user data of intersected leaves to result
+    __EAPI void QueryFrustum (const Frustum& frustum, std::vector<handle_t>& result) const;
+    __EAPI void QuerySphere (const Vector3f& center, float radius, std::vector<handle_t>& result) const;
+    __EAPI void QueryBox (const AABB& aabb, std::vector<handle_t>& result) const;
+    __EAPI void QueryRay (const Vector3f& origin, const Vector3f& direction, float maxDistance, std::vector<handle_t>& result) const;
+
+private:
+    int32_t AllocateNode ();
+    void FreeNode (int32_t node);
+
+    void InsertLeaf (int32_t leaf);
+    void RemoveLeaf (int32_t leaf);
+    int32_t Balance (int32_t node);
+
+    // set node bounds to union of its children
+    void Refit (int32_t node);
+
+    // stack based traversal, overlaps (node) decides whether to descend
+    template <typename F>
+    void Traverse (F overlaps, std::vector<handle_t>& result) const;
+
+private:
+    std::vector<SAABBTreeNode> m_nodes;
+    int32_t m_root;
+    int32_t m_freeList;
+
+    float m_margin;
+
+    // traversal stack (reused between queries)
+    mutable std::vector<int32_t> m_stack;
+};
+
+} // namespace cilantro
+
+#endif
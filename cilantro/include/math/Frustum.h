@@ -0,0 +1,48 @@
+#ifndef _FRUSTUM_H_
+#define _FRUSTUM_H_
+
+#include "cilantroengine.h"
+#include "math/Matrix4f.h"
+#include "math/AABB.h"
+#include "math/Vector4f.h"
+
+namespace cilantro {
+
+// View frustum represented by six clip planes (left, right, bottom, top, near, far)
+// Planes are stored as structure of arrays padded to eight entries,
+// so that four planes are tested against a box at once
+class __CEAPI Frustum
+{
+public:
+    // constructors
+    __EAPI Frustum ();
+    __EAPI Frustum (const Matrix4f& viewProjection);
+
+    // destructor
+    __EAPI ~Frustum ();
+
+    // extract planes from (projection * view) matrix
+    __EAPI void SetViewProjection (const Matrix4f& viewProjection);
+
+    // returns false if box is completely outside of any plane
+    __EAPI bool Intersects (const AABB& aabb) const;
+    __EAPI bool Intersects (const Vector3f& center, const Vector3f& extents) const;
+
+    // plane (normal, distance) in order left, right, bottom, top, near, far
+    __EAPI Vector4f GetPlane (unsigned int index) const;
+
+private:
+    alignas (16) float m_planeX[8];
+    alignas (16) float m_planeY[8];
+    alignas (16) float m_planeZ[8];
+    alignas (16) float m_planeW[8];
+
+    // absolute values of plane normals
+    alignas (16) float m_absPlaneX[8];
+    alignas (16) float m_absPlaneY[8];
+    alignas (16) float m_absPlaneZ[8];
+};
+
+} // namespace cilantro
+
+#endif
@@ -43,6 +43,9 @@ public:
     __EAPI size_t GetFaceCount () const;
     __EAPI size_t GetIndexCount () const;
 
+    // get version of mesh data (incremented on each mesh update)
+    __EAPI size_t GetVersion () const;
+
     // get raw data
     __EAPI float* GetVerticesData ();
     __EAPI float* GetNormalsData ();
@@ -80,6 +83,9 @@ private:
 
     bool smoothNormals;
 
+    // number of mesh updates so far
+    size_t version;
+
     // index in this vector is bone index, element is bone handle in resource manager
     std::vector<handle_t> meshBones;
 
@@ -3,6 +3,7 @@
 
 #include "cilantroengine.h"
 #include "system/LogMessage.h"
+#include "system/Profiler.h"
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -68,6 +69,7 @@ std::shared_ptr<T> ResourceManager<Base>::Load (const std::string& name, const s
 {
     static_assert (std::is_base_of<Base, T>::value, "Invalid base class for resource");
     static_assert (std::is_base_of<LoadableResource, T>::value, "Resource is not derived from LoadableResource");
+    CILANTRO_PROFILE_ZONE ("Load " + name);
     std::shared_ptr<T> newResource;
 
     newResource = std::make_shared<T> (path, std::forward<Params>(params)...);
@@ -5,6 +5,7 @@
 #include "scene/GameObject.h"
 #include "math/Matrix4f.h"
 #include "math/Vector4f.h"
+#include "math/Frustum.h"
 #include <array>
 
 namespace cilantro {
@@ -19,6 +20,7 @@ public:
     __EAPI virtual Matrix4f GetProjectionMatrix (unsigned int xRes, unsigned int yRes) const = 0;
 
     __EAPI std::array<Vector3f, 8> GetFrustumVertices (unsigned int xRes, unsigned int yRes) const;
+    __EAPI Frustum GetFrustum (unsigned int xRes, unsigned int yRes) const;
 
 };
 
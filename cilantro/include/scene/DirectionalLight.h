@@ -3,6 +3,9 @@
 
 #include "cilantroengine.h"
 #include "scene/Light.h"
+#include "math/Matrix4f.h"
+#include "math/AABB.h"
+#include <array>
 
 struct IRenderer;
 
@@ -14,11 +17,29 @@ public:
     __EAPI DirectionalLight (std::shared_ptr<GameScene> gameScene);
     __EAPI virtual ~DirectionalLight ();
 
+    // set number of shadow cascades (1 to CILANTRO_MAX_SHADOW_CASCADES) and blend of their split distances
+    // between uniform (0.0) and logarithmic (1.0) distribution over view depth
+    __EAPI std::shared_ptr<DirectionalLight> SetShadowCascadeCount (unsigned int cascadeCount);
+    __EAPI std::shared_ptr<DirectionalLight> SetShadowCascadeSplitLambda (float lambda);
+
+    // getters
+    __EAPI unsigned int GetShadowCascadeCount () const;
+    __EAPI float GetShadowCascadeSplitLambda () const;
+
+    // view depth of far end of cascade for given view depth range
+    __EAPI float GetShadowCascadeSplit (unsigned int cascade, float nearPlane, float farPlane) const;
+
+    // calculate light view projection for cascade of camera frustum (vertices spanning view depth range) and scene AABB,
+    // cascade is bounded by sphere and snapped to shadow map texels of given resolution, so it does not shimmer when camera moves
+    __EAPI Matrix4f GenCascadeViewProjectionMatrix (const std::array<Vector3f, 8>& frustumVertices, float nearPlane, float farPlane, unsigned int cascade, const AABB& sceneAABB, unsigned int resolution);
+
     // invoked by game loop on update	
     __EAPI void OnUpdate (IRenderer& renderer);
 
 private:
 
+    unsigned int m_shadowCascadeCount;
+    float m_shadowCascadeSplitLambda;
 };
 
 } // namespace cilantro
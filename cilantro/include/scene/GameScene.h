@@ -7,6 +7,7 @@
 #include "graphics/Renderer.h"
 #include "input/InputController.h"
 #include "math/AABB.h"
+#include "math/AABBTree.h"
 #include "system/Timer.h"
 #include "system/MessageBus.h"
 #include "system/Message.h"
@@ -18,6 +19,9 @@
 #include "scene/Light.h"
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace cilantro {
 
@@ -71,7 +75,19 @@ public:
     __EAPI void SetActiveCamera (const std::string& name);
     __EAPI std::shared_ptr<Camera> GetActiveCamera () const;
 
+    // spatial index of unskinned meshes (world space bounds)
+    // objects which can not be bounded (skinned meshes, lights, cameras...) are listed separately
+    __EAPI void UpdateSpatialIndex ();
+    __EAPI const AABBTree& GetSpatialIndex () const;
+    __EAPI const std::vector<handle_t>& GetUnindexedObjects () const;
+
+    // bounds of mesh in model space (calculated on first use after mesh update)
+    __EAPI const AABB& GetModelSpaceBounds (std::shared_ptr<MeshObject> meshObject);
+
 private:
+
+    // mark object and its descendants for spatial index update
+    void InvalidateSpatialIndex (handle_t objectHandle);
     
     // game reference
     std::weak_ptr<Game> m_game;
@@ -89,6 +105,17 @@ private:
     // reference to active camera
     std::weak_ptr<Camera> m_activeCamera;
 
+    // spatial index and its leaves (key is object handle)
+    AABBTree m_spatialIndex;
+    std::unordered_map<handle_t, int32_t> m_spatialIndexProxies;
+    std::vector<handle_t> m_unindexedObjects;
+
+    // bounds of meshes in model space (key is object handle)
+    std::unordered_map<handle_t, AABB> m_modelSpaceBounds;
+
+    // objects with modified bounds since last index update
+    std::unordered_set<handle_t> m_spatialIndexDirtyObjects;
+
 };
 
 template <typename T, typename ...Params>
@@ -98,6 +125,7 @@ std::shared_ptr<T> GameScene::Create (const std::string& name, Params&&... param
     auto gameObject = m_gameObjectManager->Create<T> (name, shared_from_this (), params...);
     gameObject->SetParentObject ("root");
     handle_t handle = gameObject->GetHandle ();
+    m_spatialIndexDirtyObjects.insert (handle);
 
     // update renderer data
     if constexpr (std::is_base_of<MeshObject, T>::value)
@@ -120,6 +148,7 @@ requires (std::is_base_of_v<GameObject,T>)
 {
     m_gameObjectManager->Add<T> (name, gameObject);
     handle_t handle = gameObject->GetHandle ();
+    m_spatialIndexDirtyObjects.insert (handle);
 
     // update renderer data
     if constexpr (std::is_base_of<MeshObject, T>::value)
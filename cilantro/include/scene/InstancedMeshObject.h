@@ -0,0 +1,49 @@
+#ifndef _INSTANCEDMESHOBJECT_H_
+#define _INSTANCEDMESHOBJECT_H_
+
+#include "cilantroengine.h"
+#include "math/AABB.h"
+#include "math/Matrix4f.h"
+#include "scene/MeshObject.h"
+#include <vector>
+
+namespace cilantro {
+
+// Represents many copies of a 3d mesh sharing one material, inherits from MeshObject
+// Each instance has its own transformation relative to the object, all instances are drawn with a single draw call
+class __CEAPI InstancedMeshObject : public MeshObject
+{
+public:
+    __EAPI InstancedMeshObject (std::shared_ptr<GameScene> gameScene, const std::string& meshName, const std::string& materialName);
+    __EAPI virtual ~InstancedMeshObject ();
+
+    // instance manipulation (returns index of added instance)
+    __EAPI size_t AddInstance (const Matrix4f& transform);
+    __EAPI std::shared_ptr<InstancedMeshObject> SetInstanceTransform (size_t index, const Matrix4f& transform);
+    __EAPI std::shared_ptr<InstancedMeshObject> ClearInstances ();
+
+    __EAPI const Matrix4f& GetInstanceTransform (size_t index) const;
+    __EAPI const std::vector<Matrix4f>& GetInstanceTransforms () const;
+    __EAPI size_t GetInstanceCount () const;
+
+    // incremented on every instance modification (used by renderer to reload instance buffers)
+    __EAPI size_t GetInstanceTransformsVersion () const;
+
+    // bounds of all instances in object space, given bounds of the mesh
+    __EAPI AABB GetInstancesBounds (const AABB& meshBounds) const;
+
+    // get axis aligned bounding box of all instances
+    __EAPI AABB GetAABB () override;
+
+private:
+    // instances changed - update bounds and renderer data
+    void InvalidateInstances ();
+
+private:
+    std::vector<Matrix4f> m_instanceTransforms;
+    size_t m_instanceTransformsVersion;
+};
+
+} // namespace cilantro
+
+#endif
@@ -28,9 +28,11 @@ public:
     __EAPI std::shared_ptr<Material> SetForwardShaderProgram (const std::string& name);
     __EAPI std::shared_ptr<Material> SetDeferredGeometryPassShaderProgram (const std::string& name);
     __EAPI std::shared_ptr<Material> SetDeferredLightingPassShaderProgram (const std::string& name);
+    __EAPI std::shared_ptr<Material> SetDeferredLightVolumeShaderProgram (const std::string& name);
     __EAPI std::string GetForwardShaderProgram () const;
     __EAPI std::string GetDeferredGeometryPassShaderProgram () const;
     __EAPI std::string GetDeferredLightingPassShaderProgram () const;
+    __EAPI std::string GetDeferredLightVolumeShaderProgram () const;
 
     __EAPI std::shared_ptr<GameScene> GetGameScene () const;
 
@@ -56,6 +58,8 @@ protected:
     std::string m_forwardShaderProgram;
     std::string m_deferredGeometryPassShaderProgram;
     std::string m_deferredLightingPassShaderProgram;
+    // lighting pass drawing light volumes of point and spot lights (none if empty, lighting pass then shades all lights)
+    std::string m_deferredLightVolumeShaderProgram;
 
 };
 
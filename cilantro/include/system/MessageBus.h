@@ -7,6 +7,7 @@
 #include <memory>
 #include <typeindex>
 #include "system/Message.h"
+#include "system/Profiler.h"
 
 namespace cilantro {
 
@@ -32,6 +33,7 @@ public:
     void Publish(const std::shared_ptr<T>& message) 
     {
         static_assert(std::is_base_of<Message, T>::value, "T must be a subclass of Message");
+        CILANTRO_PROFILE_ZONE ("MessageBus::Publish");
         auto it = subscribers.find(typeid(T));
         if (it != subscribers.end()) 
         {
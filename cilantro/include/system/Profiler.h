@@ -0,0 +1,56 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "cilantroengine.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// scoped CPU zones, compiled out unless built with CILANTRO_WITH_PROFILER (name expression is not evaluated then)
+#ifdef CILANTRO_WITH_PROFILER
+  #define CILANTRO_PROFILER_CONCAT_(a, b) a##b
+  #define CILANTRO_PROFILER_CONCAT(a, b) CILANTRO_PROFILER_CONCAT_(a, b)
+  #define CILANTRO_PROFILE_ZONE(name) cilantro::ProfilerZone CILANTRO_PROFILER_CONCAT(profilerZone, __LINE__) (name)
+#else
+  #define CILANTRO_PROFILE_ZONE(name)
+#endif
+
+namespace cilantro {
+
+class __CEAPI Profiler
+{
+public:
+    // record zone of calling thread (times are nanoseconds since profiler start)
+    __EAPI static void RecordZone (const char* name, int64_t startTime, int64_t endTime);
+
+    // time since profiler start (in nanoseconds)
+    __EAPI static int64_t GetTime ();
+
+    // write last CILANTRO_PROFILER_EVENTS zones of every thread as Chrome trace JSON (chrome://tracing, Perfetto)
+    __EAPI static bool WriteChromeTrace (const std::string& path);
+
+    // discard recorded zones of all threads
+    __EAPI static void Clear ();
+};
+
+class __CEAPI ProfilerZone
+{
+public:
+    // name is expected to be string literal
+    __EAPI ProfilerZone (const char* name);
+    // name is copied (e.g. name of resource)
+    __EAPI ProfilerZone (std::string name);
+    __EAPI ~ProfilerZone ();
+
+    ProfilerZone (const ProfilerZone&) = delete;
+    ProfilerZone& operator= (const ProfilerZone&) = delete;
+
+private:
+    std::string m_nameStorage;
+    const char* m_name;
+    int64_t m_startTime;
+};
+
+} // namespace cilantro
+
+#endif
@@ -9,12 +9,14 @@ layout (std140, binding = %%UBO_MATRICES%%) uniform UniformMatricesBlock
 {
     mat4 mView;
     mat4 mProjection;
+    mat4 mInverseViewProjection;
 };
 #else
 layout (std140) uniform UniformMatricesBlock
 {
     mat4 mView;
     mat4 mProjection;
+    mat4 mInverseViewProjection;
 };
 #endif
 
@@ -25,31 +25,40 @@ uniform sampler2D tSpecular;
 uniform sampler2D tEmissive;
 #endif
 
-uniform float fSpecularShininess;
+
+/* material properties compiled by renderer (range of materials buffer bound for drawn material) */
+#if (__VERSION__ >= 420)
+layout (std140, binding = %%UBO_MATERIALS%%) uniform UniformMaterialBlock
+{
+    float fSpecularShininess;
+};
+#else
+layout (std140) uniform UniformMaterialBlock
+{
+    float fSpecularShininess;
+};
+#endif
 
 /* eye position in world space */
 uniform vec3 eyePosition;
 
-/* output g-buffer */
-layout (location=0) out vec4 gPosition;
-layout (location=1) out vec4 gNormal;
-layout (location=2) out vec4 gDiffuse;
+/* output g-buffer (position is reconstructed from depth) */
+layout (location=0) out vec2 gNormal;
+layout (location=1) out vec4 gDiffuse;
+layout (location=2) out vec4 gSpecular;
 layout (location=3) out vec4 gEmissive;
-layout (location=4) out vec4 gSpecular;
+
+%%include shaders/gbuffer.fs%%
 
 void main()
 {
-    /* fragment position */
-    gPosition.xyz = fPosition;
-
     /* fragment normal */
-    gNormal.xyz = normalize (TBN * (texture (tNormal, fUV).rgb * 2.0 - 1.0));
+    gNormal = EncodeNormal (normalize (TBN * (texture (tNormal, fUV).rgb * 2.0 - 1.0)));
 
     /* pbr material properties */
     gDiffuse.rgb = texture (tDiffuse, fUV).rgb;
     gEmissive.rgb = texture (tEmissive, fUV).rgb;
     gSpecular.rgb = texture (tSpecular, fUV).rgb;
-    gSpecular.a = fSpecularShininess;
+    gSpecular.a = EncodeShininess (fSpecularShininess);
 
 } 
-
@@ -8,17 +8,17 @@ vec3 viewDirection;
 
 /* g-buffer */
 #if (__VERSION__ >= 420)
-layout (binding=0) uniform sampler2D tPosition;
-layout (binding=1) uniform sampler2D tNormal;
-layout (binding=2) uniform sampler2D tDiffuse;
+layout (binding=0) uniform sampler2D tNormal;
+layout (binding=1) uniform sampler2D tDiffuse;
+layout (binding=2) uniform sampler2D tSpecular;
 layout (binding=3) uniform sampler2D tEmissive;
-layout (binding=4) uniform sampler2D tSpecular;
+layout (binding=%%CILANTRO_GBUFFER_DEPTH_BINDING%%) uniform sampler2D tDepth;
 #else
-uniform sampler2D tPosition;
 uniform sampler2D tNormal;
 uniform sampler2D tDiffuse;
-uniform sampler2D tEmissive;
 uniform sampler2D tSpecular;
+uniform sampler2D tEmissive;
+uniform sampler2D tDepth;
 #endif
 
 vec3 fPosition;
@@ -31,42 +31,74 @@ float fSpecularShininess;
 /* eye position in world space */
 uniform vec3 eyePosition;
 
+/* point and spot lights are shaded by their light volumes instead of full-screen pass */
+uniform int lightVolumesEnabled;
+
+/* light shaded by light volume draw (LIGHTVOLUME_NONE for full-screen pass) */
+uniform int lightVolumeType;
+uniform int lightVolumeIdx;
+
 /* output color */
 out vec4 color;
 
 %%include shaders/lights.fs%%
 %%include shaders/shadows.fs%%
 %%include shaders/blinnphong.fs%%
+%%include shaders/gbuffer.fs%%
+%%include shaders/renderscale.fs%%
 
 void main()
 {
-    fPosition = texture (tPosition, fTextureCoordinates).xyz;
-    fNormal = texture (tNormal, fTextureCoordinates).xyz;
-    
-    fDiffuseColor = texture (tDiffuse, fTextureCoordinates).rgb;
-    fEmissiveColor = texture (tEmissive, fTextureCoordinates).rgb;
-    fSpecularColor = texture (tSpecular, fTextureCoordinates).rgb;
-    fSpecularShininess = texture (tSpecular, fTextureCoordinates).a;
+    /* light volumes are not screen-aligned, so g-buffer is sampled at fragment's window position (kept inside of rendered part) */
+    vec2 uv = (lightVolumeType == %%LIGHTVOLUME_NONE%%) ? fTextureCoordinates : gl_FragCoord.xy / vec2 (textureSize (tDepth, 0));
+    uv = ClampToRenderScale (uv, tDepth);
+
+    fPosition = ReconstructPosition (uv / uvScale, texture (tDepth, uv).r, mInverseViewProjection);
+    fNormal = DecodeNormal (texture (tNormal, uv).rg);
     
-    color = vec4 (fEmissiveColor, 1.0);
+    fDiffuseColor = texture (tDiffuse, uv).rgb;
+    fEmissiveColor = texture (tEmissive, uv).rgb;
+    fSpecularColor = texture (tSpecular, uv).rgb;
+    fSpecularShininess = DecodeShininess (texture (tSpecular, uv).a);
     
     /* calculate viewing direction */
     viewDirection = normalize (eyePosition - fPosition);
 
-    for (int i=0; i < pointLightCount; i++)
+    /* single light of volume, added to output of full-screen pass */
+    if (lightVolumeType == %%LIGHTVOLUME_POINT%%)
     {
-        color += CalculatePointLight (pointLights[i], i);
+        color = vec4 (CalculatePointLight (pointLights[lightVolumeIdx], lightVolumeIdx).rgb, 0.0);
+        return;
     }
+    else if (lightVolumeType == %%LIGHTVOLUME_SPOT%%)
+    {
+        color = vec4 (CalculateSpotLight (spotLights[lightVolumeIdx], lightVolumeIdx).rgb, 0.0);
+        return;
+    }
+
+    color = vec4 (fEmissiveColor, 1.0);
 
     for (int i=0; i < directionalLightCount; i++)
     {
         color += CalculateDirectionalLight (directionalLights[i], i);
     }
 
-    for (int i=0; i < spotLightCount; i++)
+    if (lightVolumesEnabled == 0)
     {
-        color += CalculateSpotLight (spotLights[i], i);
-    }		
+        /* only lights overlapping fragment's cluster are evaluated */
+        SelectLightCluster (fPosition);
+
+        for (int i=0; i < GetClusterPointLightCount (); i++)
+        {
+            int pointLightIdx = GetClusterPointLightIndex (i);
+            color += CalculatePointLight (pointLights[pointLightIdx], pointLightIdx);
+        }
+
+        for (int i=0; i < GetClusterSpotLightCount (); i++)
+        {
+            int spotLightIdx = GetClusterSpotLightIndex (i);
+            color += CalculateSpotLight (spotLights[spotLightIdx], spotLightIdx);
+        }
+    }
     
 } 
-
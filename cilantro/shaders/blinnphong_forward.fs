@@ -29,7 +29,19 @@ vec3 fNormal;
 vec3 fDiffuseColor;
 vec3 fSpecularColor;
 vec3 fEmissiveColor;
-uniform float fSpecularShininess;
+
+/* material properties compiled by renderer (range of materials buffer bound for drawn material) */
+#if (__VERSION__ >= 420)
+layout (std140, binding = %%UBO_MATERIALS%%) uniform UniformMaterialBlock
+{
+    float fSpecularShininess;
+};
+#else
+layout (std140) uniform UniformMaterialBlock
+{
+    float fSpecularShininess;
+};
+#endif
 
 /* eye position in world space */
 uniform vec3 eyePosition;
@@ -53,9 +65,13 @@ void main()
     /* calculate viewing direction */
     viewDirection = normalize (eyePosition - fPosition);
 
-    for (int i=0; i < pointLightCount; i++)
+    /* only lights overlapping fragment's cluster are evaluated */
+    SelectLightCluster (fPosition);
+
+    for (int i=0; i < GetClusterPointLightCount (); i++)
     {
-        color += CalculatePointLight (pointLights[i], i);
+        int pointLightIdx = GetClusterPointLightIndex (i);
+        color += CalculatePointLight (pointLights[pointLightIdx], pointLightIdx);
     }
 
     for (int i=0; i < directionalLightCount; i++)
@@ -63,8 +79,9 @@ void main()
         color += CalculateDirectionalLight (directionalLights[i], i);
     }
 
-    for (int i=0; i < spotLightCount; i++)
+    for (int i=0; i < GetClusterSpotLightCount (); i++)
     {
-        color += CalculateSpotLight (spotLights[i], i);
+        int spotLightIdx = GetClusterSpotLightIndex (i);
+        color += CalculateSpotLight (spotLights[spotLightIdx], spotLightIdx);
     }		
 } 
\ No newline at end of file
@@ -0,0 +1,96 @@
+#version %%CILANTRO_GLSL_VERSION%%
+
+layout(local_size_x = %%CILANTRO_COMPUTE_GROUP_SIZE%%) in;
+
+/* frustum planes (normal, distance) packed as six vec4 */
+uniform float frustumPlanes[24];
+
+/* number of objects to test */
+uniform uint objectCount;
+
+/* compact surviving draws using counter, otherwise keep command order and zero instance count of culled draws */
+uniform bool compactDrawCommands;
+
+struct ObjectTransformStruct
+{
+    mat4 mModel;
+    mat3 mNormal;
+    uint shadowCasterMask;
+};
+
+struct CullObjectStruct
+{
+    /* model space bounds */
+    vec4 center;
+    vec4 extents;
+    /* draw range in geometry pool, base instance indexes object transforms */
+    uint count;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+struct DrawCommandStruct
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout(std430, binding = %%SSBO_OBJECTTRANSFORMS%%) readonly buffer ObjectTransformsBlock {
+    ObjectTransformStruct objectTransforms[];
+};
+
+layout(std430, binding = %%SSBO_CULLOBJECTS%%) readonly buffer CullObjectsBlock {
+    CullObjectStruct cullObjects[];
+};
+
+layout(std430, binding = %%SSBO_DRAWCOMMANDS%%) writeonly buffer DrawCommandsBlock {
+    DrawCommandStruct drawCommands[];
+};
+
+layout(binding = %%ACB_DRAWCOUNT%%, offset = 0) uniform atomic_uint drawCount;
+
+bool isVisible(vec3 center, vec3 extents) {
+    for (int i = 0; i < 6; ++i) {
+        vec4 plane = vec4(frustumPlanes[i * 4], frustumPlanes[i * 4 + 1], frustumPlanes[i * 4 + 2], frustumPlanes[i * 4 + 3]);
+
+        if (dot(plane.xyz, center) + plane.w + dot(abs(plane.xyz), extents) < 0.0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void main() {
+    uint gid = gl_GlobalInvocationID.x;
+
+    if (gid >= objectCount) {
+        return;
+    }
+
+    CullObjectStruct o = cullObjects[gid];
+    mat4 m = objectTransforms[o.baseInstance].mModel;
+
+    // transform box to world space (Arvo)
+    vec3 center = (m * vec4(o.center.xyz, 1.0)).xyz;
+    vec3 extents = mat3(abs(m[0].xyz), abs(m[1].xyz), abs(m[2].xyz)) * o.extents.xyz;
+    bool visible = isVisible(center, extents);
+
+    DrawCommandStruct command;
+    command.count = o.count;
+    command.instanceCount = visible ? 1u : 0u;
+    command.firstIndex = o.firstIndex;
+    command.baseVertex = o.baseVertex;
+    command.baseInstance = o.baseInstance;
+
+    if (!compactDrawCommands) {
+        drawCommands[gid] = command;
+    }
+    else if (visible) {
+        drawCommands[atomicCounterIncrement(drawCount)] = command;
+    }
+}
@@ -20,8 +20,47 @@ in vec4 vBoneWeights;
 #endif
 
 /* transformation matrices */
+#if (__VERSION__ >= 430)
+struct InstanceTransformStruct
+{
+    mat4 mInstanceModel;
+    mat3 mInstanceNormal;
+    uint instanceShadowCasterMask;
+};
+
+/* per-instance transformations relative to object, indexed by instance id (single identity transformation for non-instanced draws) */
+layout (std430, binding = %%SSBO_INSTANCETRANSFORMS%%) readonly buffer InstanceTransformsBlock
+{
+    InstanceTransformStruct instanceTransforms[];
+};
+
+#define mInstanceModel instanceTransforms[gl_InstanceID].mInstanceModel
+#define mInstanceNormal instanceTransforms[gl_InstanceID].mInstanceNormal
+#else
+#define mInstanceModel mat4 (1.0)
+#define mInstanceNormal mat3 (1.0)
+#endif
+
+#if (__VERSION__ >= 460)
+struct ObjectTransformStruct
+{
+    mat4 mModel;
+    mat3 mNormal;
+    uint shadowCasterMask;
+};
+
+/* per-draw transformations, indexed by draw's base instance */
+layout (std430, binding = %%SSBO_OBJECTTRANSFORMS%%) readonly buffer ObjectTransformsBlock
+{
+    ObjectTransformStruct objectTransforms[];
+};
+
+#define mModel objectTransforms[gl_BaseInstance].mModel
+#define mNormal objectTransforms[gl_BaseInstance].mNormal
+#else
 uniform mat4 mModel;
 uniform mat3 mNormal;
+#endif
 
 /* view and projection matrices */
 #if (__VERSION__ >= 420)
@@ -29,12 +68,14 @@ layout (std140, binding = %%UBO_MATRICES%%) uniform UniformMatricesBlock
 {
     mat4 mView;
     mat4 mProjection;
+    mat4 mInverseViewProjection;
 };
 #else
 layout (std140) uniform UniformMatricesBlock
 {
     mat4 mView;
     mat4 mProjection;
+    mat4 mInverseViewProjection;
 };
 #endif
 
@@ -70,11 +111,15 @@ void main ()
         transformedBitangent += boneTransform * vec4 (vBitangent, 0.0) * vBoneWeights[i];
     }
 
-    gl_Position = mProjection * mView * mModel * transformedPosition;
+    /* object and instance transformations combined (inverse transpose of product is product of inverse transposes) */
+    mat4 model = mModel * mInstanceModel;
+    mat3 normal = mNormal * mInstanceNormal;
+
+    gl_Position = mProjection * mView * model * transformedPosition;
     
     /* calculate TBN matrix */
-    vec3 T = normalize (mNormal * vec3 (transformedTangent));
-    vec3 N = normalize (mNormal * vec3 (transformedNormal));
+    vec3 T = normalize (normal * vec3 (transformedTangent));
+    vec3 N = normalize (normal * vec3 (transformedNormal));
     T = normalize (T - dot (T, N) * N);
     vec3 B = cross (N, T);
 
@@ -86,7 +131,7 @@ void main ()
     TBN = mat3 (T, B, N);
 
     /* world space vertex position */
-    fPosition = vec3 (mModel * transformedPosition);
+    fPosition = vec3 (model * transformedPosition);
 
     /* texture coordinates */
     fUV = vUV;
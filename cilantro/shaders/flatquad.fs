@@ -6,12 +6,14 @@ in vec2 fTextureCoordinates;
 /* output color */
 out vec4 color;
 
+%%include shaders/renderscale.fs%%
+
 /* texture */
 uniform sampler2D fScreenTexture;
 
 void main()
 {
-    color = texture (fScreenTexture, fTextureCoordinates);
+    color = texture (fScreenTexture, ClampToRenderScale (fTextureCoordinates, fScreenTexture));
 } 
     
 
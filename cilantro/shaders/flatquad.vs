@@ -10,9 +10,12 @@ in vec2 vTextureCoordinates;
 
 out vec2 fTextureCoordinates;
 
+/* part of input textures rendered at current render scale (fragment shaders clamp coordinates inside of it, see renderscale.fs) */
+uniform vec2 uvScale;
+
 void main ()
 {
     gl_Position = vec4 (vPosition.x, vPosition.y, 0.0, 1.0);
-    fTextureCoordinates = vTextureCoordinates;
+    fTextureCoordinates = vTextureCoordinates * uvScale;
 }
 
@@ -0,0 +1,44 @@
+/* g-buffer encoding (shared by geometry and lighting passes) */
+
+/* octahedral encoding of unit vector into [0, 1] range of 2-channel texture */
+vec2 OctahedronWrap (vec2 v)
+{
+    return (1.0 - abs (v.yx)) * vec2 (v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeNormal (vec3 n)
+{
+    n /= (abs (n.x) + abs (n.y) + abs (n.z));
+    n.xy = (n.z >= 0.0) ? n.xy : OctahedronWrap (n.xy);
+
+    return n.xy * 0.5 + 0.5;
+}
+
+vec3 DecodeNormal (vec2 e)
+{
+    vec2 f = e * 2.0 - 1.0;
+    vec3 n = vec3 (f, 1.0 - abs (f.x) - abs (f.y));
+    float t = clamp (-n.z, 0.0, 1.0);
+    n.xy += vec2 (n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+
+    return normalize (n);
+}
+
+/* specular exponent stored logarithmically in 8 bits (range 1 - 2048) */
+float EncodeShininess (float shininess)
+{
+    return clamp (log2 (max (shininess, 1.0)) / 11.0, 0.0, 1.0);
+}
+
+float DecodeShininess (float e)
+{
+    return exp2 (e * 11.0);
+}
+
+/* world space position of fragment from its g-buffer uv and depth buffer value */
+vec3 ReconstructPosition (vec2 uv, float depth, mat4 inverseViewProjection)
+{
+    vec4 position = inverseViewProjection * vec4 (vec3 (uv, depth) * 2.0 - 1.0, 1.0);
+
+    return position.xyz / position.w;
+}
@@ -27,7 +27,14 @@ struct SpotLightStruct
     float outerCutoffCosine;
 };
 
-#if (__VERSION__ >= 420)
+/* point and spot lights are not limited by uniform block size when stored in shader storage buffers */
+#if (__VERSION__ >= 430)
+layout(std430, binding = %%SSBO_POINTLIGHTS%%) readonly buffer PointLightsBlock
+{
+    int pointLightCount;
+    PointLightStruct pointLights[];
+};
+#elif (__VERSION__ >= 420)
 layout(std140, binding = %%UBO_POINTLIGHTS%%) uniform UniformPointLightsBlock
 {
     int pointLightCount;
@@ -55,7 +62,13 @@ layout(std140) uniform UniformDirectionalLightsBlock
 };
 #endif
 
-#if (__VERSION__ >= 420)
+#if (__VERSION__ >= 430)
+layout(std430, binding = %%SSBO_SPOTLIGHTS%%) readonly buffer SpotLightsBlock
+{
+    int spotLightCount;
+    SpotLightStruct spotLights[];
+};
+#elif (__VERSION__ >= 420)
 layout(std140, binding = %%UBO_SPOTLIGHTS%%) uniform UniformSpotLightsBlock
 {
     int spotLightCount;
@@ -67,4 +80,98 @@ layout(std140) uniform UniformSpotLightsBlock
     int spotLightCount;
     SpotLightStruct spotLights[%%CILANTRO_MAX_SPOT_LIGHTS%%];
 };
-#endif
\ No newline at end of file
+#endif
+
+/* view and projection matrices */
+#if (__VERSION__ >= 420)
+layout (std140, binding = %%UBO_MATRICES%%) uniform UniformMatricesBlock
+{
+    mat4 mView;
+    mat4 mProjection;
+    mat4 mInverseViewProjection;
+};
+#else
+layout (std140) uniform UniformMatricesBlock
+{
+    mat4 mView;
+    mat4 mProjection;
+    mat4 mInverseViewProjection;
+};
+#endif
+
+/* light clusters */
+#if (__VERSION__ >= 430)
+/* froxel grid of view frustum (screen tiles x exponential depth slices), each cluster is a range of point lights and a range of spot lights in light index list */
+layout (std430, binding = %%SSBO_LIGHTCLUSTERS%%) readonly buffer LightClustersBlock
+{
+    float clusterNearPlane;
+    float clusterFarPlane;
+    float clusterSliceScale;
+    uvec4 lightClusters[];
+};
+
+layout (std430, binding = %%SSBO_LIGHTINDICES%%) readonly buffer LightIndicesBlock
+{
+    uint lightIndices[];
+};
+
+/* cluster of shaded fragment (x, y - point lights offset and count, z, w - spot lights offset and count) */
+uvec4 lightCluster;
+
+void SelectLightCluster (vec3 position)
+{
+    vec4 viewPosition = mView * vec4 (position, 1.0);
+    vec4 clipPosition = mProjection * viewPosition;
+
+    vec2 tile = floor ((clamp (clipPosition.xy / clipPosition.w, -1.0, 1.0) * 0.5 + 0.5) * vec2 (%%CILANTRO_LIGHT_CLUSTERS_X%%, %%CILANTRO_LIGHT_CLUSTERS_Y%%));
+    float slice = floor (log (max (-viewPosition.z, clusterNearPlane) / clusterNearPlane) * clusterSliceScale);
+    uvec3 cluster = uvec3 (min (vec3 (tile, slice), vec3 (%%CILANTRO_LIGHT_CLUSTERS_X%% - 1, %%CILANTRO_LIGHT_CLUSTERS_Y%% - 1, %%CILANTRO_LIGHT_CLUSTERS_Z%% - 1)));
+
+    lightCluster = lightClusters[cluster.x + %%CILANTRO_LIGHT_CLUSTERS_X%% * (cluster.y + %%CILANTRO_LIGHT_CLUSTERS_Y%% * cluster.z)];
+}
+
+int GetClusterPointLightCount ()
+{
+    return int (lightCluster.y);
+}
+
+int GetClusterPointLightIndex (int i)
+{
+    return int (lightIndices[lightCluster.x + uint (i)]);
+}
+
+int GetClusterSpotLightCount ()
+{
+    return int (lightCluster.w);
+}
+
+int GetClusterSpotLightIndex (int i)
+{
+    return int (lightIndices[lightCluster.z + uint (i)]);
+}
+#else
+/* without clusters every fragment iterates all lights */
+void SelectLightCluster (vec3 position)
+{
+}
+
+int GetClusterPointLightCount ()
+{
+    return pointLightCount;
+}
+
+int GetClusterPointLightIndex (int i)
+{
+    return i;
+}
+
+int GetClusterSpotLightCount ()
+{
+    return spotLightCount;
+}
+
+int GetClusterSpotLightIndex (int i)
+{
+    return i;
+}
+#endif
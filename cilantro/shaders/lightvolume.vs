@@ -0,0 +1,37 @@
+#version %%CILANTRO_GLSL_VERSION%%
+
+/* vertex data (unit sphere or cone) */
+#if (__VERSION__ >= 330)
+layout (location = 0) in vec3 vPosition;
+#else
+in vec3 vPosition;
+#endif
+
+/* light volume transformation (scaled to light's range) */
+uniform mat4 mModel;
+
+/* view and projection matrices */
+#if (__VERSION__ >= 420)
+layout (std140, binding = %%UBO_MATRICES%%) uniform UniformMatricesBlock
+{
+    mat4 mView;
+    mat4 mProjection;
+    mat4 mInverseViewProjection;
+};
+#else
+layout (std140) uniform UniformMatricesBlock
+{
+    mat4 mView;
+    mat4 mProjection;
+    mat4 mInverseViewProjection;
+};
+#endif
+
+/* unused, lighting pass samples g-buffer at fragment's window position when drawing light volumes */
+out vec2 fTextureCoordinates;
+
+void main ()
+{
+    gl_Position = mProjection * mView * mModel * vec4 (vPosition, 1.0);
+    fTextureCoordinates = vec2 (0.0);
+}
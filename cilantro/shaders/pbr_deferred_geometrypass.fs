@@ -27,19 +27,17 @@ uniform sampler2D tRoughness;
 uniform sampler2D tAO;
 #endif
 
-/* output g-buffer */
-layout (location=0) out vec4 gPosition;
-layout (location=1) out vec4 gNormal;
-layout (location=2) out vec4 gAlbedo;
-layout (location=3) out vec4 gMetallicRoughnessAO;
+/* output g-buffer (position is reconstructed from depth) */
+layout (location=0) out vec2 gNormal;
+layout (location=1) out vec4 gAlbedo;
+layout (location=2) out vec4 gMetallicRoughnessAO;
+
+%%include shaders/gbuffer.fs%%
 
 void main()
 {
-    /* fragment position */
-    gPosition.xyz = fPosition;
-
     /* fragment normal */
-    gNormal.xyz = normalize (TBN * (texture (tNormal, fUV).rgb * 2.0 - 1.0));
+    gNormal = EncodeNormal (normalize (TBN * (texture (tNormal, fUV).rgb * 2.0 - 1.0)));
 
     /* pbr material properties */
     gAlbedo.rgb = texture (tAlbedo, fUV).rgb;
@@ -47,5 +45,4 @@ void main()
     gMetallicRoughnessAO.g = texture (tRoughness, fUV).r;
     gMetallicRoughnessAO.b = texture (tAO, fUV).r;
 
-} 
-
+}
\ No newline at end of file
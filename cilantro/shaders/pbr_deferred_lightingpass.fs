@@ -8,17 +8,17 @@ vec3 viewDirection;
 
 /* g-buffer */
 #if (__VERSION__ >= 420)
-layout (binding=0) uniform sampler2D tPosition;
-layout (binding=1) uniform sampler2D tNormal;
-layout (binding=2) uniform sampler2D tAlbedo;
-layout (binding=3) uniform sampler2D tMetallicRoughnessAO;
-layout (binding=4) uniform sampler2D tUnused;
+layout (binding=0) uniform sampler2D tNormal;
+layout (binding=1) uniform sampler2D tAlbedo;
+layout (binding=2) uniform sampler2D tMetallicRoughnessAO;
+layout (binding=3) uniform sampler2D tUnused;
+layout (binding=%%CILANTRO_GBUFFER_DEPTH_BINDING%%) uniform sampler2D tDepth;
 #else
-uniform sampler2D tPosition;
 uniform sampler2D tNormal;
 uniform sampler2D tAlbedo;
 uniform sampler2D tMetallicRoughnessAO;
 uniform sampler2D tUnused;
+uniform sampler2D tDepth;
 #endif
 
 vec3 fPosition;
@@ -31,30 +31,50 @@ float fAO;
 /* eye position in world space */
 uniform vec3 eyePosition;
 
+/* point and spot lights are shaded by their light volumes instead of full-screen pass */
+uniform int lightVolumesEnabled;
+
+/* light shaded by light volume draw (LIGHTVOLUME_NONE for full-screen pass) */
+uniform int lightVolumeType;
+uniform int lightVolumeIdx;
+
 /* output color */
 out vec4 color;
 
 %%include shaders/lights.fs%%
 %%include shaders/shadows.fs%%
 %%include shaders/pbr.fs%%
+%%include shaders/gbuffer.fs%%
+%%include shaders/renderscale.fs%%
 
 void main()
 {
     vec3 Lo = vec3 (0.0);
+
+    /* light volumes are not screen-aligned, so g-buffer is sampled at fragment's window position (kept inside of rendered part) */
+    vec2 uv = (lightVolumeType == %%LIGHTVOLUME_NONE%%) ? fTextureCoordinates : gl_FragCoord.xy / vec2 (textureSize (tDepth, 0));
+    uv = ClampToRenderScale (uv, tDepth);
     
-    fPosition = texture (tPosition, fTextureCoordinates).xyz;
-    fNormal = texture (tNormal, fTextureCoordinates).xyz;
-    fAlbedo = texture (tAlbedo, fTextureCoordinates).rgb;
-    fMetallic = texture (tMetallicRoughnessAO, fTextureCoordinates).r;
-    fRoughness = texture (tMetallicRoughnessAO, fTextureCoordinates).g;
-    fAO = texture (tMetallicRoughnessAO, fTextureCoordinates).b;
+    fPosition = ReconstructPosition (uv / uvScale, texture (tDepth, uv).r, mInverseViewProjection);
+    fNormal = DecodeNormal (texture (tNormal, uv).rg);
+    fAlbedo = texture (tAlbedo, uv).rgb;
+    fMetallic = texture (tMetallicRoughnessAO, uv).r;
+    fRoughness = texture (tMetallicRoughnessAO, uv).g;
+    fAO = texture (tMetallicRoughnessAO, uv).b;
 
     /* calculate viewing direction */
     viewDirection = normalize (eyePosition - fPosition);
 
-    for (int i = 0; i < pointLightCount; i++)
+    /* single light of volume, added to output of full-screen pass */
+    if (lightVolumeType == %%LIGHTVOLUME_POINT%%)
     {
-        Lo += CalculatePointLight (i);
+        color = vec4 (CalculatePointLight (lightVolumeIdx), 0.0);
+        return;
+    }
+    else if (lightVolumeType == %%LIGHTVOLUME_SPOT%%)
+    {
+        color = vec4 (CalculateSpotLight (lightVolumeIdx), 0.0);
+        return;
     }
 
     for (int i = 0; i < directionalLightCount; i++)
@@ -62,9 +82,20 @@ void main()
         Lo += CalculateDirectionalLight (i);
     }
 
-    for (int i = 0; i < spotLightCount; i++)
+    if (lightVolumesEnabled == 0)
     {
-        Lo += CalculateSpotLight (i);
+        /* only lights overlapping fragment's cluster are evaluated */
+        SelectLightCluster (fPosition);
+
+        for (int i = 0; i < GetClusterPointLightCount (); i++)
+        {
+            Lo += CalculatePointLight (GetClusterPointLightIndex (i));
+        }
+
+        for (int i = 0; i < GetClusterSpotLightCount (); i++)
+        {
+            Lo += CalculateSpotLight (GetClusterSpotLightIndex (i));
+        }
     }
 
     color = vec4 (Lo, 1.0);
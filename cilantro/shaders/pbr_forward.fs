@@ -59,9 +59,12 @@ void main()
     fRoughness = texture (tRoughness, fUV).r;
     fAO = texture (tAO, fUV).r;
 
-    for (int i = 0; i < pointLightCount; i++)
+    /* only lights overlapping fragment's cluster are evaluated */
+    SelectLightCluster (fPosition);
+
+    for (int i = 0; i < GetClusterPointLightCount (); i++)
     {
-        Lo += CalculatePointLight (i);
+        Lo += CalculatePointLight (GetClusterPointLightIndex (i));
     }
 
     for (int i = 0; i < directionalLightCount; i++)
@@ -69,9 +72,9 @@ void main()
         Lo += CalculateDirectionalLight (i);
     }
 
-    for (int i = 0; i < spotLightCount; i++)
+    for (int i = 0; i < GetClusterSpotLightCount (); i++)
     {
-        Lo += CalculateSpotLight (i);
+        Lo += CalculateSpotLight (GetClusterSpotLightIndex (i));
     }
 
     color = vec4 (Lo, 1.0);
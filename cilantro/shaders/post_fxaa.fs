@@ -18,13 +18,21 @@ uniform float fBlurStrength;
 /* output color */
 out vec4 color;
 
+%%include shaders/renderscale.fs%%
+
+/* neighbourhood samples stay inside of rendered part */
+vec4 SampleScreen (vec2 uv)
+{
+    return texture (fScreenTexture, ClampToRenderScale (uv, fScreenTexture));
+}
+
 void main()
 {  
-    float lumaM = texture (fScreenTexture, fTextureCoordinates).a;
-    float lumaTL = texture (fScreenTexture, fTextureCoordinates + (vec2 (-1.0, -1.0) * vInvResolution)).a;
-    float lumaTR = texture (fScreenTexture, fTextureCoordinates + (vec2 (1.0, -1.0) * vInvResolution)).a;
-    float lumaBL = texture (fScreenTexture, fTextureCoordinates + (vec2 (-1.0, 1.0) * vInvResolution)).a;
-    float lumaBR = texture (fScreenTexture, fTextureCoordinates + (vec2 (1.0, 1.0) * vInvResolution)).a;
+    float lumaM = SampleScreen (fTextureCoordinates).a;
+    float lumaTL = SampleScreen (fTextureCoordinates + (vec2 (-1.0, -1.0) * vInvResolution)).a;
+    float lumaTR = SampleScreen (fTextureCoordinates + (vec2 (1.0, -1.0) * vInvResolution)).a;
+    float lumaBL = SampleScreen (fTextureCoordinates + (vec2 (-1.0, 1.0) * vInvResolution)).a;
+    float lumaBR = SampleScreen (fTextureCoordinates + (vec2 (1.0, 1.0) * vInvResolution)).a;
 
     vec2 blur;
     blur.x = ((lumaBL + lumaBR) - (lumaTL + lumaTR));
@@ -33,11 +41,11 @@ void main()
     float scale = 1.0 / (min (abs (blur.x), abs (blur.y)) + max ((lumaTL + lumaTR + lumaBL + lumaBR) * 0.25 * fBlurStrength, FXAA_REDUCE_MIN));
     blur = clamp (blur * scale, vec2 (-fMaxSpan, -fMaxSpan), vec2 (fMaxSpan, fMaxSpan)) * vInvResolution;
 
-    vec4 result1 = (1.0 / 2.0) * (texture (fScreenTexture, fTextureCoordinates + blur * vec2 (1.0 / 3.0 - 0.5)) +
-                                   texture (fScreenTexture, fTextureCoordinates + blur * vec2 (2.0 / 3.0 - 0.5)));
+    vec4 result1 = (1.0 / 2.0) * (SampleScreen (fTextureCoordinates + blur * vec2 (1.0 / 3.0 - 0.5)) +
+                                   SampleScreen (fTextureCoordinates + blur * vec2 (2.0 / 3.0 - 0.5)));
 
-    vec4 result2 = result1 * (1.0 / 2.0) + (1.0 / 4.0) * (texture (fScreenTexture, fTextureCoordinates + blur * vec2 (0.0 / 3.0 - 0.5)) +
-                                                           texture (fScreenTexture, fTextureCoordinates + blur * vec2 (3.0 / 3.0 - 0.5)));
+    vec4 result2 = result1 * (1.0 / 2.0) + (1.0 / 4.0) * (SampleScreen (fTextureCoordinates + blur * vec2 (0.0 / 3.0 - 0.5)) +
+                                                           SampleScreen (fTextureCoordinates + blur * vec2 (3.0 / 3.0 - 0.5)));
 
     float lumaMin = min (lumaM, min (min (lumaTL, lumaTR), min (lumaBL, lumaBR)));
     float lumaMax = max (lumaM, max (max (lumaTL, lumaTR), max (lumaBL, lumaBR)));
@@ -12,9 +12,11 @@ uniform float fGamma;
 /* output color */
 out vec4 color;
 
+%%include shaders/renderscale.fs%%
+
 void main()
 {
-    color = texture (fScreenTexture, fTextureCoordinates);
+    color = texture (fScreenTexture, ClampToRenderScale (fTextureCoordinates, fScreenTexture));
     color.rgb = pow (color.rgb, vec3 (1.0 / fGamma));
 } 
     
@@ -9,9 +9,11 @@ uniform sampler2D fScreenTexture;
 /* output color */
 out vec4 color;
 
+%%include shaders/renderscale.fs%%
+
 void main()
 {
-    color = texture (fScreenTexture, fTextureCoordinates);
+    color = texture (fScreenTexture, ClampToRenderScale (fTextureCoordinates, fScreenTexture));
 
     /* reinhard tone mapping */
     color.rgb = color.rgb / (color.rgb + vec3 (1.0));
@@ -0,0 +1,12 @@
+/* dynamic resolution (shared by shaders sampling textures rendered at render scale) */
+
+/* part of input textures rendered at current render scale */
+uniform vec2 uvScale;
+
+/* keep texture coordinates half a texel inside of rendered part, so that linear filtering does not blend in texels outside of it */
+vec2 ClampToRenderScale (vec2 uv, sampler2D t)
+{
+    vec2 halfTexel = 0.5 / vec2 (textureSize (t, 0));
+
+    return clamp (uv, halfTexel, uvScale - halfTexel);
+}
@@ -12,7 +12,48 @@ in vec4 vBoneWeights;
 #endif
     
 /* transformation matrices */
+#if (__VERSION__ >= 430)
+struct InstanceTransformStruct
+{
+    mat4 mInstanceModel;
+    mat3 mInstanceNormal;
+    uint instanceShadowCasterMask;
+};
+
+/* per-instance transformations relative to object, indexed by instance id (single identity transformation for non-instanced draws) */
+layout (std430, binding = %%SSBO_INSTANCETRANSFORMS%%) readonly buffer InstanceTransformsBlock
+{
+    InstanceTransformStruct instanceTransforms[];
+};
+
+#define mInstanceModel instanceTransforms[gl_InstanceID].mInstanceModel
+#else
+#define mInstanceModel mat4 (1.0)
+#endif
+
+#if (__VERSION__ >= 460)
+struct ObjectTransformStruct
+{
+    mat4 mModel;
+    mat3 mNormal;
+    uint shadowCasterMask;
+};
+
+/* per-draw transformations, indexed by draw's base instance */
+layout (std430, binding = %%SSBO_OBJECTTRANSFORMS%%) readonly buffer ObjectTransformsBlock
+{
+    ObjectTransformStruct objectTransforms[];
+};
+
+#define mModel objectTransforms[gl_BaseInstance].mModel
+#define shadowCasterMask objectTransforms[gl_BaseInstance].shadowCasterMask
+#else
 uniform mat4 mModel;
+uniform uint shadowCasterMask;
+#endif
+
+/* lights the object casts shadows for (bit per light) */
+flat out uint vShadowCasterMask;
 
 /* array of bone transformation matrices */
 #if (__VERSION__ >= 420)
@@ -35,5 +76,6 @@ void main()
         transformedPosition += boneTransform * vec4 (vPosition, 1.0) * vBoneWeights[i];
     }
 
-    gl_Position = mModel * transformedPosition;
+    gl_Position = mModel * mInstanceModel * transformedPosition;
+    vShadowCasterMask = shadowCasterMask;
 }
\ No newline at end of file
@@ -11,25 +11,72 @@ layout(triangle_strip, max_vertices = 18) out;
 layout (std140, binding = %%UBO_POINTLIGHTVIEWMATRICES%%) uniform UniformPointLightViewMatricesBlock
 {
     mat4 mLightSpace[%%CILANTRO_MAX_POINT_LIGHTS%% * 6];
+    vec4 vLightTile[%%CILANTRO_MAX_POINT_LIGHTS%% * 6];
 };
 #else
 layout (std140) uniform UniformPointLightViewMatricesBlock
 {
     mat4 mLightSpace[%%CILANTRO_MAX_POINT_LIGHTS%% * 6];
+    vec4 vLightTile[%%CILANTRO_MAX_POINT_LIGHTS%% * 6];
 };
 #endif
 
-uniform int textureArrayOffset;
+/* lights the object casts shadows for (bit per light) */
+flat in uint vShadowCasterMask[];
+
+/* clip against tile boundaries */
+out float gl_ClipDistance[4];
+
+/* emit vertex remapped to shadow atlas tile (xy - offset, z - size, in texture coordinates) and clipped to its bounds */
+void EmitTileVertex (vec4 position, vec4 tile)
+{
+    gl_Position = vec4 (position.xy * tile.z + (2.0 * tile.xy + tile.z - 1.0) * position.w, position.zw);
+    gl_ClipDistance[0] = position.w + position.x;
+    gl_ClipDistance[1] = position.w - position.x;
+    gl_ClipDistance[2] = position.w + position.y;
+    gl_ClipDistance[3] = position.w - position.y;
+    gl_Layer = 0;
+    EmitVertex ();
+}
+
+/* true if triangle lies entirely outside of one of clip volume planes */
+bool IsTriangleOutside (vec4 p0, vec4 p1, vec4 p2)
+{
+    for (int a = 0; a < 3; a++)
+    {
+        if (p0[a] < -p0.w && p1[a] < -p1.w && p2[a] < -p2.w)
+            return true;
+        if (p0[a] > p0.w && p1[a] > p1.w && p2[a] > p2.w)
+            return true;
+    }
+
+    return false;
+}
 
 void main()
 {
+    // skip lights the object was culled for
+    if ((vShadowCasterMask[0] & (1u << uint (gl_InvocationID))) == 0u)
+        return;
+
     for (int f = 0; f < 6; f++)
     {
+        vec4 tile = vLightTile[f + 6 * gl_InvocationID];
+
+        // skip faces without tile or with cached contents
+        if (tile.z == 0.0 || tile.w == 0.0)
+            continue;
+
+        mat4 lightSpace = mLightSpace[f + 6 * gl_InvocationID];
+        vec4 p[3] = vec4[3] (lightSpace * gl_in[0].gl_Position, lightSpace * gl_in[1].gl_Position, lightSpace * gl_in[2].gl_Position);
+
+        // skip faces the triangle does not cover
+        if (IsTriangleOutside (p[0], p[1], p[2]))
+            continue;
+
         for (int i = 0; i < 3; i++)
         {
-            gl_Position = mLightSpace[f + 6 * gl_InvocationID] * gl_in[i].gl_Position;
-            gl_Layer = textureArrayOffset + f + 6 * gl_InvocationID;
-            EmitVertex();
+            EmitTileVertex (p[i], tile);
         }
         
         EndPrimitive();
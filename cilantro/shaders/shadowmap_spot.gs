@@ -11,24 +11,71 @@ layout(triangle_strip, max_vertices = 3) out;
 layout (std140, binding = %%UBO_SPOTLIGHTVIEWMATRICES%%) uniform UniformSpotLightViewMatricesBlock
 {
     mat4 mLightSpace[%%CILANTRO_MAX_SPOT_LIGHTS%%];
+    vec4 vLightTile[%%CILANTRO_MAX_SPOT_LIGHTS%%];
 };
 #else
 layout (std140) uniform UniformSpotLightViewMatricesBlock
 {
     mat4 mLightSpace[%%CILANTRO_MAX_SPOT_LIGHTS%%];
+    vec4 vLightTile[%%CILANTRO_MAX_SPOT_LIGHTS%%];
 };
 #endif
 
-uniform int textureArrayOffset;
+/* lights the object casts shadows for (bit per light) */
+flat in uint vShadowCasterMask[];
+
+/* clip against tile boundaries */
+out float gl_ClipDistance[4];
+
+/* emit vertex remapped to shadow atlas tile (xy - offset, z - size, in texture coordinates) and clipped to its bounds */
+void EmitTileVertex (vec4 position, vec4 tile)
+{
+    gl_Position = vec4 (position.xy * tile.z + (2.0 * tile.xy + tile.z - 1.0) * position.w, position.zw);
+    gl_ClipDistance[0] = position.w + position.x;
+    gl_ClipDistance[1] = position.w - position.x;
+    gl_ClipDistance[2] = position.w + position.y;
+    gl_ClipDistance[3] = position.w - position.y;
+    gl_Layer = 0;
+    EmitVertex ();
+}
+
+/* true if triangle lies entirely outside of one of clip volume planes */
+bool IsTriangleOutside (vec4 p0, vec4 p1, vec4 p2)
+{
+    for (int a = 0; a < 3; a++)
+    {
+        if (p0[a] < -p0.w && p1[a] < -p1.w && p2[a] < -p2.w)
+            return true;
+        if (p0[a] > p0.w && p1[a] > p1.w && p2[a] > p2.w)
+            return true;
+    }
+
+    return false;
+}
 
 void main()
 {
+    // skip lights the object was culled for
+    if ((vShadowCasterMask[0] & (1u << uint (gl_InvocationID))) == 0u)
+        return;
+
+    vec4 tile = vLightTile[gl_InvocationID];
+
+    // skip lights without tile or with cached contents
+    if (tile.z == 0.0 || tile.w == 0.0)
+        return;
+
+    mat4 lightSpace = mLightSpace[gl_InvocationID];
+    vec4 p[3] = vec4[3] (lightSpace * gl_in[0].gl_Position, lightSpace * gl_in[1].gl_Position, lightSpace * gl_in[2].gl_Position);
+
+    // skip triangles outside of light's view
+    if (IsTriangleOutside (p[0], p[1], p[2]))
+        return;
+
     for (int i = 0; i < 3; i++)
     {
-        gl_Position = mLightSpace[gl_InvocationID] * gl_in[i].gl_Position;
-        gl_Layer = textureArrayOffset + gl_InvocationID;
-        EmitVertex();
+        EmitTileVertex (p[i], tile);
     }
     
     EndPrimitive();
-} 
\ No newline at end of file
+}
\ No newline at end of file
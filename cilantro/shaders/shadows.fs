@@ -18,12 +18,18 @@ uniform sampler2DArrayShadow tShadowMap;
 #if (__VERSION__ >= 420)
 layout (std140, binding = %%UBO_DIRECTIONALLIGHTVIEWMATRICES%%) uniform UniformDirectionalLightViewMatricesBlock
 {
-    mat4 mDirectionalLightSpace[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%%];
+    mat4 mDirectionalLightSpace[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%% * %%CILANTRO_MAX_SHADOW_CASCADES%%];
+    vec4 vDirectionalLightTile[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%% * %%CILANTRO_MAX_SHADOW_CASCADES%%];
+    vec4 vDirectionalLightCascadeSplits[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%%];
+    vec4 vCascadeDepthPlane;
 };
 #else
 layout (std140) uniform UniformDirectionalLightViewMatricesBlock
 {
-    mat4 mDirectionalLightSpace[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%%];
+    mat4 mDirectionalLightSpace[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%% * %%CILANTRO_MAX_SHADOW_CASCADES%%];
+    vec4 vDirectionalLightTile[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%% * %%CILANTRO_MAX_SHADOW_CASCADES%%];
+    vec4 vDirectionalLightCascadeSplits[%%CILANTRO_MAX_DIRECTIONAL_LIGHTS%%];
+    vec4 vCascadeDepthPlane;
 };
 #endif
 
@@ -31,11 +37,13 @@ layout (std140) uniform UniformDirectionalLightViewMatricesBlock
 layout (std140, binding = %%UBO_SPOTLIGHTVIEWMATRICES%%) uniform UniformSpotLightViewMatricesBlock
 {
     mat4 mSpotLightSpace[%%CILANTRO_MAX_SPOT_LIGHTS%%];
+    vec4 vSpotLightTile[%%CILANTRO_MAX_SPOT_LIGHTS%%];
 };
 #else
 layout (std140) uniform UniformSpotLightViewMatricesBlock
 {
     mat4 mSpotLightSpace[%%CILANTRO_MAX_SPOT_LIGHTS%%];
+    vec4 vSpotLightTile[%%CILANTRO_MAX_SPOT_LIGHTS%%];
 };
 #endif
 
@@ -43,33 +51,55 @@ layout (std140) uniform UniformSpotLightViewMatricesBlock
 layout (std140, binding = %%UBO_POINTLIGHTVIEWMATRICES%%) uniform UniformPointLightViewMatricesBlock
 {
     mat4 mPointLightSpace[6 * %%CILANTRO_MAX_POINT_LIGHTS%%];
+    vec4 vPointLightTile[6 * %%CILANTRO_MAX_POINT_LIGHTS%%];
 };
 #else
 layout (std140) uniform UniformPointLightViewMatricesBlock
 {
     mat4 mPointLightSpace[6 * %%CILANTRO_MAX_POINT_LIGHTS%%];
+    vec4 vPointLightTile[6 * %%CILANTRO_MAX_POINT_LIGHTS%%];
 };
 #endif
 
-/* calculate directional light shadow */
+/* sample shadow atlas tile (xy - offset, z - size, in texture coordinates), clamped half texel inside its bounds */
+float SampleShadowTile (vec4 tile, vec3 depthMapCoords, float bias)
+{
+    if (tile.z == 0.0)
+        return 1.0;
+
+    float halfTexel = 0.5 / float (textureSize (tShadowMap, 0).x);
+    vec2 tileCoords = tile.xy + clamp (depthMapCoords.xy * tile.z, vec2 (halfTexel), vec2 (tile.z - halfTexel));
+
+    return texture (tShadowMap, vec4 (tileCoords, 0.0, depthMapCoords.z - bias));
+}
+
+/* calculate directional light shadow (cascade is selected by view depth of fragment) */
 float CalculateDirectionalLightShadow (int directionalLightIdx)
 {
     if (shadowMapEnabled == 0)
         return 1.0;
 
-    vec4 fragmentLightSpace = mDirectionalLightSpace[directionalLightIdx] * vec4 (fPosition, 1.0);
+    // number of cascades ending in front of fragment, fragments beyond last cascade are not shadowed
+    float viewDepth = dot (vCascadeDepthPlane.xyz, fPosition) + vCascadeDepthPlane.w;
+    int cascade = int (dot (vec4 (greaterThan (vec4 (viewDepth), vDirectionalLightCascadeSplits[directionalLightIdx])), vec4 (1.0)));
+
+    if (cascade >= %%CILANTRO_MAX_SHADOW_CASCADES%%)
+        return 1.0;
+
+    int cascadeIdx = cascade + %%CILANTRO_MAX_SHADOW_CASCADES%% * directionalLightIdx;
+    vec4 fragmentLightSpace = mDirectionalLightSpace[cascadeIdx] * vec4 (fPosition, 1.0);
     vec3 depthMapCoords = fragmentLightSpace.xyz / fragmentLightSpace.w * 0.5 + 0.5;
 
     if (any (lessThan (depthMapCoords, vec3 (0.0))) || any (greaterThan (depthMapCoords, vec3 (1.0))))
         return 1.0;
 
-    return texture (tShadowMap, vec4 (depthMapCoords.xy, directionalLightIdx, depthMapCoords.z - %%CILANTRO_SHADOW_BIAS%%));
+    return SampleShadowTile (vDirectionalLightTile[cascadeIdx], depthMapCoords, %%CILANTRO_SHADOW_BIAS%%);
 }
 
-/* calculate spot light shadow */
+/* calculate spot light shadow (only first CILANTRO_MAX_SPOT_LIGHTS lights cast shadows) */
 float CalculateSpotLightShadow (int spotLightIdx)
 {
-    if (shadowMapEnabled == 0)
+    if (shadowMapEnabled == 0 || spotLightIdx >= %%CILANTRO_MAX_SPOT_LIGHTS%%)
         return 1.0;
 
     vec4 fragmentLightSpace = mSpotLightSpace[spotLightIdx] * vec4 (fPosition, 1.0);
@@ -78,13 +108,13 @@ float CalculateSpotLightShadow (int spotLightIdx)
     if (any (lessThan (depthMapCoords, vec3 (0.0))) || any (greaterThan (depthMapCoords, vec3 (1.0))))
         return 1.0;
 
-    return texture (tShadowMap, vec4 (depthMapCoords.xy, directionalLightCount + spotLightIdx, depthMapCoords.z - %%CILANTRO_SHADOW_BIAS%%));
+    return SampleShadowTile (vSpotLightTile[spotLightIdx], depthMapCoords, %%CILANTRO_SHADOW_BIAS%%);
 }
 
-/* calculate point light shadow */
+/* calculate point light shadow (only first CILANTRO_MAX_POINT_LIGHTS lights cast shadows) */
 float CalculatePointLightShadow (int pointLightIdx)
 {
-    if (shadowMapEnabled == 0)
+    if (shadowMapEnabled == 0 || pointLightIdx >= %%CILANTRO_MAX_POINT_LIGHTS%%)
         return 1.0;
 
     vec3 lightPos = pointLights[pointLightIdx].lightPosition;
@@ -111,5 +141,5 @@ float CalculatePointLightShadow (int pointLightIdx)
     if (any (lessThan (depthMapCoords, vec3 (0.0))) || any (greaterThan (depthMapCoords, vec3 (1.0))))
         return 1.0;
 
-    return texture (tShadowMap, vec4 (depthMapCoords.xy, directionalLightCount + spotLightCount + 6 * pointLightIdx + faceIndex, depthMapCoords.z));
+    return SampleShadowTile (vPointLightTile[faceIndex + 6 * pointLightIdx], depthMapCoords, 0.0);
 }
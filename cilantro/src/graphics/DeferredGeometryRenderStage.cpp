@@ -4,6 +4,7 @@
 #include "scene/GameObject.h"
 #include "scene/MeshObject.h"
 #include <string>
+#include <vector>
 
 namespace cilantro {
 
@@ -30,7 +31,16 @@ void DeferredGeometryRenderStage::InitializeFramebuffer ()
 {
     if (m_isFramebufferEnabled)
     {
-        m_framebuffer = GetRenderer ()->CreateFramebuffer (GetRenderer ()->GetWidth (), GetRenderer ()->GetHeight (), 0, 5, 0, true, m_isMultisampleEnabled);
+        // compact g-buffer: octahedral normal, albedo (diffuse), metallic-roughness-AO (specular and shininess), emissive
+        // position is reconstructed from depth, so depth and stencil are kept in a texture
+        std::vector<EFramebufferTextureFormat> formats {
+            EFramebufferTextureFormat::FORMAT_RG16,
+            EFramebufferTextureFormat::FORMAT_RGBA8,
+            EFramebufferTextureFormat::FORMAT_RGBA8,
+            EFramebufferTextureFormat::FORMAT_RGBA8
+        };
+
+        m_framebuffer = GetRenderer ()->CreateFramebuffer (GetRenderer ()->GetWidth (), GetRenderer ()->GetHeight (), formats, true, m_isMultisampleEnabled);
     }
 }
 
@@ -47,19 +57,22 @@ void DeferredGeometryRenderStage::OnFrame ()
 
     GetRenderer ()->SetStencilTestOperation (EStencilTestOperation::OP_KEEP, EStencilTestOperation::OP_KEEP, EStencilTestOperation::OP_REPLACE);
 
-    for (auto gameObject : GetRenderer ()->GetGameScene ()->GetGameObjectManager ())
+    GetRenderer ()->BeginDrawBatch ();
+
+    for (handle_t objectHandle : GetRenderer ()->GetVisibleObjects ())
     {
-        // overwrite stencil value with material Id
-        if (auto meshObject = dynamic_pointer_cast<MeshObject>(gameObject))
-        {
-            GetRenderer ()->SetStencilTestFunction (EStencilTestFunction::FUNCTION_ALWAYS, (int) GetRenderer ()->GetShaderProgramManager ()->GetByName<ShaderProgram>(meshObject->GetMaterial ()->GetDeferredLightingPassShaderProgram ())->GetHandle ());
-        }
+        // queue draw to g-buffer (objects visible from active camera)
+        GetRenderer ()->GetGameScene ()->GetGameObjectManager ()->GetByHandle<GameObject> (objectHandle)->OnDraw (*(m_renderer.lock ()));
+    }
 
-        // draw to g-buffer
-        gameObject->OnDraw (*(m_renderer.lock ()));
+    // submit sorted draws, grouped by stencil value (lighting shader handle)
+    GetRenderer ()->EndDrawBatch ();
 
+    // resolve multisample g-buffer or copy depth, lighting stages sample it while g-buffer depth and stencil is attached
+    if (m_framebuffer != nullptr)
+    {
+        m_framebuffer->BlitFramebuffer ();
     }
- 
 }
 
 
@@ -2,11 +2,13 @@
 #include "graphics/IRenderer.h"
 #include "graphics/IFramebuffer.h"
 #include "graphics/ShaderProgram.h"
+#include "math/Vector2f.h"
 
 namespace cilantro {
 
 DeferredLightingRenderStage::DeferredLightingRenderStage (std::shared_ptr<IRenderer> renderer)
     : SurfaceRenderStage (renderer)
+    , m_lightVolumeShaderProgram (nullptr)
 {
 }
 
@@ -16,18 +18,70 @@ DeferredLightingRenderStage::~DeferredLightingRenderStage ()
 
 void DeferredLightingRenderStage::OnFrame ()
 {
+    bool isLightVolumes = GetRenderer ()->IsLightVolumes () && m_lightVolumeShaderProgram != nullptr;
+    Vector2f uvScale (GetRenderer ()->GetRenderScale (), GetRenderer ()->GetRenderScale ());
+
     m_shaderProgram->Use ();
 
+    // part of g-buffer written at current render scale
+    m_shaderProgram->SetUniformVector2f ("uvScale", uvScale);
+
     // set shadow map uniform (if shadow mapping is enabled)
     m_shaderProgram->SetUniformInt ("shadowMapEnabled", GetRenderer ()->IsShadowMapping () ? 1 : 0);
 
+    // full-screen pass shades only directional lights if point and spot lights are drawn as light volumes
+    m_shaderProgram->SetUniformInt ("lightVolumesEnabled", isLightVolumes ? 1 : 0);
+
+    if (isLightVolumes)
+    {
+        m_lightVolumeShaderProgram->Use ();
+        m_lightVolumeShaderProgram->SetUniformInt ("shadowMapEnabled", GetRenderer ()->IsShadowMapping () ? 1 : 0);
+        m_lightVolumeShaderProgram->SetUniformVector2f ("uvScale", uvScale);
+    }
+
     // bind shadow maps (if exist)
     if (m_linkedDepthTextureArrayFramebuffer != nullptr && m_linkedDepthTextureArrayFramebuffer->IsDepthTextureArrayEnabled ())
     {
         m_linkedDepthTextureArrayFramebuffer->BindFramebufferDepthTextureArrayAsColor (CILANTRO_SHADOW_MAP_BINDING);
     }
 
-    SurfaceRenderStage::OnFrame ();
+    // bind copy of g-buffer depth, fragment positions are reconstructed from it
+    // (g-buffer depth and stencil texture is attached for stencil test, so it is not sampled directly)
+    auto gBuffer = GetLinkedColorAttachmentsFramebuffer ();
+    if (gBuffer != nullptr && gBuffer->IsDepthStencilTextureEnabled ())
+    {
+        gBuffer->BindFramebufferDepthStencilTextureAsColor (CILANTRO_GBUFFER_DEPTH_BINDING);
+    }
+
+    if (!isLightVolumes)
+    {
+        SurfaceRenderStage::OnFrame ();
+
+        return;
+    }
+
+    RenderStage::OnFrame ();
+
+    // bind g-buffer textures and draw quad
+    m_shaderProgram->Use ();
+    m_linkedColorAttachmentsFramebuffer->BindFramebufferColorTexturesAsColor ();
+    GetRenderer ()->DrawSurface ();
+
+    // add contributions of point and spot lights (g-buffer textures stay bound)
+    GetRenderer ()->DrawLightVolumes (m_lightVolumeShaderProgram);
+
+    // blit framebuffer
+    if (m_framebuffer != nullptr)
+    {
+        m_framebuffer->BlitFramebuffer ();
+    }
+}
+
+std::shared_ptr<DeferredLightingRenderStage> DeferredLightingRenderStage::SetLightVolumeShaderProgram (const std::string& shaderProgramName)
+{
+    m_lightVolumeShaderProgram = GetRenderer ()->GetShaderProgramManager ()->GetByName<ShaderProgram> (shaderProgramName);
+
+    return std::dynamic_pointer_cast<DeferredLightingRenderStage> (shared_from_this ());
 }
 
 } // namespace cilantro
\ No newline at end of file
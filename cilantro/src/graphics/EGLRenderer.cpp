@@ -0,0 +1,217 @@
+#include "cilantroengine.h"
+#include "graphics/GLRenderer.h"
+#include "graphics/EGLRenderer.h"
+#include "graphics/IFramebuffer.h"
+#include "system/LogMessage.h"
+#include "EGL/eglext.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace cilantro {
+
+EGLRenderer::EGLRenderer (std::shared_ptr<GameScene> gameScene, unsigned int width, unsigned int height, bool shadowMappingEnabled, bool deferredRenderingEnabled)
+    : GLRenderer (gameScene, width, height, shadowMappingEnabled, deferredRenderingEnabled)
+    , m_display (EGL_NO_DISPLAY)
+    , m_context (EGL_NO_CONTEXT)
+    , m_surface (EGL_NO_SURFACE)
+    , m_offscreenFramebuffer (nullptr)
+{
+}
+
+EGLRenderer::~EGLRenderer ()
+{
+
+}
+
+void EGLRenderer::Initialize ()
+{
+    EGLint major;
+    EGLint minor;
+    EGLConfig config;
+    EGLint configCount = 0;
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+#ifdef CILANTRO_BUILDING_GLES
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+#else
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+#endif
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+
+    // initialize EGL
+    m_display = GetDisplay ();
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize (m_display, &major, &minor))
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "EGL unable to initialize display";
+    }
+
+    LogMessage (MSG_LOCATION) << "EGL version:" << std::to_string (major) + "." + std::to_string (minor) << eglQueryString (m_display, EGL_VENDOR);
+
+#ifdef CILANTRO_BUILDING_GLES
+    eglBindAPI (EGL_OPENGL_ES_API);
+#else
+    eglBindAPI (EGL_OPENGL_API);
+#endif
+
+    if (!eglChooseConfig (m_display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "EGL unable to find framebuffer configuration";
+    }
+
+    // create context
+    m_context = CreateContext (config);
+    if (m_context == EGL_NO_CONTEXT)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "EGL unable to create context";
+    }
+
+    // context without surface if supported, frames are rendered into offscreen framebuffer anyway
+    const char* extensions = eglQueryString (m_display, EGL_EXTENSIONS);
+    if (extensions == nullptr || std::strstr (extensions, "EGL_KHR_surfaceless_context") == nullptr)
+    {
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+
+        m_surface = eglCreatePbufferSurface (m_display, config, surfaceAttributes);
+        if (m_surface == EGL_NO_SURFACE)
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "EGL unable to create pbuffer surface";
+        }
+    }
+
+    // make openGL context active
+    if (!eglMakeCurrent (m_display, m_surface, m_surface, m_context))
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "EGL unable to make context current";
+    }
+
+    // load GL
+    if (!gladLoadGL (reinterpret_cast<GLADloadfunc> (eglGetProcAddress)))
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "GL context initialization failed";
+    }
+
+    glGetError ();
+
+    // created before render stages, which may draw to it
+    m_offscreenFramebuffer = CreateFramebuffer (m_width, m_height, { EFramebufferTextureFormat::FORMAT_RGBA8 }, true, false);
+
+    LogMessage (MSG_LOCATION) << "EGLRenderer started";
+
+    GLRenderer::Initialize ();
+}
+
+void EGLRenderer::Deinitialize ()
+{
+    GLRenderer::Deinitialize ();
+
+    if (m_offscreenFramebuffer != nullptr)
+    {
+        m_offscreenFramebuffer->Deinitialize ();
+        m_offscreenFramebuffer = nullptr;
+    }
+
+    eglMakeCurrent (m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (m_surface != EGL_NO_SURFACE)
+    {
+        eglDestroySurface (m_display, m_surface);
+    }
+
+    eglDestroyContext (m_display, m_context);
+    eglTerminate (m_display);
+}
+
+std::shared_ptr<IRenderer> EGLRenderer::SetResolution (unsigned int width, unsigned int height)
+{
+    if (m_offscreenFramebuffer != nullptr)
+    {
+        m_offscreenFramebuffer->SetFramebufferResolution (width, height);
+    }
+
+    return GLRenderer::SetResolution (width, height);
+}
+
+void EGLRenderer::RenderFrame ()
+{
+    GLRenderer::RenderFrame ();
+
+    // there is no swap to pace frames, wait for GPU instead (so that measured frame times include rendering)
+    glFinish ();
+}
+
+void EGLRenderer::BindDefaultFramebuffer ()
+{
+    m_offscreenFramebuffer->BindFramebuffer ();
+}
+
+std::shared_ptr<IFramebuffer> EGLRenderer::GetOffscreenFramebuffer () const
+{
+    return m_offscreenFramebuffer;
+}
+
+EGLDisplay EGLRenderer::GetDisplay () const
+{
+    // prefer Mesa's surfaceless platform, it needs neither display server nor GPU device (llvmpipe)
+    const char* clientExtensions = eglQueryString (EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions != nullptr && std::strstr (clientExtensions, "EGL_MESA_platform_surfaceless") != nullptr)
+    {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC> (eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay != nullptr)
+        {
+            EGLDisplay display = getPlatformDisplay (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY)
+            {
+                return display;
+            }
+        }
+    }
+
+    return eglGetDisplay (EGL_DEFAULT_DISPLAY);
+}
+
+EGLContext EGLRenderer::CreateContext (EGLConfig config) const
+{
+#ifdef CILANTRO_BUILDING_GLES
+    std::vector<std::pair<int,int>> candidates = {
+        {3,2},{3,1},{3,0}
+    };
+#else
+    std::vector<std::pair<int,int>> candidates = {
+        {4,6},{4,5},{4,4},{4,3},{4,2},{4,1},{4,0},
+        {3,3},{3,2}
+    };
+#endif
+
+    // highest supported version
+    for (auto [maj, min] : candidates)
+    {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, maj,
+            EGL_CONTEXT_MINOR_VERSION, min,
+#ifndef CILANTRO_BUILDING_GLES
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE,
+#endif
+            EGL_NONE
+        };
+
+        EGLContext context = eglCreateContext (m_display, config, EGL_NO_CONTEXT, contextAttributes);
+        if (context != EGL_NO_CONTEXT)
+        {
+            LogMessage (MSG_LOCATION) << "OpenGL version found:" << std::to_string (maj) + "." + std::to_string (min);
+            return context;
+        }
+    }
+
+    return EGL_NO_CONTEXT;
+}
+
+} // namespace cilantro
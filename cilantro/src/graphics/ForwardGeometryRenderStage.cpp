@@ -40,12 +40,16 @@ void ForwardGeometryRenderStage::OnFrame ()
     // load uniform buffers
     GetRenderer ()->UpdateCameraBuffers (GetRenderer ()->GetGameScene ()->GetActiveCamera ());
 
-    // draw all objects in scene
-    for (auto gameObject : GetRenderer ()->GetGameScene ()->GetGameObjectManager ())
+    // queue objects visible from active camera, sorted draws are submitted at the end
+    GetRenderer ()->BeginDrawBatch ();
+
+    for (handle_t objectHandle : GetRenderer ()->GetVisibleObjects ())
     {
-        gameObject->OnDraw (*(m_renderer.lock ()));
+        GetRenderer ()->GetGameScene ()->GetGameObjectManager ()->GetByHandle<GameObject> (objectHandle)->OnDraw (*(m_renderer.lock ()));
     }
 
+    GetRenderer ()->EndDrawBatch ();
+
     if (m_framebuffer != nullptr)
     {
         m_framebuffer->BlitFramebuffer ();
@@ -1,20 +1,38 @@
 #include "graphics/Framebuffer.h"
 #include "system/LogMessage.h"
+#include <algorithm>
 
 namespace cilantro {
 
 Framebuffer::Framebuffer (unsigned int bufferWidth, unsigned int bufferHeight, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayLayerCount, bool depthStencilRenderbufferEnabled)
-    : m_bufferWidth (bufferWidth)
+    : m_depthBufferArrayLayerCount (depthBufferArrayLayerCount)
+    , m_bufferWidth (bufferWidth)
     , m_bufferHeight (bufferHeight)
-    , m_rgbTextureCount (rgbTextureCount)
-    , m_rgbaTextureCount (rgbaTextureCount)
-    , m_depthBufferArrayLayerCount (depthBufferArrayLayerCount)
     , m_depthStencilRenderbufferEnabled (depthStencilRenderbufferEnabled)
+    , m_depthStencilTextureEnabled (false)
 {
     if (depthBufferArrayLayerCount > 0 && depthStencilRenderbufferEnabled)
     {
         LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Framebuffer should have either depth texture or renderbuffer";
     }
+
+    // rgb textures come first
+    m_colorTextureFormats.insert (m_colorTextureFormats.end (), rgbTextureCount, EFramebufferTextureFormat::FORMAT_RGB16F);
+    m_colorTextureFormats.insert (m_colorTextureFormats.end (), rgbaTextureCount, EFramebufferTextureFormat::FORMAT_RGBA16F);
+}
+
+Framebuffer::Framebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled)
+    : m_colorTextureFormats (colorTextureFormats)
+    , m_depthBufferArrayLayerCount (0)
+    , m_bufferWidth (bufferWidth)
+    , m_bufferHeight (bufferHeight)
+    , m_depthStencilRenderbufferEnabled (false)
+    , m_depthStencilTextureEnabled (depthStencilTextureEnabled)
+{
+    if (colorTextureFormats.size () > CILANTRO_MAX_FRAMEBUFFER_TEXTURES)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Too many framebuffer color textures" << colorTextureFormats.size ();
+    }
 }
 
 unsigned int Framebuffer::GetWidth () const
@@ -29,17 +47,17 @@ unsigned int Framebuffer::GetHeight () const
 
 unsigned int Framebuffer::GetColorTextureCount () const
 {
-    return m_rgbTextureCount + m_rgbaTextureCount;
+    return static_cast<unsigned int> (m_colorTextureFormats.size ());
 }
 
 unsigned int Framebuffer::GetRGBTextureCount () const
 {
-    return m_rgbTextureCount;
+    return static_cast<unsigned int> (std::count (m_colorTextureFormats.begin (), m_colorTextureFormats.end (), EFramebufferTextureFormat::FORMAT_RGB16F));
 }
 
 unsigned int Framebuffer::GetRGBATextureCount () const
 {
-    return m_rgbaTextureCount;
+    return static_cast<unsigned int> (std::count (m_colorTextureFormats.begin (), m_colorTextureFormats.end (), EFramebufferTextureFormat::FORMAT_RGBA16F));
 }
 
 unsigned int Framebuffer::GetDepthArrayLayerCount () const
@@ -47,6 +65,11 @@ unsigned int Framebuffer::GetDepthArrayLayerCount () const
     return m_depthBufferArrayLayerCount;
 }
 
+const std::vector<EFramebufferTextureFormat>& Framebuffer::GetColorTextureFormats () const
+{
+    return m_colorTextureFormats;
+}
+
 bool Framebuffer::IsDepthStencilRenderbufferEnabled () const
 {
     return m_depthStencilRenderbufferEnabled;
@@ -57,6 +80,11 @@ bool Framebuffer::IsDepthTextureArrayEnabled () const
     return (m_depthBufferArrayLayerCount > 0);
 }
 
+bool Framebuffer::IsDepthStencilTextureEnabled () const
+{
+    return m_depthStencilTextureEnabled;
+}
+
 void Framebuffer::SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight)
 {
     m_bufferWidth = bufferWidth;
@@ -6,6 +6,18 @@ namespace cilantro {
 
 GLFramebuffer::GLFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, unsigned int rgbTextureCount, unsigned int rgbaTextureCount, unsigned int depthBufferArrayLayerCount, bool depthStencilRenderbufferEnabled) 
     : Framebuffer (bufferWidth, bufferHeight, rgbTextureCount, rgbaTextureCount, depthBufferArrayLayerCount, depthStencilRenderbufferEnabled)
+    , m_depthStencilCopyEnabled (true)
+{
+    for (unsigned int i = 0; i < CILANTRO_MAX_FRAMEBUFFER_TEXTURES; ++i)
+    {
+        m_glBuffers.colorAttachments[i] = static_cast <GLuint> (GL_COLOR_ATTACHMENT0 + i);
+    }
+    m_glBuffers.colorNone = GL_NONE;
+}
+
+GLFramebuffer::GLFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled)
+    : Framebuffer (bufferWidth, bufferHeight, colorTextureFormats, depthStencilTextureEnabled)
+    , m_depthStencilCopyEnabled (true)
 {
     for (unsigned int i = 0; i < CILANTRO_MAX_FRAMEBUFFER_TEXTURES; ++i)
     {
@@ -23,22 +35,28 @@ void GLFramebuffer::Initialize ()
     glBindFramebuffer (GL_FRAMEBUFFER, m_glBuffers.FBO);
 
     // create textures and attach to framebuffer as color attachments
-    glGenTextures (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glBuffers.textureBuffer);
-    for (unsigned int i = 0; i < m_rgbTextureCount + m_rgbaTextureCount; i++)
+    glGenTextures (static_cast<GLsizei> (GetColorTextureCount ()), m_glBuffers.textureBuffer);
+    for (unsigned int i = 0; i < GetColorTextureCount (); i++)
     {
+        GLenum internalFormat, pixelFormat, type;
+        GetGLTextureFormat (m_colorTextureFormats[i], internalFormat, pixelFormat, type);
+
         glBindTexture (GL_TEXTURE_2D, m_glBuffers.textureBuffer[i]);
-        glTexImage2D (GL_TEXTURE_2D, 0, (i < m_rgbTextureCount) ? GL_RGB16F : GL_RGBA16F, m_bufferWidth, m_bufferHeight, 0, (i < m_rgbTextureCount) ? GL_RGB : GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D (GL_TEXTURE_2D, 0, internalFormat, m_bufferWidth, m_bufferHeight, 0, pixelFormat, type, nullptr);
+
+        // color buffers are filtered, so that image rendered at lower resolution is upscaled smoothly (g-buffer data is not)
+        GLint filter = (type == GL_FLOAT) ? GL_LINEAR : GL_NEAREST;
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
         glBindTexture (GL_TEXTURE_2D, 0);
      
         glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, m_glBuffers.textureBuffer[i], 0);
     }
 
     // specify color buffers to draw to
-    if (m_rgbTextureCount + m_rgbaTextureCount > 0)
+    if (GetColorTextureCount () > 0)
     {
-        glDrawBuffers (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glBuffers.colorAttachments);
+        glDrawBuffers (static_cast<GLsizei> (GetColorTextureCount ()), m_glBuffers.colorAttachments);
     }
     else
     {
@@ -76,6 +94,18 @@ void GLFramebuffer::Initialize ()
 
         glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_glBuffers.RBO);
     }
+    else if (m_depthStencilTextureEnabled)
+    {
+        // create (combined) depth and stencil texture, depth is sampled to reconstruct positions from g-buffer
+        glGenTextures (1, &m_glBuffers.depthStencilTexture);
+        glBindTexture (GL_TEXTURE_2D, m_glBuffers.depthStencilTexture);
+        glTexImage2D (GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_bufferWidth, m_bufferHeight, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture (GL_TEXTURE_2D, 0);
+
+        glFramebufferTexture2D (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_glBuffers.depthStencilTexture, 0);
+    }
 
     // check status
     if ((fbStatus = glCheckFramebufferStatus (GL_FRAMEBUFFER)) != GL_FRAMEBUFFER_COMPLETE)
@@ -103,13 +133,46 @@ void GLFramebuffer::Initialize ()
     {
         LogMessage (MSG_LOCATION) << "Initialized framebuffer" << m_bufferWidth << m_bufferHeight;
     }
+
+    if (m_depthStencilTextureEnabled && m_depthStencilCopyEnabled)
+    {
+        // create copy of depth and stencil texture (same format, as required by blit) and framebuffer to blit into
+        glGenTextures (1, &m_glBuffers.depthStencilCopyTexture);
+        glBindTexture (GL_TEXTURE_2D, m_glBuffers.depthStencilCopyTexture);
+        glTexImage2D (GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_bufferWidth, m_bufferHeight, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture (GL_TEXTURE_2D, 0);
+
+        glGenFramebuffers (1, &m_glBuffers.depthStencilCopyFBO);
+        glBindFramebuffer (GL_FRAMEBUFFER, m_glBuffers.depthStencilCopyFBO);
+        glFramebufferTexture2D (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_glBuffers.depthStencilCopyTexture, 0);
+        glDrawBuffer (GL_NONE);
+        glReadBuffer (GL_NONE);
+
+        if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Depth and stencil copy framebuffer is not complete";
+        }
+
+        glBindFramebuffer (GL_FRAMEBUFFER, m_glBuffers.FBO);
+    }
 }
 
 void GLFramebuffer::Deinitialize ()
 {
     glDeleteRenderbuffers (1, &m_glBuffers.RBO);
-    glDeleteTextures (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glBuffers.textureBuffer);
+    glDeleteTextures (static_cast<GLsizei> (GetColorTextureCount ()), m_glBuffers.textureBuffer);
     glDeleteTextures (1, &m_glBuffers.depthTextureArray);
+    if (m_depthStencilTextureEnabled)
+    {
+        glDeleteTextures (1, &m_glBuffers.depthStencilTexture);
+        if (m_depthStencilCopyEnabled)
+        {
+            glDeleteTextures (1, &m_glBuffers.depthStencilCopyTexture);
+            glDeleteFramebuffers (1, &m_glBuffers.depthStencilCopyFBO);
+        }
+    }
     glDeleteFramebuffers (1, &m_glBuffers.FBO);
 }
 
@@ -143,11 +206,36 @@ void GLFramebuffer::BindFramebufferRenderbuffer () const
     glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, GetFramebufferRenderbufferGLId ());
 }
 
+void GLFramebuffer::BindFramebufferDepthStencilTextureAsColor (unsigned int index) const
+{
+    // sample the copy, the texture itself may be attached to framebuffer being drawn to
+    glActiveTexture (static_cast<GLenum> (GL_TEXTURE0 + index));
+    glBindTexture (GL_TEXTURE_2D, m_depthStencilCopyEnabled ? m_glBuffers.depthStencilCopyTexture : m_glBuffers.depthStencilTexture);
+}
+
+void GLFramebuffer::BindFramebufferDepthStencilTextureAsDepthStencil () const
+{
+    glFramebufferTexture2D (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_glBuffers.depthStencilTexture, 0);
+}
+
 void GLFramebuffer::UnbindFramebuffer () const
 {
     glBindFramebuffer (GL_FRAMEBUFFER, (GLint) 0);
 }
 
+void GLFramebuffer::BlitFramebuffer () const
+{
+    // copy depth to texture sampled by later stages
+    if (m_depthStencilTextureEnabled && m_depthStencilCopyEnabled)
+    {
+        glBindFramebuffer (GL_READ_FRAMEBUFFER, m_glBuffers.FBO);
+        glBindFramebuffer (GL_DRAW_FRAMEBUFFER, m_glBuffers.depthStencilCopyFBO);
+        glBlitFramebuffer (0, 0, m_bufferWidth, m_bufferHeight, 0, 0, m_bufferWidth, m_bufferHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer (GL_READ_FRAMEBUFFER, 0);
+        glBindFramebuffer (GL_DRAW_FRAMEBUFFER, 0);
+    }
+}
+
 void GLFramebuffer::SetFramebufferResolution (unsigned int bufferWidth, unsigned int bufferHeight)
 {
     // resize framebuffer texture and viewport
@@ -171,5 +259,32 @@ GLuint GLFramebuffer::GetFramebufferGLId () const
     return m_glBuffers.FBO;
 }
 
+void GLFramebuffer::GetGLTextureFormat (EFramebufferTextureFormat format, GLenum& internalFormat, GLenum& pixelFormat, GLenum& type)
+{
+    switch (format)
+    {
+        case EFramebufferTextureFormat::FORMAT_RGB16F:
+            internalFormat = GL_RGB16F;
+            pixelFormat = GL_RGB;
+            type = GL_FLOAT;
+            break;
+        case EFramebufferTextureFormat::FORMAT_RGBA16F:
+            internalFormat = GL_RGBA16F;
+            pixelFormat = GL_RGBA;
+            type = GL_FLOAT;
+            break;
+        case EFramebufferTextureFormat::FORMAT_RG16:
+            internalFormat = GL_RG16;
+            pixelFormat = GL_RG;
+            type = GL_UNSIGNED_SHORT;
+            break;
+        case EFramebufferTextureFormat::FORMAT_RGBA8:
+            internalFormat = GL_RGBA8;
+            pixelFormat = GL_RGBA;
+            type = GL_UNSIGNED_BYTE;
+            break;
+    }
+}
+
 } // namespace cilantro
 
@@ -0,0 +1,247 @@
+#include "cilantroengine.h"
+#include "graphics/GLGeometryPool.h"
+#include "graphics/GLRenderer.h"
+#include "graphics/GLUtils.h"
+#include "system/LogMessage.h"
+#include <cstddef>
+
+namespace cilantro {
+
+GLGeometryPool::GLGeometryPool (size_t vertexCapacity, size_t indexCapacity)
+    : m_VAO (0)
+    , m_VBO (0)
+    , m_EBO (0)
+    , m_vertexCapacity (vertexCapacity)
+    , m_indexCapacity (indexCapacity)
+{
+}
+
+GLGeometryPool::~GLGeometryPool ()
+{
+}
+
+void GLGeometryPool::Initialize ()
+{
+    // whole pool is initially free
+    m_freeVertexRanges.clear ();
+    m_freeIndexRanges.clear ();
+    m_freeVertexRanges.insert ({ 0, m_vertexCapacity });
+    m_freeIndexRanges.insert ({ 0, m_indexCapacity });
+
+    // generate shared vertex and index buffers
+    glGenBuffers (1, &m_VBO);
+    glBindBuffer (GL_ARRAY_BUFFER, m_VBO);
+    glBufferData (GL_ARRAY_BUFFER, m_vertexCapacity * sizeof (SGlVertex), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer (GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers (1, &m_EBO);
+    glBindBuffer (GL_COPY_WRITE_BUFFER, m_EBO);
+    glBufferData (GL_COPY_WRITE_BUFFER, m_indexCapacity * sizeof (GLuint), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer (GL_COPY_WRITE_BUFFER, 0);
+
+    // generate shared Vertex Array Object
+    glGenVertexArrays (1, &m_VAO);
+    InitializeVertexArray ();
+
+    GLUtils::CheckGLError (MSG_LOCATION);
+}
+
+void GLGeometryPool::Deinitialize ()
+{
+    glDeleteVertexArrays (1, &m_VAO);
+    glDeleteBuffers (1, &m_VBO);
+    glDeleteBuffers (1, &m_EBO);
+}
+
+SGlGeometryAllocation GLGeometryPool::Allocate (size_t vertexCount, size_t indexCount)
+{
+    SGlGeometryAllocation allocation = { 0, 0, static_cast<GLuint> (vertexCount), static_cast<GLuint> (indexCount) };
+    size_t offset;
+
+    if (vertexCount > 0)
+    {
+        if (!AllocateRange (m_freeVertexRanges, vertexCount, offset))
+        {
+            GrowBuffer (m_VBO, m_vertexCapacity, sizeof (SGlVertex), vertexCount, m_freeVertexRanges);
+            AllocateRange (m_freeVertexRanges, vertexCount, offset);
+        }
+
+        allocation.baseVertex = static_cast<GLint> (offset);
+    }
+
+    if (indexCount > 0)
+    {
+        if (!AllocateRange (m_freeIndexRanges, indexCount, offset))
+        {
+            GrowBuffer (m_EBO, m_indexCapacity, sizeof (GLuint), indexCount, m_freeIndexRanges);
+            AllocateRange (m_freeIndexRanges, indexCount, offset);
+        }
+
+        allocation.firstIndex = static_cast<GLuint> (offset);
+    }
+
+    return allocation;
+}
+
+void GLGeometryPool::Free (const SGlGeometryAllocation& allocation)
+{
+    if (allocation.vertexCount > 0)
+    {
+        FreeRange (m_freeVertexRanges, static_cast<size_t> (allocation.baseVertex), allocation.vertexCount);
+    }
+
+    if (allocation.indexCount > 0)
+    {
+        FreeRange (m_freeIndexRanges, allocation.firstIndex, allocation.indexCount);
+    }
+}
+
+void GLGeometryPool::Load (const SGlGeometryAllocation& allocation, const SGlVertex* vertices, const GLuint* indices)
+{
+    // use copy target, so that element array binding of currently bound VAO is not affected
+    if (allocation.vertexCount > 0)
+    {
+        glBindBuffer (GL_COPY_WRITE_BUFFER, m_VBO);
+        glBufferSubData (GL_COPY_WRITE_BUFFER, allocation.baseVertex * sizeof (SGlVertex), allocation.vertexCount * sizeof (SGlVertex), vertices);
+    }
+
+    if (allocation.indexCount > 0)
+    {
+        glBindBuffer (GL_COPY_WRITE_BUFFER, m_EBO);
+        glBufferSubData (GL_COPY_WRITE_BUFFER, allocation.firstIndex * sizeof (GLuint), allocation.indexCount * sizeof (GLuint), indices);
+    }
+
+    glBindBuffer (GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GLGeometryPool::Bind () const
+{
+    glBindVertexArray (m_VAO);
+}
+
+void GLGeometryPool::Unbind () const
+{
+    glBindVertexArray (0);
+}
+
+GLuint GLGeometryPool::GetVertexArrayGLId () const
+{
+    return m_VAO;
+}
+
+void GLGeometryPool::InitializeVertexArray ()
+{
+    glBindVertexArray (m_VAO);
+    glBindBuffer (GL_ARRAY_BUFFER, m_VBO);
+
+    // location = 0 (vertex position)
+    glVertexAttribPointer (EGlVBOType::VBO_VERTICES, 3, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, position));
+    // location = 1 (vertex normal)
+    glVertexAttribPointer (EGlVBOType::VBO_NORMALS, 3, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, normal));
+    // location = 2 (vertex uv)
+    glVertexAttribPointer (EGlVBOType::VBO_UVS, 2, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, uv));
+    // location = 3 (vertex tangent)
+    glVertexAttribPointer (EGlVBOType::VBO_TANGENTS, 3, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, tangent));
+    // location = 4 (vertex bitangent)
+    glVertexAttribPointer (EGlVBOType::VBO_BITANGENTS, 3, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, bitangent));
+    // location = 5 (bone indices)
+    glVertexAttribIPointer (EGlVBOType::VBO_BONES, CILANTRO_MAX_BONE_INFLUENCES, GL_INT, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, boneIndices));
+    // location = 6 (bone weights)
+    glVertexAttribPointer (EGlVBOType::VBO_BONEWEIGHTS, CILANTRO_MAX_BONE_INFLUENCES, GL_FLOAT, GL_FALSE, sizeof (SGlVertex), (GLvoid*) offsetof (SGlVertex, boneWeights));
+
+    // enable VBO arrays
+    glEnableVertexAttribArray (EGlVBOType::VBO_VERTICES);
+    glEnableVertexAttribArray (EGlVBOType::VBO_NORMALS);
+    glEnableVertexAttribArray (EGlVBOType::VBO_UVS);
+    glEnableVertexAttribArray (EGlVBOType::VBO_TANGENTS);
+    glEnableVertexAttribArray (EGlVBOType::VBO_BITANGENTS);
+    glEnableVertexAttribArray (EGlVBOType::VBO_BONES);
+    glEnableVertexAttribArray (EGlVBOType::VBO_BONEWEIGHTS);
+
+    // index buffer binding is part of VAO state
+    glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+    glBindVertexArray (0);
+    glBindBuffer (GL_ARRAY_BUFFER, 0);
+}
+
+void GLGeometryPool::GrowBuffer (GLuint& buffer, size_t& capacity, size_t elementSize, size_t requiredCount, TGeometryPoolFreeRanges& freeRanges)
+{
+    size_t newCapacity = capacity;
+    GLuint newBuffer;
+
+    while (newCapacity - capacity < requiredCount)
+    {
+        newCapacity *= 2;
+    }
+
+    // copy contents to new buffer
+    glGenBuffers (1, &newBuffer);
+    glBindBuffer (GL_COPY_READ_BUFFER, buffer);
+    glBindBuffer (GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData (GL_COPY_WRITE_BUFFER, newCapacity * elementSize, NULL, GL_DYNAMIC_DRAW);
+    glCopyBufferSubData (GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity * elementSize);
+    glBindBuffer (GL_COPY_READ_BUFFER, 0);
+    glBindBuffer (GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers (1, &buffer);
+
+    // append new space to free ranges
+    FreeRange (freeRanges, capacity, newCapacity - capacity);
+
+    buffer = newBuffer;
+    capacity = newCapacity;
+
+    // point VAO to new buffers
+    InitializeVertexArray ();
+
+    LogMessage () << "Geometry pool buffer resized to" << newCapacity << "elements";
+}
+
+bool GLGeometryPool::AllocateRange (TGeometryPoolFreeRanges& freeRanges, size_t count, size_t& offset)
+{
+    // first fit
+    for (auto it = freeRanges.begin (); it != freeRanges.end (); ++it)
+    {
+        if (it->second >= count)
+        {
+            offset = it->first;
+
+            if (it->second > count)
+            {
+                freeRanges.insert ({ it->first + count, it->second - count });
+            }
+
+            freeRanges.erase (it);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GLGeometryPool::FreeRange (TGeometryPoolFreeRanges& freeRanges, size_t offset, size_t count)
+{
+    auto it = freeRanges.insert ({ offset, count }).first;
+
+    // merge with following range
+    auto next = std::next (it);
+    if (next != freeRanges.end () && it->first + it->second == next->first)
+    {
+        it->second += next->second;
+        freeRanges.erase (next);
+    }
+
+    // merge with preceding range
+    if (it != freeRanges.begin ())
+    {
+        auto prev = std::prev (it);
+        if (prev->first + prev->second == it->first)
+        {
+            prev->second += it->second;
+            freeRanges.erase (it);
+        }
+    }
+}
+
+} // namespace cilantro
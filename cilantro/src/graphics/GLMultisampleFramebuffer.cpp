@@ -11,6 +11,22 @@ GLMultisampleFramebuffer::GLMultisampleFramebuffer (unsigned int bufferWidth, un
         m_glMultisampleBuffers.colorAttachments[i] = static_cast <GLuint> (GL_COLOR_ATTACHMENT0 + i);
     }
     m_glMultisampleBuffers.colorNone = GL_NONE;
+
+    // multisample depth and stencil is resolved into a separate texture, which is sampled instead
+    m_depthStencilCopyEnabled = false;
+}
+
+GLMultisampleFramebuffer::GLMultisampleFramebuffer (unsigned int bufferWidth, unsigned int bufferHeight, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled)
+    : GLFramebuffer (bufferWidth, bufferHeight, colorTextureFormats, depthStencilTextureEnabled)
+{
+    for (unsigned int i = 0; i < CILANTRO_MAX_FRAMEBUFFER_TEXTURES; ++i)
+    {
+        m_glMultisampleBuffers.colorAttachments[i] = static_cast <GLuint> (GL_COLOR_ATTACHMENT0 + i);
+    }
+    m_glMultisampleBuffers.colorNone = GL_NONE;
+
+    // multisample depth and stencil is resolved into a separate texture, which is sampled instead
+    m_depthStencilCopyEnabled = false;
 }
 
 void GLMultisampleFramebuffer::Initialize ()
@@ -24,20 +40,23 @@ void GLMultisampleFramebuffer::Initialize ()
     glBindFramebuffer (GL_FRAMEBUFFER, m_glMultisampleBuffers.FBO);
 
     // create texture and attach to framebuffer as color attachment
-    glGenTextures (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glMultisampleBuffers.textureBuffer);
-    for (unsigned int i = 0; i < m_rgbTextureCount + m_rgbaTextureCount; i++)
+    glGenTextures (static_cast<GLsizei> (GetColorTextureCount ()), m_glMultisampleBuffers.textureBuffer);
+    for (unsigned int i = 0; i < GetColorTextureCount (); i++)
     {
+        GLenum internalFormat, pixelFormat, type;
+        GetGLTextureFormat (m_colorTextureFormats[i], internalFormat, pixelFormat, type);
+
         glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, m_glMultisampleBuffers.textureBuffer[i]);
-        glTexImage2DMultisample (GL_TEXTURE_2D_MULTISAMPLE, CILANTRO_MULTISAMPLE, (i < m_rgbTextureCount) ? GL_RGB16F : GL_RGBA16F, m_bufferWidth, m_bufferHeight, GL_TRUE);
+        glTexImage2DMultisample (GL_TEXTURE_2D_MULTISAMPLE, CILANTRO_MULTISAMPLE, internalFormat, m_bufferWidth, m_bufferHeight, GL_TRUE);
         glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, 0);
 
         glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D_MULTISAMPLE, m_glMultisampleBuffers.textureBuffer[i], 0);
     }
 
     // specify color buffers to draw to
-    if (m_rgbTextureCount + m_rgbaTextureCount > 0)
+    if (GetColorTextureCount () > 0)
     {
-        glDrawBuffers (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glMultisampleBuffers.colorAttachments);
+        glDrawBuffers (static_cast<GLsizei> (GetColorTextureCount ()), m_glMultisampleBuffers.colorAttachments);
     }
     else
     {
@@ -75,6 +94,16 @@ void GLMultisampleFramebuffer::Initialize ()
     
         glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_glMultisampleBuffers.RBO);
     }
+    else if (m_depthStencilTextureEnabled)
+    {
+        // create multisample depth and stencil texture, resolved into texture of standard framebuffer by blit
+        glGenTextures (1, &m_glMultisampleBuffers.depthStencilTexture);
+        glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, m_glMultisampleBuffers.depthStencilTexture);
+        glTexImage2DMultisample (GL_TEXTURE_2D_MULTISAMPLE, CILANTRO_MULTISAMPLE, GL_DEPTH24_STENCIL8, m_bufferWidth, m_bufferHeight, GL_TRUE);
+        glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, 0);
+
+        glFramebufferTexture2D (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, m_glMultisampleBuffers.depthStencilTexture, 0);
+    }
 
     // check status
     if ((fbStatus = glCheckFramebufferStatus (GL_FRAMEBUFFER)) != GL_FRAMEBUFFER_COMPLETE)
@@ -108,7 +137,11 @@ void GLMultisampleFramebuffer::Initialize ()
 void GLMultisampleFramebuffer::Deinitialize ()
 {
     glDeleteRenderbuffers (1, &m_glMultisampleBuffers.RBO);
-    glDeleteTextures (static_cast<GLsizei> (m_rgbTextureCount + m_rgbaTextureCount), m_glMultisampleBuffers.textureBuffer);
+    glDeleteTextures (static_cast<GLsizei> (GetColorTextureCount ()), m_glMultisampleBuffers.textureBuffer);
+    if (m_depthStencilTextureEnabled)
+    {
+        glDeleteTextures (1, &m_glMultisampleBuffers.depthStencilTexture);
+    }
     glDeleteFramebuffers (1, &m_glMultisampleBuffers.FBO);
 
     GLFramebuffer::Deinitialize ();
@@ -119,6 +152,11 @@ void GLMultisampleFramebuffer::BindFramebuffer () const
     glBindFramebuffer (GL_FRAMEBUFFER, m_glMultisampleBuffers.FBO);
 }
 
+void GLMultisampleFramebuffer::BindFramebufferDepthStencilTextureAsDepthStencil () const
+{
+    glFramebufferTexture2D (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D_MULTISAMPLE, m_glMultisampleBuffers.depthStencilTexture, 0);
+}
+
 void GLMultisampleFramebuffer::BlitFramebuffer () const
 {
     // blit multisample framebuffer to standard framebuffer
@@ -0,0 +1,198 @@
+#include "cilantroengine.h"
+#include "graphics/GLProgramBinaryCache.h"
+#include "graphics/GLUtils.h"
+#include "system/LogMessage.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace cilantro {
+
+// header of cache entry, followed by binary of program
+struct SProgramBinaryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t programKey;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+static constexpr uint32_t PROGRAM_BINARY_MAGIC = 0x42504c43; // "CLPB"
+static constexpr uint32_t PROGRAM_BINARY_VERSION = 1;
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+GLProgramBinaryCache::GLProgramBinaryCache (const std::string& directory)
+    : m_directory (directory)
+    , m_isEnabled (false)
+    , m_driverKey (FNV_OFFSET_BASIS)
+{
+}
+
+GLProgramBinaryCache::~GLProgramBinaryCache ()
+{
+}
+
+void GLProgramBinaryCache::Initialize ()
+{
+    GLint formatCount = 0;
+
+    // program binaries are core since OpenGL 4.1
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 410)
+    {
+        glGetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+
+    m_isEnabled = formatCount > 0;
+
+    if (!m_isEnabled)
+    {
+        LogMessage (MSG_LOCATION) << "Program binaries not supported, shader cache disabled";
+        return;
+    }
+
+    // binaries are valid only for the driver which produced them
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION })
+    {
+        const GLubyte* value = glGetString (name);
+        if (value != nullptr)
+        {
+            m_driverKey = Hash (std::string (reinterpret_cast<const char*> (value)), m_driverKey);
+        }
+    }
+}
+
+bool GLProgramBinaryCache::IsEnabled () const
+{
+    return m_isEnabled;
+}
+
+uint64_t GLProgramBinaryCache::GetDriverKey () const
+{
+    return m_driverKey;
+}
+
+bool GLProgramBinaryCache::Load (GLuint programId, uint64_t programKey) const
+{
+    SProgramBinaryHeader header;
+    std::vector<char> binary;
+    GLint success;
+
+    if (!m_isEnabled)
+    {
+        return false;
+    }
+
+    std::ifstream file (GetEntryPath (programKey), std::ios::binary);
+    if (!file.is_open ())
+    {
+        return false;
+    }
+
+    // validate entry
+    if (!file.read (reinterpret_cast<char*> (&header), sizeof (header))
+        || header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION || header.programKey != programKey)
+    {
+        return false;
+    }
+
+    binary.resize (header.binaryLength);
+    if (!file.read (binary.data (), header.binaryLength))
+    {
+        return false;
+    }
+
+    // driver may still reject binary (e.g. after update not reflected in version string)
+    glProgramBinary (programId, header.binaryFormat, binary.data (), static_cast<GLsizei> (header.binaryLength));
+    glGetProgramiv (programId, GL_LINK_STATUS, &success);
+
+    return success == GL_TRUE;
+}
+
+void GLProgramBinaryCache::Store (GLuint programId, uint64_t programKey) const
+{
+    SProgramBinaryHeader header;
+    std::vector<char> binary;
+    GLint length = 0;
+    GLenum format;
+    std::error_code error;
+
+    if (!m_isEnabled)
+    {
+        return;
+    }
+
+    glGetProgramiv (programId, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    binary.resize (length);
+    glGetProgramBinary (programId, length, &length, &format, binary.data ());
+
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.programKey = programKey;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t> (length);
+
+    std::filesystem::create_directories (m_directory, error);
+    if (error)
+    {
+        LogMessage (MSG_LOCATION) << "Unable to create shader cache directory" << m_directory;
+        return;
+    }
+
+    // write to temporary file first, so that interrupted writes never leave partial entries
+    std::string path = GetEntryPath (programKey);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file (tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write (reinterpret_cast<const char*> (&header), sizeof (header)) || !file.write (binary.data (), length))
+        {
+            LogMessage (MSG_LOCATION) << "Unable to write shader cache entry" << tempPath;
+            return;
+        }
+    }
+
+    std::filesystem::rename (tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove (tempPath, error);
+    }
+}
+
+uint64_t GLProgramBinaryCache::Hash (const void* data, size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*> (data);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint64_t GLProgramBinaryCache::Hash (const std::string& data, uint64_t hash)
+{
+    // length is hashed too, so that concatenated strings do not collide
+    uint64_t length = data.size ();
+    hash = Hash (&length, sizeof (length), hash);
+
+    return Hash (data.data (), data.size (), hash);
+}
+
+std::string GLProgramBinaryCache::GetEntryPath (uint64_t programKey) const
+{
+    char name[17];
+    std::snprintf (name, sizeof (name), "%016llx", static_cast<unsigned long long> (programKey));
+
+    return (std::filesystem::path (m_directory) / (std::string (name) + ".bin")).string ();
+}
+
+} // namespace cilantro
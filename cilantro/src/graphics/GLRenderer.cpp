@@ -16,27 +16,66 @@
 #include "math/Matrix4f.h"
 #include "scene/GameScene.h"
 #include "scene/MeshObject.h"
+#include "scene/InstancedMeshObject.h"
+#include "scene/BoneObject.h"
 #include "scene/Camera.h"
 #include "scene/PointLight.h"
 #include "scene/DirectionalLight.h"
 #include "scene/SpotLight.h"
+#include "system/Profiler.h"
 #include <cmath>
 #include <cstring>
 #include <array>
+#include <algorithm>
 #include <bit>
+#include <limits>
 
 namespace cilantro {
 
 GLRenderer::GLRenderer (std::shared_ptr<GameScene> gameScene, unsigned int width, unsigned int height, bool shadowMappingEnabled, bool deferredRenderingEnabled) 
     : Renderer (gameScene, width, height, shadowMappingEnabled, deferredRenderingEnabled)
+    , m_shadowAtlas (CILANTRO_SHADOW_MAP_SIZE, CILANTRO_SHADOW_MAP_MIN_TILE_SIZE)
 {
     m_surfaceGeometryBuffer = new SGlGeometryBuffers ();
+    m_sphereGeometryBuffer = new SGlGeometryBuffers ();
+    m_coneGeometryBuffer = new SGlGeometryBuffers ();
+    m_viewport[0] = m_viewport[1] = 0;
+    m_viewport[2] = static_cast<GLint> (width);
+    m_viewport[3] = static_cast<GLint> (height);
     m_uniformBuffers = new SGlUniformBuffers ();
+    m_isFrameTimerEnabled = false;
+    m_frameTimerIndex = 0;
+    m_gpuFrameTime = 0.0f;
+    m_gpuFrameRenderScale = 0.0f;
+    m_isGpuFrameTimeNew = false;
+    m_materialBlockStride = CILANTRO_MATERIAL_BLOCK_SIZE;
+    m_isDebugGroupEnabled = false;
+    m_programBinaryCache = std::make_shared<GLProgramBinaryCache> (CILANTRO_SHADER_CACHE_PATH);
+    m_boneTransformationsRingBuffer = new GLRingBuffer (GL_UNIFORM_BUFFER, CILANTRO_RING_BUFFER_REGION_SIZE, CILANTRO_BUFFERED_FRAMES);
+    m_geometryPool = new GLGeometryPool (CILANTRO_GEOMETRY_POOL_VERTICES, CILANTRO_GEOMETRY_POOL_INDICES);
+    m_objectTransformsRingBuffer = new GLRingBuffer (GL_SHADER_STORAGE_BUFFER, CILANTRO_RING_BUFFER_REGION_SIZE, CILANTRO_BUFFERED_FRAMES);
+    m_drawCommandsRingBuffer = new GLRingBuffer (GL_DRAW_INDIRECT_BUFFER, CILANTRO_RING_BUFFER_REGION_SIZE, CILANTRO_BUFFERED_FRAMES);
+    m_culledDrawCommandsBuffer = 0;
+    m_culledDrawCommandsBufferSize = 0;
+    m_drawCountBuffer = 0;
+    m_identityInstanceTransformBuffer = 0;
+    m_isDrawBatchActive = false;
     m_uniformMatrixBuffer = new SGlUniformMatrixBuffer ();
     m_uniformLightViewMatrixBuffer = new SGlUniformLightViewMatrixBuffer ();
     m_uniformPointLightBuffer = new SGlUniformPointLightBuffer ();
     m_uniformDirectionalLightBuffer = new SGlUniformDirectionalLightBuffer ();
     m_uniformSpotLightBuffer = new SGlUniformSpotLightBuffer ();
+    m_pointLightsBuffer = 0;
+    m_pointLightsBufferSize = 0;
+    m_spotLightsBuffer = 0;
+    m_spotLightsBufferSize = 0;
+    m_lightClustersBuffer = 0;
+    m_lightIndicesBuffer = 0;
+    m_lightIndicesBufferSize = 0;
+    m_shadowAtlasResolution = 0;
+    m_isShadowAtlasInvalid = true;
+    m_isShadowMapStale[0] = m_isShadowMapStale[1] = m_isShadowMapStale[2] = false;
+    m_drawnShadowCasterMasks = nullptr;
 }
 
 GLRenderer::~GLRenderer ()
@@ -46,8 +85,19 @@ GLRenderer::~GLRenderer ()
         delete objectBuffer.second;
     }
 
+    for (auto&& meshBuffer : m_meshGeometryBuffers)
+    {
+        delete meshBuffer.second;
+    }
+
     delete m_surfaceGeometryBuffer;
+    delete m_sphereGeometryBuffer;
+    delete m_coneGeometryBuffer;
     delete m_uniformBuffers;
+    delete m_boneTransformationsRingBuffer;
+    delete m_geometryPool;
+    delete m_objectTransformsRingBuffer;
+    delete m_drawCommandsRingBuffer;
     delete m_uniformMatrixBuffer;
     delete m_uniformLightViewMatrixBuffer;
     delete m_uniformPointLightBuffer;
@@ -62,12 +112,24 @@ void GLRenderer::Initialize ()
     GLUtils::PrintGLInfo ();
     GLUtils::PrintGLExtensions ();
 
+    // let driver compile and link shaders on background threads, status is only queried on first use of program
+    if (GLAD_GL_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR (0xFFFFFFFF);
+    }
+
+    m_programBinaryCache->Initialize ();
+    InitializeFrameTimerQueries ();
     InitializeShaderLibrary ();
     InitializeQuadGeometryBuffer ();
+    InitializeLightVolumeGeometryBuffers ();
+    InitializeBoneTransformationBuffers ();
     InitializeObjectBuffers ();
     InitializeMatrixUniformBuffers ();
     InitializeLightViewMatrixUniformBuffers ();
     InitializeLightUniformBuffers ();
+    InitializeLightClusterBuffers ();
+    InitializeMaterialUniformBuffers ();
 
     // set callback for new MeshObjects
     GetGameScene ()->GetGame ()->GetMessageBus ()->Subscribe<MeshObjectUpdateMessage> (
@@ -123,21 +185,54 @@ void GLRenderer::Deinitialize ()
     Renderer::Deinitialize ();
 
     DeinitializeQuadGeometryBuffer ();
+    DeinitializeLightVolumeGeometryBuffers ();
     DeinitializeObjectBuffers ();
     DeinitializeMatrixUniformBuffers ();
     DeinitializeLightViewMatrixUniformBuffers ();
     DeinitializeLightUniformBuffers ();
+    DeinitializeLightClusterBuffers ();
+    DeinitializeBoneTransformationBuffers ();
+    DeinitializeMaterialUniformBuffers ();
+    DeinitializeTextures ();
+    DeinitializeFrameTimerQueries ();
 }
 
 std::shared_ptr<IRenderer> GLRenderer::SetViewport (unsigned int x, unsigned int y, unsigned int sx, unsigned int sy)
 {
     glViewport (x, y, sx, sy);
 
+    m_viewport[0] = static_cast<GLint> (x);
+    m_viewport[1] = static_cast<GLint> (y);
+    m_viewport[2] = static_cast<GLint> (sx);
+    m_viewport[3] = static_cast<GLint> (sy);
+
     return std::dynamic_pointer_cast<IRenderer> (shared_from_this ());
 }
 
 void GLRenderer::RenderFrame ()
 {
+    GLuint64 startTime;
+    GLuint64 endTime;
+    GLint isAvailable = GL_FALSE;
+
+    // read back GPU time of frame rendered CILANTRO_BUFFERED_FRAMES ago (without stalling, frame is not measured if not ready yet)
+    if (m_isFrameTimerEnabled)
+    {
+        GLuint* queries = m_frameTimerQueries[m_frameTimerIndex];
+
+        glGetQueryObjectiv (queries[1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_TRUE && m_frameTimerRenderScales[m_frameTimerIndex] > 0.0f)
+        {
+            glGetQueryObjectui64v (queries[0], GL_QUERY_RESULT, &startTime);
+            glGetQueryObjectui64v (queries[1], GL_QUERY_RESULT, &endTime);
+            m_gpuFrameTime = static_cast<float> (endTime - startTime) * 1.0e-9f;
+            m_gpuFrameRenderScale = m_frameTimerRenderScales[m_frameTimerIndex];
+            m_isGpuFrameTimeNew = true;
+        }
+
+        glQueryCounter (queries[0], GL_TIMESTAMP);
+    }
+
     for (auto handle : m_invalidatedObjects)
     {
         // lights
@@ -148,116 +243,86 @@ void GLRenderer::RenderFrame ()
         {
             UpdateAABBBuffers (GetGameScene ()->GetGameObjectManager ()->GetByHandle<MeshObject> (handle));
         }
+
+        // moved shadow casters
+        if (m_isShadowMapping)
+        {
+            CollectShadowCasterBoundsRecursive (handle);
+        }
+    }
+
+    // shadow map programs are relinked when lights are added, start linking them before shadow stage needs them
+    if (m_isShadowMapping)
+    {
+        m_shaderProgramManager->GetByName<ShaderProgram> ("shadowmap_directional_shader")->Prepare ();
+        m_shaderProgramManager->GetByName<ShaderProgram> ("shadowmap_spot_shader")->Prepare ();
+        m_shaderProgramManager->GetByName<ShaderProgram> ("shadowmap_point_shader")->Prepare ();
     }
 
     Renderer::RenderFrame ();
+
+    if (m_isFrameTimerEnabled)
+    {
+        glQueryCounter (m_frameTimerQueries[m_frameTimerIndex][1], GL_TIMESTAMP);
+        m_frameTimerRenderScales[m_frameTimerIndex] = m_renderScale;
+        m_frameTimerIndex = (m_frameTimerIndex + 1) % CILANTRO_BUFFERED_FRAMES;
+    }
+
+    // move to next region of streaming buffers
+    m_boneTransformationsRingBuffer->NextFrame ();
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        m_objectTransformsRingBuffer->NextFrame ();
+        m_drawCommandsRingBuffer->NextFrame ();
+    }
 }
 
 void GLRenderer::Draw (std::shared_ptr<MeshObject> meshObject)
 {
-    SGlGeometryBuffers* b = m_sceneGeometryBuffers[meshObject->GetHandle ()];
-    GLuint shaderProgramId;
-
-    auto objM = meshObject->GetMaterial ();
-
-    // get shader program for rendered meshobject (geometry pass)
-    auto geometryShaderProgram = m_shaderProgramManager->GetByName<GLShaderProgram> (
-        m_isDeferredRendering
-        ? objM->GetDeferredGeometryPassShaderProgram ()
-        : objM->GetForwardShaderProgram ()
-    );
-    geometryShaderProgram->Use ();
-    shaderProgramId = geometryShaderProgram->GetProgramId ();
+    CILANTRO_PROFILE_ZONE ("GLRenderer::Draw");
 
-    // bind textures for active material and bind a shadow map
-    if (m_materialTextureUnits.find(meshObject->GetMaterial ()->GetHandle ()) != m_materialTextureUnits.end ())
+    // queue draw, draws are sorted and submitted in EndDrawBatch
+    if (m_isDrawBatchActive)
     {
-        SGlMaterialTextureUnits* u = m_materialTextureUnits[meshObject->GetMaterial ()->GetHandle ()];
+        auto material = meshObject->GetMaterial ();
+        unsigned int stencil = 0;
+        handle_t program;
 
-        for (GLuint i = 0; i < u->unitsCount; i++)
+        // deferred rendering: group by stencil value (handle of lighting shader program)
+        if (m_isDeferredRendering)
         {
-            glActiveTexture (GL_TEXTURE0 + i);
-            glBindTexture (GL_TEXTURE_2D, u->textureUnits[i]);
+            stencil = static_cast<unsigned int> (m_shaderProgramManager->GetByName<ShaderProgram> (material->GetDeferredLightingPassShaderProgram ())->GetHandle ());
+            program = m_shaderProgramManager->GetByName<ShaderProgram> (material->GetDeferredGeometryPassShaderProgram ())->GetHandle ();
         }
-
-        // bind shadow maps (if exist)
-        if (m_isShadowMapping && (GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()) != nullptr)
+        else
         {
-            if (GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()->IsDepthTextureArrayEnabled ())
-            {
-                GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()->BindFramebufferDepthTextureArrayAsColor (CILANTRO_SHADOW_MAP_BINDING);
-            }
+            program = m_shaderProgramManager->GetByName<ShaderProgram> (material->GetForwardShaderProgram ())->GetHandle ();
         }
 
-    }
-    else
-    {
-        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Missing texture for object" << meshObject->GetHandle ();
-    }
-
-    // set material uniforms for active material
-    for (auto&& property : meshObject->GetMaterial ()->GetPropertiesMap ())
-    {
-        if (geometryShaderProgram->HasUniform (property.first.c_str ()))
+        // skinned meshes need their own bone palette and instanced meshes their own instance transforms, so they can not share a draw
+        unsigned int geometry = 0;
+        if (!meshObject->GetMesh ()->GetMeshBones ().empty ())
         {
-            if (property.second.size () == 1)
-            {
-                geometryShaderProgram->SetUniformFloat (property.first.c_str (), property.second[0]);
-            }
-            else if ((property.second.size () == 3))
-            {
-                geometryShaderProgram->SetUniformFloatv (property.first.c_str (), property.second.data (), 3);
-            }
-            else
-            {
-                LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid vector size for material property" << property.first << "in shader" << geometryShaderProgram->GetName () << "for" << meshObject->GetName ();
-            }
-        }        
-        else 
+            geometry = 1;
+        }
+        else if (std::dynamic_pointer_cast<InstancedMeshObject> (meshObject) != nullptr)
         {
-            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid material uniform" << property.first << "in shader" << geometryShaderProgram->GetName () << "for" << meshObject->GetName ();
+            geometry = 2;
         }
-    }
-
-    // get world matrix for drawn objects and set uniform value
-    geometryShaderProgram->SetUniformMatrix4f ("mModel", meshObject->GetWorldTransformMatrix ());
-
-    // calculate normal matrix for drawn objects and set uniform value
-    geometryShaderProgram->SetUniformMatrix3f ("mNormal", Mathf::Invert (Mathf::Transpose (Matrix3f (meshObject->GetWorldTransformMatrix ()))));
-
-    // set shadow map uniform (if shadow mapping is enabled)
-    // this is only required for forward rendering, because deferred rendering uses a different shader program for lighting pass (DeferredLightingRenderStage)
-    if (!m_isDeferredRendering)
-    {
-        geometryShaderProgram->SetUniformInt ("shadowMapEnabled", m_isShadowMapping ? 1 : 0);
-    }
-    
-    // get camera position in world space and set uniform value
-    if (!m_isDeferredRendering)
-    {
-        geometryShaderProgram->SetUniformVector3f ("eyePosition", GetGameScene ()->GetActiveCamera ()->GetPosition ());
-    }
 
-    // get shader program for rendered meshobject (lighting pass)
-    if (m_isDeferredRendering)
-    {
-        auto lightingShaderProgram = m_shaderProgramManager->GetByName<GLShaderProgram>(objM->GetDeferredLightingPassShaderProgram ());
-        lightingShaderProgram->Use ();
-        shaderProgramId = lightingShaderProgram->GetProgramId ();
+        // front to back
+        float depth = Mathf::Length (Vector3f (meshObject->GetPosition () - GetGameScene ()->GetActiveCamera ()->GetPosition ()));
 
-        // get camera position in world space and set uniform value (this needs to be done again for deferred lighting shader program)
-        lightingShaderProgram->SetUniformVector3f ("eyePosition", GetGameScene ()->GetActiveCamera ()->GetPosition ());
+        m_renderQueue.Push (RenderQueue::MakeKey (stencil, program, material->GetHandle (), geometry, depth), meshObject->GetHandle (), material->GetHandle ());
 
+        return;
     }
 
-    // load bone transformation matrix array to buffer
-    glBindBuffer (GL_UNIFORM_BUFFER, b->boneTransformationsUBO);
-    glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_BONES * sizeof (GLfloat) * 16, meshObject->GetBoneTransformationsMatrixArray (true), GL_DYNAMIC_DRAW);
-    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), b->boneTransformationsUBO);
+    // set up shader program, textures and uniforms of object's material
+    auto geometryShaderProgram = UseMaterial (meshObject->GetMaterial ());
 
     // draw mesh
-    geometryShaderProgram->Use ();
-    RenderGeometryBuffer (b, GL_TRIANGLES);
+    RenderMeshObject (geometryShaderProgram, meshObject, true);
 }
 
 void GLRenderer::DrawSurface ()
@@ -267,23 +332,21 @@ void GLRenderer::DrawSurface ()
 
 void GLRenderer::DrawSceneGeometryBuffers (std::shared_ptr<IShaderProgram> shader)
 {
-    shader->Use ();
-
+    m_drawnMeshObjects.clear ();
     for (auto&& geometryBuffer : m_sceneGeometryBuffers)
     {
-        auto m = GetGameScene ()->GetGameObjectManager ()->GetByHandle<MeshObject> (geometryBuffer.first);
-
-        // load model matrix to currently bound shader
-        shader->SetUniformMatrix4f ("mModel", m->GetWorldTransformMatrix ());
+        m_drawnMeshObjects.push_back (geometryBuffer.first);
+    }
 
-        // load bone transformation matrix array to buffer
-        glBindBuffer (GL_UNIFORM_BUFFER, m_sceneGeometryBuffers[m->GetHandle ()]->boneTransformationsUBO);
-        glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_BONES * sizeof (float) * 16, m->GetBoneTransformationsMatrixArray (true), GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), m_sceneGeometryBuffers[m->GetHandle ()]->boneTransformationsUBO);
+    RenderMeshObjects (shader, m_drawnMeshObjects);
+}
 
-        // draw
-        RenderGeometryBuffer (geometryBuffer.second, GL_TRIANGLES);
-    }
+void GLRenderer::DrawShadowCasters (ELightType lightType, std::shared_ptr<IShaderProgram> shader)
+{
+    // masks of lights each caster is drawn for are loaded with its transformation
+    m_drawnShadowCasterMasks = &m_shadowCasterMasks[static_cast<int> (lightType)];
+    RenderMeshObjects (shader, m_shadowCasters[static_cast<int> (lightType)]);
+    m_drawnShadowCasterMasks = nullptr;
 }
 
 void GLRenderer::DrawAABBGeometryBuffers (std::shared_ptr<IShaderProgram> shader)
@@ -292,163 +355,244 @@ void GLRenderer::DrawAABBGeometryBuffers (std::shared_ptr<IShaderProgram> shader
 
     for (auto&& geometryBuffer : m_aabbGeometryBuffers)
     {
+        if (!IsVisible (geometryBuffer.first))
+        {
+            continue;
+        }
+
         RenderGeometryBuffer (geometryBuffer.second, GL_LINES);
     }
 }
 
-void GLRenderer::Update (std::shared_ptr<MeshObject> meshObject)
+void GLRenderer::DrawLightVolumes (std::shared_ptr<IShaderProgram> shader)
 {
-    handle_t objectHandle = meshObject->GetHandle ();
+    auto camera = GetGameScene ()->GetActiveCamera ();
+    Matrix4f view = camera->GetViewMatrix ();
+    Matrix4f projection = camera->GetProjectionMatrix (m_width, m_height);
+    size_t pointLightCount = GetPointLightCount ();
+    size_t spotLightCount = GetSpotLightCount ();
+    float nearPlane;
+    float farPlane;
+    float ndcMin[2];
+    float ndcMax[2];
+    GLint depthFunction;
+    GLint cullFaceMode;
+    GLboolean isDepthTest = glIsEnabled (GL_DEPTH_TEST);
+    GLboolean isFaceCulling = glIsEnabled (GL_CULL_FACE);
+
+    // lights exceeding uniform buffer capacity are not visible to shaders before GLSL 4.3
+    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    {
+        pointLightCount = std::min (pointLightCount, static_cast<size_t>(CILANTRO_MAX_POINT_LIGHTS));
+        spotLightCount = std::min (spotLightCount, static_cast<size_t>(CILANTRO_MAX_SPOT_LIGHTS));
+    }
 
-    // check of object's buffers are already initialized
-    auto find = m_sceneGeometryBuffers.find (objectHandle);
+    CalculateViewDepthRange (camera, nearPlane, farPlane);
 
-    if (find == m_sceneGeometryBuffers.end ())
-    {
-        // it is a new object, so generate buffers 
-        SGlGeometryBuffers* b = new SGlGeometryBuffers ();
-        m_sceneGeometryBuffers.insert ({ objectHandle, b });
+    GLShaderProgram& glShader = static_cast<GLShaderProgram&> (*shader);
 
-        // generate and bind Vertex Array Object (VAO)
-        glGenVertexArrays (1, &b->VAO);
-        glBindVertexArray (b->VAO);
+    glShader.Use ();
+    glShader.SetUniformVector3f (glShader.GetUniformHandle (UNIFORM_EYEPOSITION), camera->GetPosition ());
 
-        // generate vertex buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_VERTICES]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_VERTICES]);
-        // location = 0 (vertex position)
-        glVertexAttribPointer (EGlVBOType::VBO_VERTICES, 3, GL_FLOAT, GL_FALSE, 3 * sizeof (float), (GLvoid*)0);
+    // light of each volume is added to output of full-screen pass
+    // back faces of volume are tested against depth of g-buffer, so that only surfaces in front of volume's far side are shaded (also with camera inside volume)
+    // volumes reaching beyond far plane are clamped instead of clipped
+    glGetIntegerv (GL_DEPTH_FUNC, &depthFunction);
+    glGetIntegerv (GL_CULL_FACE_MODE, &cullFaceMode);
 
-        // generate normals buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_NORMALS]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_NORMALS]);
-        // location = 1 (vertex normal)
-        glVertexAttribPointer (EGlVBOType::VBO_NORMALS, 3, GL_FLOAT, GL_FALSE, 3 * sizeof (float), (GLvoid*)0);
-
-        // generate uv buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_UVS]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_UVS]);
-        // location = 2 (vertex uv)
-        glVertexAttribPointer (EGlVBOType::VBO_UVS, 2, GL_FLOAT, GL_FALSE, 2 * sizeof (float), (GLvoid*)0);
-
-        // generate tangents buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_TANGENTS]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_TANGENTS]);
-        // location = 3 (vertex tangent)
-        glVertexAttribPointer (EGlVBOType::VBO_TANGENTS, 3, GL_FLOAT, GL_FALSE, 3 * sizeof (float), (GLvoid*)0);
-
-        // generate bitangents buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_BITANGENTS]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BITANGENTS]);
-        // location = 4 (vertex bitangent)
-        glVertexAttribPointer (EGlVBOType::VBO_BITANGENTS, 3, GL_FLOAT, GL_FALSE, 3 * sizeof (float), (GLvoid*)0);
-
-        // generate bone index
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_BONES]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BONES]);
-        // location = 5 (bone indices)
-        glVertexAttribIPointer (EGlVBOType::VBO_BONES, CILANTRO_MAX_BONE_INFLUENCES, GL_INT, CILANTRO_MAX_BONE_INFLUENCES * sizeof (int), (GLvoid*)0);
-
-        // generate bone weight buffer
-        glGenBuffers (1, &b->VBO[EGlVBOType::VBO_BONEWEIGHTS]);
-        glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BONEWEIGHTS]);
-        // location = 6 (bone weights)
-        glVertexAttribPointer (EGlVBOType::VBO_BONEWEIGHTS, CILANTRO_MAX_BONE_INFLUENCES, GL_FLOAT, GL_FALSE, CILANTRO_MAX_BONE_INFLUENCES * sizeof (int), (GLvoid*)0);
-
-        // generate bone transformation matrix array uniform buffer
-        glGenBuffers (1, &b->boneTransformationsUBO);
-        glBindBuffer (GL_UNIFORM_BUFFER, b->boneTransformationsUBO);
-        glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_BONES * sizeof (GLfloat) * 16, NULL, GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), b->boneTransformationsUBO);
+    glEnable (GL_BLEND);
+    glBlendFunc (GL_ONE, GL_ONE);
+    glEnable (GL_DEPTH_TEST);
+    glDepthFunc (GL_GEQUAL);
+    glDepthMask (GL_FALSE);
+    glEnable (GL_DEPTH_CLAMP);
+    glEnable (GL_CULL_FACE);
+    glCullFace (GL_FRONT);
+    glEnable (GL_SCISSOR_TEST);
 
+    // point lights (spheres)
+    for (size_t i = 0; i < pointLightCount; i++)
+    {
+        const GLfloat* position = m_uniformPointLightBuffer->pointLights[i].lightPosition;
+        float radius = m_pointLightRadii[i];
 
-        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        if (!CalculateLightScreenBounds (view, projection, nearPlane, farPlane, position, radius, ndcMin, ndcMax))
+        {
+            continue;
+        }
+
+        // lights without finite range are drawn as sphere enclosing far plane
+        if (!(radius > 0.0f) || std::isinf (radius))
         {
-            // generate vertex positions array SSBO buffer
-            glGenBuffers (1, &b->vertexPositionsSSBO);
-            glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->vertexPositionsSSBO);
-            glBufferData (GL_SHADER_STORAGE_BUFFER, CILANTRO_MAX_VERTICES * sizeof (GLfloat) * 3, NULL, GL_DYNAMIC_DRAW);
-            glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_VERTICES), b->vertexPositionsSSBO);
+            radius = 2.0f * farPlane;
+        }
+
+        Matrix4f model = Mathf::GenTranslationMatrix (Vector3f (position[0], position[1], position[2])) * Mathf::GenScalingMatrix (Vector3f (radius, radius, radius));
 
-            // generate bone indices array SSBO buffer
-            glGenBuffers (1, &b->boneIndicesSSBO);
-            glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->boneIndicesSSBO);
-            glBufferData (GL_SHADER_STORAGE_BUFFER, CILANTRO_MAX_VERTICES * sizeof (GLuint) * CILANTRO_MAX_BONE_INFLUENCES, NULL, GL_DYNAMIC_DRAW);
-            glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEINDICES), b->boneIndicesSSBO);
+        RenderLightVolume (shader, EGlLightVolumeType::LIGHTVOLUME_POINT, i, model, m_sphereGeometryBuffer, ndcMin, ndcMax);
+    }
 
-            // generate bone weights array SSBO buffer
-            glGenBuffers (1, &b->boneWeightsSSBO);
-            glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->boneWeightsSSBO);
-            glBufferData (GL_SHADER_STORAGE_BUFFER, CILANTRO_MAX_VERTICES * sizeof (GLfloat) * CILANTRO_MAX_BONE_INFLUENCES, NULL, GL_DYNAMIC_DRAW);
-            glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEWEIGHTS), b->boneWeightsSSBO);
+    // spot lights (cones, spheres for wide cones which would be larger than sphere of light's range)
+    for (size_t i = 0; i < spotLightCount; i++)
+    {
+        const SGlSpotLightStruct& light = m_uniformSpotLightBuffer->spotLights[i];
+        float radius = m_spotLightRadii[i];
 
-            // generate AABB result SSBO buffer
-            glGenBuffers (1, &b->aabbSSBO);
-            glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->aabbSSBO);
-            glBufferData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlEncodedAABB), NULL, GL_DYNAMIC_DRAW);
-            glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_AABB), b->aabbSSBO);
+        if (!CalculateLightScreenBounds (view, projection, nearPlane, farPlane, light.lightPosition, radius, ndcMin, ndcMax))
+        {
+            continue;
         }
 
-        // generate index buffer
-        glGenBuffers (1, &b->EBO);
-        glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, b->EBO);
+        if (!(radius > 0.0f) || std::isinf (radius))
+        {
+            radius = 2.0f * farPlane;
+        }
 
-        // enable VBO arrays
-        glEnableVertexAttribArray (EGlVBOType::VBO_VERTICES);
-        glEnableVertexAttribArray (EGlVBOType::VBO_NORMALS);
-        glEnableVertexAttribArray (EGlVBOType::VBO_UVS);
-        glEnableVertexAttribArray (EGlVBOType::VBO_TANGENTS);
-        glEnableVertexAttribArray (EGlVBOType::VBO_BITANGENTS);
-        glEnableVertexAttribArray (EGlVBOType::VBO_BONES);
-        glEnableVertexAttribArray (EGlVBOType::VBO_BONEWEIGHTS);
+        Vector3f position (light.lightPosition[0], light.lightPosition[1], light.lightPosition[2]);
+        float baseScale = std::sqrt (std::max (1.0f - light.outerCutoffCosine * light.outerCutoffCosine, 0.0f)) / std::max (light.outerCutoffCosine, 0.0f);
+        Matrix4f model;
 
-        // unbind VAO
-        glBindVertexArray (0);
+        if (light.outerCutoffCosine > 0.0f && baseScale < 2.0f)
+        {
+            // orthonormal basis with z axis along light direction
+            Vector3f z = Mathf::Normalize (Vector3f (light.lightDirection[0], light.lightDirection[1], light.lightDirection[2]));
+            Vector3f up = std::abs (z[1]) < 0.99f ? Vector3f (0.0f, 1.0f, 0.0f) : Vector3f (1.0f, 0.0f, 0.0f);
+            Vector3f x = Mathf::Normalize (Mathf::Cross (up, z));
+            Vector3f y = Mathf::Cross (z, x);
+
+            model = Matrix4f (Vector4f (x * (radius * baseScale), 0.0f), Vector4f (y * (radius * baseScale), 0.0f), Vector4f (z * radius, 0.0f), Vector4f (position, 1.0f));
+            RenderLightVolume (shader, EGlLightVolumeType::LIGHTVOLUME_SPOT, i, model, m_coneGeometryBuffer, ndcMin, ndcMax);
+        }
+        else
+        {
+            model = Mathf::GenTranslationMatrix (position) * Mathf::GenScalingMatrix (Vector3f (radius, radius, radius));
+            RenderLightVolume (shader, EGlLightVolumeType::LIGHTVOLUME_SPOT, i, model, m_sphereGeometryBuffer, ndcMin, ndcMax);
+        }
+    }
+
+    // restore state
+    glDisable (GL_SCISSOR_TEST);
+    glCullFace (cullFaceMode);
+    glDisable (GL_DEPTH_CLAMP);
+    glDepthMask (GL_TRUE);
+    glDepthFunc (depthFunction);
+    glDisable (GL_BLEND);
 
+    if (!isFaceCulling)
+    {
+        glDisable (GL_CULL_FACE);
+    }
+
+    if (!isDepthTest)
+    {
+        glDisable (GL_DEPTH_TEST);
     }
+}
+
+void GLRenderer::BeginDrawBatch ()
+{
+    m_isDrawBatchActive = true;
+    m_renderQueue.Clear ();
+}
 
-    // resize buffers and load data
-    SGlGeometryBuffers* b = m_sceneGeometryBuffers[objectHandle];
-    b->indexCount = meshObject->GetMesh ()->GetIndexCount ();
+void GLRenderer::EndDrawBatch ()
+{
+    // per-draw transforms are sourced by base instance, which requires GLSL 4.60
+    bool isIndirectDrawSupported = GLUtils::GetGLSLVersion ().versionNumber >= 460;
+    const std::vector<SRenderQueueItem>& items = m_renderQueue.GetItems ();
+    std::shared_ptr<GLShaderProgram> geometryShaderProgram;
+    handle_t currentMaterial = 0;
+    int currentStencil = -1;
+    size_t i = 0;
 
-    // bind Vertex Array Object (VAO)
-    glBindVertexArray (b->VAO);
+    m_isDrawBatchActive = false;
+    m_renderQueue.Sort ();
 
-    // load vertex buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_VERTICES]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * 3, meshObject->GetMesh ()->GetVerticesData (), GL_DYNAMIC_DRAW);
+    while (i < items.size ())
+    {
+        // state changes only when material (and with it shader program) changes
+        if (geometryShaderProgram == nullptr || items[i].materialHandle != currentMaterial)
+        {
+            auto material = GetGameScene ()->GetMaterialManager ()->GetByHandle<Material> (items[i].materialHandle);
 
-    // load normals buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_NORMALS]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * 3, meshObject->GetMesh ()->GetNormalsData (), GL_DYNAMIC_DRAW);
-    
-    // load uv buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_UVS]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * 2, meshObject->GetMesh ()->GetUVData (), GL_DYNAMIC_DRAW);
+            // set stencil value to handle of material's lighting shader (deferred geometry pass)
+            int stencil = static_cast<int> (items[i].key >> CILANTRO_RENDER_KEY_STENCIL_SHIFT);
+            if (m_isDeferredRendering && stencil != currentStencil)
+            {
+                SetStencilTestFunction (EStencilTestFunction::FUNCTION_ALWAYS, stencil);
+                currentStencil = stencil;
+            }
 
-    // load tangents buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_TANGENTS]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * 3, meshObject->GetMesh ()->GetTangentData (), GL_DYNAMIC_DRAW);
+            geometryShaderProgram = UseMaterial (material);
+            currentMaterial = items[i].materialHandle;
+        }
+
+        if (isIndirectDrawSupported && RenderQueue::GetGeometry (items[i].key) == 0)
+        {
+            // draw run of meshes without bones sharing the material with a single indirect draw
+            m_unskinnedMeshObjects.clear ();
+            while (i < items.size () && items[i].materialHandle == currentMaterial && RenderQueue::GetGeometry (items[i].key) == 0)
+            {
+                m_unskinnedMeshObjects.push_back (items[i].objectHandle);
+                i++;
+            }
 
-    // load bitangents buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BITANGENTS]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * 3, meshObject->GetMesh ()->GetBitangentData (), GL_DYNAMIC_DRAW);
+            RenderMeshObjectsIndirect (geometryShaderProgram, m_unskinnedMeshObjects, IsGPUCulling ());
+        }
+        else
+        {
+            RenderMeshObject (geometryShaderProgram, GetGameScene ()->GetGameObjectManager ()->GetByHandle<MeshObject> (items[i].objectHandle), true);
+            i++;
+        }
+    }
 
-    // load bone index buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BONES]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (uint32_t) * CILANTRO_MAX_BONE_INFLUENCES, meshObject->GetMesh ()->GetBoneIndicesData (), GL_DYNAMIC_DRAW);
+    m_renderQueue.Clear ();
+}
 
-    // load bone weight buffer
-    glBindBuffer (GL_ARRAY_BUFFER, b->VBO[EGlVBOType::VBO_BONEWEIGHTS]);
-    glBufferData (GL_ARRAY_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (float) * CILANTRO_MAX_BONE_INFLUENCES, meshObject->GetMesh ()->GetBoneWeightsData (), GL_DYNAMIC_DRAW);
+bool GLRenderer::IsGPUCulling () const
+{
+    // culled draws are generated on GPU for indirect draws only
+    return m_isGPUCulling && GLUtils::GetGLSLVersion ().versionNumber >= 460;
+}
 
-    // load index buffer
-    glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, b->EBO);
-    glBufferData (GL_ELEMENT_ARRAY_BUFFER, meshObject->GetMesh ()->GetIndexCount () * sizeof (uint32_t), meshObject->GetMesh ()->GetFacesData (), GL_DYNAMIC_DRAW);
+void GLRenderer::Update (std::shared_ptr<MeshObject> meshObject)
+{
+    handle_t objectHandle = meshObject->GetHandle ();
+    std::shared_ptr<Mesh> mesh = meshObject->GetMesh ();
 
-    // unbind VAO
-    glBindVertexArray (0);
+    // check of object's buffers are already initialized
+    auto find = m_sceneGeometryBuffers.find (objectHandle);
+
+    if (find == m_sceneGeometryBuffers.end ())
+    {
+        // it is a new object, so generate buffers and reference geometry of its mesh
+        SGlGeometryBuffers* b = new SGlGeometryBuffers ();
+        m_sceneGeometryBuffers.insert ({ objectHandle, b });
+
+        b->meshHandle = mesh->GetHandle ();
+        b->meshGeometry = AcquireMeshGeometryBuffers (mesh);
+
+        // generate instance transformations SSBO buffer (loaded before first draw)
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430 && std::dynamic_pointer_cast<InstancedMeshObject> (meshObject) != nullptr)
+        {
+            glGenBuffers (1, &b->instanceTransformsSSBO);
+            b->instanceTransformsVersion = std::numeric_limits<size_t>::max ();
+        }
+    }
+
+    // every object drawing the mesh is notified of mesh update, but mesh geometry is loaded only once per update
+    SGlMeshGeometryBuffers* g = m_sceneGeometryBuffers[objectHandle]->meshGeometry;
+
+    if (g->meshVersion != mesh->GetVersion ())
+    {
+        LoadMeshGeometryBuffers (mesh, g);
+    }
 
+    // new or modified shadow caster, tiles overlapping its bounds are redrawn on next frame
+    if (m_isShadowMapping)
+    {
+        m_invalidatedObjects.insert (objectHandle);
+    }
 }
 
 void GLRenderer::UpdateAABBBuffers (std::shared_ptr<MeshObject> meshObject)
@@ -463,7 +607,7 @@ void GLRenderer::UpdateAABBBuffers (std::shared_ptr<MeshObject> meshObject)
         // it is a new object, so generate buffers 
         SGlGeometryBuffers* w = new SGlGeometryBuffers ();
         m_aabbGeometryBuffers.insert ({ objectHandle, w });
-        w->indexCount = 12; // AABB has 12 edges
+        w->indexCount = 24; // AABB has 12 edges, 2 indices each
 
         // generate and bind Vertex Array Object (VAO) - wireframes
         glGenVertexArrays (1, &w->VAO);
@@ -515,33 +659,22 @@ AABB GLRenderer::CalculateAABB (std::shared_ptr<MeshObject> meshObject)
         AABB aabb;
         SGlEncodedAABB aabbGPU;
         SGlGeometryBuffers* b = m_sceneGeometryBuffers[meshObject->GetHandle ()];
+        SGlMeshGeometryBuffers* g = b->meshGeometry;
 
         // get compute shader
         auto computeShader = m_shaderProgramManager->GetByName<GLShaderProgram> ("aabb_compute_shader");
         computeShader->Use ();
         
         // get world matrix for drawn objects and set uniform value
-        computeShader->SetUniformMatrix4f ("mModel", meshObject->GetWorldTransformMatrix ());
-
-        // load bone transformation matrix array to buffer
-        glBindBuffer (GL_UNIFORM_BUFFER, b->boneTransformationsUBO);
-        glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_BONES * sizeof (GLfloat) * 16, meshObject->GetBoneTransformationsMatrixArray (true), GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), b->boneTransformationsUBO);
-
-        // load vertex positions array buffer (SSBO)
-        glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->vertexPositionsSSBO);
-        glBufferData (GL_SHADER_STORAGE_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (GLfloat) * 3, meshObject->GetMesh ()->GetVerticesData (), GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_VERTICES), b->vertexPositionsSSBO);
+        computeShader->SetUniformMatrix4f (computeShader->GetUniformHandle (UNIFORM_MODEL), meshObject->GetWorldTransformMatrix ());
 
-        // load bone indices array buffer (SSBO)
-        glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->boneIndicesSSBO);
-        glBufferData (GL_SHADER_STORAGE_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (GLuint) * CILANTRO_MAX_BONE_INFLUENCES, meshObject->GetMesh ()->GetBoneIndicesData (), GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEINDICES), b->boneIndicesSSBO);
+        // load bone transformation matrix array to buffer (bones may still be animated in this frame, so always load fresh copy)
+        LoadBoneTransformationBuffer (meshObject, b, false);
 
-        // load bone weights array buffer (SSBO)
-        glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->boneWeightsSSBO);
-        glBufferData (GL_SHADER_STORAGE_BUFFER, meshObject->GetMesh ()->GetVertexCount () * sizeof (GLfloat) * CILANTRO_MAX_BONE_INFLUENCES, meshObject->GetMesh ()->GetBoneWeightsData (), GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEWEIGHTS), b->boneWeightsSSBO);
+        // bind vertex positions, bone indices and bone weights of mesh (SSBO, loaded with mesh geometry)
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_VERTICES), g->vertexPositionsSSBO);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEINDICES), g->boneIndicesSSBO);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_BONEWEIGHTS), g->boneWeightsSSBO);
 
         // initialize AABB extreme values
         aabbGPU.minBits[0] = 0xFFFFFFFF;
@@ -552,16 +685,16 @@ AABB GLRenderer::CalculateAABB (std::shared_ptr<MeshObject> meshObject)
         aabbGPU.maxBits[1] = 0x00000000;
         aabbGPU.maxBits[2] = 0x00000000;
         aabbGPU.pad2 = 0x00000000;
-        glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->aabbSSBO);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, g->aabbSSBO);
         glBufferData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlEncodedAABB), &aabbGPU, GL_DYNAMIC_DRAW);
-        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_AABB), b->aabbSSBO);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_AABB), g->aabbSSBO);
 
         // dispatch compute shader
         GLuint groupSize = (static_cast<GLuint>(meshObject->GetMesh ()->GetVertexCount ()) + CILANTRO_COMPUTE_GROUP_SIZE - 1) / CILANTRO_COMPUTE_GROUP_SIZE;
         computeShader->Compute (groupSize, 1, 1);
 
         // read back AABB from compute shader
-        glBindBuffer (GL_SHADER_STORAGE_BUFFER, b->aabbSSBO);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, g->aabbSSBO);
         glGetBufferSubData (GL_SHADER_STORAGE_BUFFER, 0, sizeof (SGlEncodedAABB), &aabbGPU);
         
         // redo the bit flip for the float representation
@@ -589,27 +722,6 @@ AABB GLRenderer::CalculateAABB (std::shared_ptr<MeshObject> meshObject)
 void GLRenderer::Update (std::shared_ptr<Material> material, unsigned int textureUnit)
 {
     handle_t materialHandle = material->GetHandle ();
-    GLuint texture;
-    GLuint format;
-
-    auto GLTextureFormat = [](unsigned int numChannels)
-    {
-        switch (numChannels)
-        {
-        case 1:
-            return GL_RED;
-            break;
-        case 3:
-            return GL_RGB;
-            break;
-        case 4:
-            return GL_RGBA;
-            break;
-        default:
-            return GL_RGB;
-        }
-    };
-
     texture_map_t& textures = material->GetTexturesMap ();
 
     // check if material already exists
@@ -617,71 +729,81 @@ void GLRenderer::Update (std::shared_ptr<Material> material, unsigned int textur
 
     if (find == m_materialTextureUnits.end ())
     {
-        m_materialTextureUnits.insert ({ materialHandle, new SGlMaterialTextureUnits () });
+        SGlMaterialTextureUnits* u = new SGlMaterialTextureUnits ();
+        m_materialTextureUnits.insert ({ materialHandle, u });
         
         for (auto&& t : textures)
         {
-            auto tPtr = t.second.second;
-            std::string tName = t.second.first;
-            GLuint unit = t.first;
-            format = GLTextureFormat (tPtr->GetChannels ());
-
-            glGenTextures (1, &texture);
-            glBindTexture (GL_TEXTURE_2D, texture);
-            glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
-            glTexImage2D (GL_TEXTURE_2D, 0, format, tPtr->GetWidth (), tPtr->GetHeight (), 0, format, GL_UNSIGNED_BYTE, tPtr->Data ());
-            glGenerateMipmap (GL_TEXTURE_2D);
-            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glBindTexture (GL_TEXTURE_2D, 0);
-            
-            m_materialTextureUnits[materialHandle]->textureUnits[unit] = texture;
+            u->textureUnits[t.first] = AcquireTexture (t.second.second);
         }
 
-        m_materialTextureUnits[materialHandle]->unitsCount = (unsigned int) textures.size ();
+        u->unitsCount = (unsigned int) textures.size ();
 
     }
     else
     {
-        auto& t = textures[textureUnit];
-        auto tPtr = t.second;
-        std::string tName = t.first;
-        GLuint unit = textureUnit;
-        format = GLTextureFormat (tPtr->GetChannels ());
-
-        glBindTexture (GL_TEXTURE_2D, m_materialTextureUnits[materialHandle]->textureUnits[unit]);
-        glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D (GL_TEXTURE_2D, 0, format, tPtr->GetWidth (), tPtr->GetHeight (), 0, format, GL_UNSIGNED_BYTE, tPtr->Data ());
-        glGenerateMipmap (GL_TEXTURE_2D);
-        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,  GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture (GL_TEXTURE_2D, 0);
+        SGlTexture*& unit = find->second->textureUnits[textureUnit];
+        auto texture = textures[textureUnit].second;
+
+        if (unit != nullptr && unit->resource == texture.get ())
+        {
+            // same texture with modified contents
+            LoadTexture (texture, unit);
+        }
+        else
+        {
+            // texture replaced, reference the new one
+            SGlTexture* previous = unit;
+            unit = AcquireTexture (texture);
+
+            if (previous != nullptr)
+            {
+                ReleaseTexture (previous);
+            }
+        }
+
+        find->second->unitsCount = (unsigned int) textures.size ();
     }
 }
 
 void GLRenderer::Update (std::shared_ptr<Material> material)
 {
+    // properties block is reloaded on next use of material
+    m_invalidatedMaterials.insert (material->GetHandle ());
+
     handle_t shaderProgramHandle = m_shaderProgramManager->GetByName<ShaderProgram>(material->GetDeferredLightingPassShaderProgram ())->GetHandle ();
     std::string shaderProgramName = material->GetDeferredLightingPassShaderProgram ();
 
+    // start compiling programs used by material, so they are ready by the time it is drawn
+    if (m_isDeferredRendering)
+    {
+        m_shaderProgramManager->GetByName<ShaderProgram> (material->GetDeferredGeometryPassShaderProgram ())->Prepare ();
+        m_shaderProgramManager->GetByName<ShaderProgram> (shaderProgramName)->Prepare ();
+        if (!material->GetDeferredLightVolumeShaderProgram ().empty ())
+        {
+            m_shaderProgramManager->GetByName<ShaderProgram> (material->GetDeferredLightVolumeShaderProgram ())->Prepare ();
+        }
+    }
+    else
+    {
+        m_shaderProgramManager->GetByName<ShaderProgram> (material->GetForwardShaderProgram ())->Prepare ();
+    }
+
     if (m_isDeferredRendering)
     {
         // add material's shader program to set of used shader programs handles
         // add lighting deferred pass renderStages for each program
         if (m_lightingShaders.find (shaderProgramHandle) == m_lightingShaders.end ())
         {
-            // first rotate the pipeline to the left so that geometry stage is last
-            RotateRenderPipelineLeft ();
-            if (m_isShadowMapping)
-            {
-                RotateRenderPipelineLeft ();
-            }
-
-            // create and append new lighting stage
+            // create new lighting stage
             m_lightingShaderStagesCount++;
             m_lightingShaders.insert (shaderProgramHandle);
             auto q = Create <DeferredLightingRenderStage> ("deferred_lighting_" + shaderProgramName);
             q->SetShaderProgram (shaderProgramName);
+            if (!material->GetDeferredLightVolumeShaderProgram ().empty ())
+            {
+                q->SetLightVolumeShaderProgram (material->GetDeferredLightVolumeShaderProgram ());
+            }
             q->SetStencilTestEnabled (true)->SetStencilTest (EStencilTestFunction::FUNCTION_EQUAL, static_cast<int> (shaderProgramHandle));
             q->SetClearColorOnFrameEnabled (true);
             q->SetClearDepthOnFrameEnabled (false);
@@ -696,18 +818,15 @@ void GLRenderer::Update (std::shared_ptr<Material> material)
 
             q->Initialize ();
 
-            // rotate pipeline to the right, so that ultimately geometry stage is first and newly added stage is second
-            RotateRenderPipelineRight ();
-            RotateRenderPipelineRight ();
-            if (m_isShadowMapping)
-            {
-                RotateRenderPipelineRight ();
-            }
-            
+            // move it from end of pipeline right after geometry stage (following shadow map stage, if present)
+            m_renderPipeline.pop_back ();
+            m_renderPipeline.insert (m_renderPipeline.begin () + (m_isShadowMapping ? 2 : 1), q->GetHandle ());
+            m_isRenderGraphDirty = true;
+
             // update flags of other deferred lighting stages (if present)
             if (m_lightingShaderStagesCount > 1)
             {
-                handle_t stageHandle = GetRenderPipeline ()[2 + (m_isShadowMapping ? 1 : 0)];
+                handle_t stageHandle = m_renderPipeline[2 + (m_isShadowMapping ? 1 : 0)];
 
                 auto stage = m_renderStageManager->GetByHandle<DeferredLightingRenderStage> (stageHandle);
                 stage->SetClearColorOnFrameEnabled (false);
@@ -731,19 +850,24 @@ void GLRenderer::Update (std::shared_ptr<PointLight> pointLight)
     {
         lightId = m_uniformPointLightBuffer->pointLightCount++;
         m_pointLights.insert ({ objectHandle, lightId });
+        m_uniformPointLightBuffer->pointLights.resize (GetPointLightCount ());
+        m_pointLightRadii.resize (GetPointLightCount ());
 
-        // update invocation count in shadow map geometry shader
-        auto shadowmapShader = GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader> ("shadowmap_point_geometry_shader");
-        shadowmapShader->SetVariable ("ACTIVE_POINT_LIGHTS", std::to_string (GetPointLightCount ()));
-        shadowmapShader->Compile ();
-
-        auto shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_point_shader");
-        shadowmapShaderProg->Link ();
-        shadowmapShaderProg->BindUniformBlock ("UniformPointLightViewMatricesBlock", EGlUBOType::UBO_POINTLIGHTVIEWMATRICES);
-        shadowmapShaderProg->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        // shadows are cast only by lights fitting into light view matrices buffer
+        if (lightId < CILANTRO_MAX_POINT_LIGHTS)
+        {
+            // update invocation count in shadow map geometry shader
+            auto shadowmapShader = GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader> ("shadowmap_point_geometry_shader");
+            shadowmapShader->SetVariable ("ACTIVE_POINT_LIGHTS", std::to_string (GetPointLightCount ()));
+            shadowmapShader->Compile ();
 
-        // set offset in shadow map texture array (directional + spot light count for point lights)
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", static_cast<int>(GetDirectionalLightCount () + GetSpotLightCount ()));
+            auto shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_point_shader");
+            shadowmapShaderProg->Link ();
+        }
+        else if (GLUtils::GetGLSLVersion ().versionNumber < 430 && lightId == CILANTRO_MAX_POINT_LIGHTS)
+        {
+            LogMessage (MSG_LOCATION) << "Point light limit" << CILANTRO_MAX_POINT_LIGHTS << "reached, OpenGL 4.3 required for more lights";
+        }
     }
     else
     {
@@ -767,17 +891,32 @@ void GLRenderer::Update (std::shared_ptr<PointLight> pointLight)
     m_uniformPointLightBuffer->pointLights[lightId].lightColor[1] = pointLight->GetColor ()[1];
     m_uniformPointLightBuffer->pointLights[lightId].lightColor[2] = pointLight->GetColor ()[2];
 
+    // range of light for clustering
+    m_pointLightRadii[lightId] = pointLight->GetBoundingSphereRadius (CILANTRO_LIGHT_CLUSTER_THRESHOLD);
+
     // copy to GPU memory
-    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        LoadLightStorageBuffer (m_pointLightsBuffer, m_pointLightsBufferSize, m_uniformPointLightBuffer->pointLightCount, m_uniformPointLightBuffer->pointLights.data (), sizeof (SGlPointLightStruct), lightId);
+    }
+    else
+    {
+        GLuint pointLightCount = std::min (m_uniformPointLightBuffer->pointLightCount, static_cast<GLuint>(CILANTRO_MAX_POINT_LIGHTS));
 
-    // load light counts
-    glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (m_uniformPointLightBuffer->pointLightCount), &m_uniformPointLightBuffer->pointLightCount);
+        glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
 
-    // load uniform buffer for a light at given index
-    uniformBufferOffset = sizeof (m_uniformPointLightBuffer->pointLightCount) + 3 * sizeof (GLint) + lightId * sizeof (SGlPointLightStruct);
-    glBufferSubData (GL_UNIFORM_BUFFER, uniformBufferOffset, sizeof (SGlPointLightStruct), &m_uniformPointLightBuffer->pointLights[lightId]);
+        // load light counts
+        glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (pointLightCount), &pointLightCount);
 
-    glBindBuffer (GL_UNIFORM_BUFFER, 0);
+        // load uniform buffer for a light at given index
+        if (lightId < CILANTRO_MAX_POINT_LIGHTS)
+        {
+            uniformBufferOffset = sizeof (m_uniformPointLightBuffer->pointLightCount) + 3 * sizeof (GLint) + lightId * sizeof (SGlPointLightStruct);
+            glBufferSubData (GL_UNIFORM_BUFFER, uniformBufferOffset, sizeof (SGlPointLightStruct), &m_uniformPointLightBuffer->pointLights[lightId]);
+        }
+
+        glBindBuffer (GL_UNIFORM_BUFFER, 0);
+    }
 
 }
 
@@ -802,15 +941,6 @@ void GLRenderer::Update (std::shared_ptr<DirectionalLight> directionalLight)
 
         auto shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_directional_shader");
         shadowmapShaderProg->Link ();
-        shadowmapShaderProg->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
-        shadowmapShaderProg->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-
-        // set offset in shadow map texture array (zero for directional lights)
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", 0);
-        shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_spot_shader");
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", static_cast<int>(GetDirectionalLightCount ()));
-        shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_point_shader");
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", static_cast<int>(GetDirectionalLightCount () + GetSpotLightCount ()));
     }
     else
     {
@@ -855,21 +985,24 @@ void GLRenderer::Update (std::shared_ptr<SpotLight> spotLight)
     {
         lightId = m_uniformSpotLightBuffer->spotLightCount++;
         m_spotLights.insert ({ objectHandle, lightId });
+        m_uniformSpotLightBuffer->spotLights.resize (GetSpotLightCount ());
+        m_spotLightRadii.resize (GetSpotLightCount ());
 
-        // update invocation count in shadow map geometry shader
-        auto shadowmapShader = GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader> ("shadowmap_spot_geometry_shader");
-        shadowmapShader->SetVariable ("ACTIVE_SPOT_LIGHTS", std::to_string (GetSpotLightCount ()));
-        shadowmapShader->Compile ();
-
-        auto shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_spot_shader");
-        shadowmapShaderProg->Link ();
-        shadowmapShaderProg->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-        shadowmapShaderProg->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        // shadows are cast only by lights fitting into light view matrices buffer
+        if (lightId < CILANTRO_MAX_SPOT_LIGHTS)
+        {
+            // update invocation count in shadow map geometry shader
+            auto shadowmapShader = GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader> ("shadowmap_spot_geometry_shader");
+            shadowmapShader->SetVariable ("ACTIVE_SPOT_LIGHTS", std::to_string (GetSpotLightCount ()));
+            shadowmapShader->Compile ();
 
-        // set offset in shadow map texture array (directional light count for spot lights)
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", static_cast<int>(GetDirectionalLightCount ()));
-        shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_point_shader");
-        shadowmapShaderProg->SetUniformInt ("textureArrayOffset", static_cast<int>(GetDirectionalLightCount () + GetSpotLightCount ()));
+            auto shadowmapShaderProg = GetShaderProgramManager ()->GetByName<GLShaderProgram> ("shadowmap_spot_shader");
+            shadowmapShaderProg->Link ();
+        }
+        else if (GLUtils::GetGLSLVersion ().versionNumber < 430 && lightId == CILANTRO_MAX_SPOT_LIGHTS)
+        {
+            LogMessage (MSG_LOCATION) << "Spot light limit" << CILANTRO_MAX_SPOT_LIGHTS << "reached, OpenGL 4.3 required for more lights";
+        }
     }
     else
     {
@@ -903,27 +1036,69 @@ void GLRenderer::Update (std::shared_ptr<SpotLight> spotLight)
     m_uniformSpotLightBuffer->spotLights[lightId].lightColor[1] = spotLight->GetColor ()[1];
     m_uniformSpotLightBuffer->spotLights[lightId].lightColor[2] = spotLight->GetColor ()[2];
 
-    // copy to GPU memory
-    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
-
-    // load light counts
-    glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (m_uniformSpotLightBuffer->spotLightCount), &m_uniformSpotLightBuffer->spotLightCount);
+    // range of light for clustering
+    m_spotLightRadii[lightId] = spotLight->GetBoundingSphereRadius (CILANTRO_LIGHT_CLUSTER_THRESHOLD);
 
-    // load uniform buffer for a light at given index
-    uniformBufferOffset = sizeof (m_uniformSpotLightBuffer->spotLightCount) + 3 * sizeof (GLint) + lightId * sizeof (SGlSpotLightStruct);
-    glBufferSubData (GL_UNIFORM_BUFFER, uniformBufferOffset, sizeof (SGlSpotLightStruct), &m_uniformSpotLightBuffer->spotLights[lightId]);
+    // copy to GPU memory
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        LoadLightStorageBuffer (m_spotLightsBuffer, m_spotLightsBufferSize, m_uniformSpotLightBuffer->spotLightCount, m_uniformSpotLightBuffer->spotLights.data (), sizeof (SGlSpotLightStruct), lightId);
+    }
+    else
+    {
+        GLuint spotLightCount = std::min (m_uniformSpotLightBuffer->spotLightCount, static_cast<GLuint>(CILANTRO_MAX_SPOT_LIGHTS));
 
-    glBindBuffer (GL_UNIFORM_BUFFER, 0);
+        glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+
+        // load light counts
+        glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (spotLightCount), &spotLightCount);
+
+        // load uniform buffer for a light at given index
+        if (lightId < CILANTRO_MAX_SPOT_LIGHTS)
+        {
+            uniformBufferOffset = sizeof (m_uniformSpotLightBuffer->spotLightCount) + 3 * sizeof (GLint) + lightId * sizeof (SGlSpotLightStruct);
+            glBufferSubData (GL_UNIFORM_BUFFER, uniformBufferOffset, sizeof (SGlSpotLightStruct), &m_uniformSpotLightBuffer->spotLights[lightId]);
+        }
+
+        glBindBuffer (GL_UNIFORM_BUFFER, 0);
+    }
 }
 
 void GLRenderer::UpdateCameraBuffers (std::shared_ptr<Camera> camera)
 {
     LoadMatrixUniformBuffers (camera);
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        LoadLightClusterBuffers (camera);
+    }
 }
 
 void GLRenderer::UpdateLightViewBuffers ()
 {
     LoadLightViewMatrixUniformBuffers ();
+
+    auto isAnyTileStale = [](const GLfloat* bufferTiles, size_t tileCount)
+    {
+        for (size_t i = 0; i < tileCount; i++)
+        {
+            if (bufferTiles[i * 4 + 3] != 0.0f)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    m_isShadowMapStale[static_cast<int> (ELightType::LIGHT_DIRECTIONAL)] = isAnyTileStale (m_uniformLightViewMatrixBuffer->directionalLightTile, m_directionalLightShadowTiles.size ());
+    m_isShadowMapStale[static_cast<int> (ELightType::LIGHT_SPOT)] = isAnyTileStale (m_uniformLightViewMatrixBuffer->spotLightTile, m_spotLightShadowTiles.size ());
+    m_isShadowMapStale[static_cast<int> (ELightType::LIGHT_POINT)] = isAnyTileStale (m_uniformLightViewMatrixBuffer->pointLightTile, m_pointLightShadowTiles.size ());
+}
+
+bool GLRenderer::IsShadowMapStale (ELightType lightType) const
+{
+    return m_isShadowMapStale[static_cast<int> (lightType)];
 }
 
 size_t GLRenderer::GetPointLightCount () const
@@ -966,6 +1141,31 @@ std::shared_ptr<IFramebuffer> GLRenderer::CreateFramebuffer (unsigned int width,
     return framebuffer;
 }
 
+std::shared_ptr<IFramebuffer> GLRenderer::CreateFramebuffer (unsigned int width, unsigned int height, const std::vector<EFramebufferTextureFormat>& colorTextureFormats, bool depthStencilTextureEnabled, bool multisampleEnabled)
+{
+    std::shared_ptr<IFramebuffer> framebuffer;
+
+    if (multisampleEnabled)
+    {
+        if (GLUtils::GetGLSLVersion ().versionNumber <= 150)
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "OpenGL 3.2 required for multisample framebuffers";
+        }
+        else 
+        {
+            framebuffer = std::make_shared<GLMultisampleFramebuffer> (width, height, colorTextureFormats, depthStencilTextureEnabled);
+        }
+    }
+    else
+    {
+        framebuffer = std::make_shared<GLFramebuffer> (width, height, colorTextureFormats, depthStencilTextureEnabled);
+    }
+    
+    framebuffer->Initialize ();
+
+    return framebuffer;
+}
+
 void GLRenderer::BindDefaultFramebuffer ()
 {
     glBindFramebuffer (GL_FRAMEBUFFER, (GLint) 0);
@@ -1086,6 +1286,24 @@ void GLRenderer::SetMultisamplingEnabled (bool value)
     }    
 }
 
+void GLRenderer::SetClipDistancesEnabled (unsigned int count)
+{
+    GLint maxClipDistances;
+    glGetIntegerv (GL_MAX_CLIP_DISTANCES, &maxClipDistances);
+
+    for (GLint i = 0; i < maxClipDistances; i++)
+    {
+        if (static_cast<unsigned int> (i) < count)
+        {
+            glEnable (GL_CLIP_DISTANCE0 + i);
+        }
+        else
+        {
+            glDisable (GL_CLIP_DISTANCE0 + i);
+        }
+    }
+}
+
 void GLRenderer::SetStencilTestEnabled (bool value)
 {
     if (value == true)
@@ -1142,6 +1360,118 @@ void GLRenderer::SetStencilTestOperation (EStencilTestOperation sFail, EStencilT
     glStencilOp (GLOp (sFail), GLOp (dpFail), GLOp (dpPass));
 }
 
+bool GLRenderer::GetMeasuredFrameTime (float& frameTime, float& renderScale)
+{
+    if (!m_isFrameTimerEnabled)
+    {
+        return Renderer::GetMeasuredFrameTime (frameTime, renderScale);
+    }
+
+    // each read back frame is used once, with the scale it was rendered at
+    frameTime = m_gpuFrameTime;
+    renderScale = m_gpuFrameRenderScale;
+
+    if (m_isGpuFrameTimeNew)
+    {
+        m_isGpuFrameTimeNew = false;
+
+        return true;
+    }
+
+    return false;
+}
+
+void GLRenderer::InitializeFrameTimerQueries ()
+{
+    // timestamp queries are core since OpenGL 3.3, debug groups since OpenGL 4.3
+    m_isFrameTimerEnabled = GLUtils::GetGLSLVersion ().versionNumber >= 330;
+    m_isDebugGroupEnabled = GLUtils::GetGLSLVersion ().versionNumber >= 430;
+
+    if (!m_isFrameTimerEnabled)
+    {
+        return;
+    }
+
+    glGenQueries (CILANTRO_BUFFERED_FRAMES * 2, &m_frameTimerQueries[0][0]);
+
+    // issue every query once, so that all of them have results before first read back (no frame is measured by them)
+    for (unsigned int i = 0; i < CILANTRO_BUFFERED_FRAMES; i++)
+    {
+        glQueryCounter (m_frameTimerQueries[i][0], GL_TIMESTAMP);
+        glQueryCounter (m_frameTimerQueries[i][1], GL_TIMESTAMP);
+        m_frameTimerRenderScales[i] = 0.0f;
+    }
+}
+
+void GLRenderer::DeinitializeFrameTimerQueries ()
+{
+    if (m_isFrameTimerEnabled)
+    {
+        glDeleteQueries (CILANTRO_BUFFERED_FRAMES * 2, &m_frameTimerQueries[0][0]);
+        m_isFrameTimerEnabled = false;
+    }
+
+    for (auto&& timer : m_renderStageTimers)
+    {
+        glDeleteQueries (CILANTRO_BUFFERED_FRAMES, timer.second.queries);
+    }
+
+    m_renderStageTimers.clear ();
+}
+
+void GLRenderer::BeginRenderStage (handle_t renderStageHandle, const std::string& renderStageName)
+{
+    GLuint64 elapsedTime;
+    GLint isAvailable = GL_FALSE;
+
+    if (m_isDebugGroupEnabled)
+    {
+        glPushDebugGroup (GL_DEBUG_SOURCE_APPLICATION, static_cast<GLuint> (renderStageHandle), static_cast<GLsizei> (renderStageName.size ()), renderStageName.c_str ());
+    }
+
+    if (!m_isFrameTimerEnabled)
+    {
+        return;
+    }
+
+    // queries are created with first run of stage
+    auto timer = m_renderStageTimers.find (renderStageHandle);
+    if (timer == m_renderStageTimers.end ())
+    {
+        timer = m_renderStageTimers.insert ({ renderStageHandle, SGlRenderStageTimer () }).first;
+        glGenQueries (CILANTRO_BUFFERED_FRAMES, timer->second.queries);
+        std::fill (timer->second.isIssued, timer->second.isIssued + CILANTRO_BUFFERED_FRAMES, false);
+    }
+
+    // read back result of CILANTRO_BUFFERED_FRAMES ago (dropped if not ready yet, so that pipeline never stalls)
+    GLuint query = timer->second.queries[m_frameTimerIndex];
+    if (timer->second.isIssued[m_frameTimerIndex])
+    {
+        glGetQueryObjectiv (query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (isAvailable == GL_TRUE)
+        {
+            glGetQueryObjectui64v (query, GL_QUERY_RESULT, &elapsedTime);
+            UpdateRenderStageGPUTime (renderStageHandle, static_cast<float> (elapsedTime) * 1.0e-9f);
+        }
+    }
+
+    glBeginQuery (GL_TIME_ELAPSED, query);
+    timer->second.isIssued[m_frameTimerIndex] = true;
+}
+
+void GLRenderer::EndRenderStage (handle_t /*renderStageHandle*/)
+{
+    if (m_isFrameTimerEnabled)
+    {
+        glEndQuery (GL_TIME_ELAPSED);
+    }
+
+    if (m_isDebugGroupEnabled)
+    {
+        glPopDebugGroup ();
+    }
+}
+
 void GLRenderer::InitializeShaderLibrary ()
 {
     std::shared_ptr<GLShaderProgram> p;
@@ -1149,6 +1479,7 @@ void GLRenderer::InitializeShaderLibrary ()
     // load standard shaders
     GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("default_vertex_shader", "shaders/default.vs", EShaderType::VERTEX_SHADER);
     GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("flatquad_vertex_shader", "shaders/flatquad.vs", EShaderType::VERTEX_SHADER);
+    GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("lightvolume_vertex_shader", "shaders/lightvolume.vs", EShaderType::VERTEX_SHADER);
     GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("pbr_forward_fragment_shader", "shaders/pbr_forward.fs", EShaderType::FRAGMENT_SHADER);    
     GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("pbr_deferred_geometrypass_fragment_shader", "shaders/pbr_deferred_geometrypass.fs", EShaderType::FRAGMENT_SHADER); 
     GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("pbr_deferred_lightingpass_fragment_shader", "shaders/pbr_deferred_lightingpass.fs", EShaderType::FRAGMENT_SHADER); 
@@ -1170,314 +1501,525 @@ void GLRenderer::InitializeShaderLibrary ()
     {
         GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("aabb_compute_shader", "shaders/aabb.cs", EShaderType::COMPUTE_SHADER);
     }
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        GetGameScene ()->GetGame ()->GetResourceManager ()->Load<GLShader> ("cull_compute_shader", "shaders/cull.cs", EShaderType::COMPUTE_SHADER);
+    }
+
+    // programs are only described here; they are compiled and linked when first used or prepared
 
     // PBR model (forward)
-    p = Create<GLShaderProgram> ("pbr_forward_shader");
+    p = Create<GLShaderProgram> ("pbr_forward_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("default_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("pbr_forward_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vNormal");
-        glBindAttribLocation (p->GetProgramId (), 2, "vUV");
-        glBindAttribLocation (p->GetProgramId (), 3, "vTangent");
-        glBindAttribLocation (p->GetProgramId (), 4, "vBitangent");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vNormal");
+        p->BindAttribLocation (2, "vUV");
+        p->BindAttribLocation (3, "vTangent");
+        p->BindAttribLocation (4, "vBitangent");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tAlbedo"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tMetallic"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tRoughness"), 3);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tAO"), 4);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
-    }
-    p->BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
-    p->BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
-    p->BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAlbedo"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tMetallic"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tRoughness"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAO"), 4);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // PBR model (deferred, geometry pass)
-    p = Create<GLShaderProgram> ("pbr_deferred_geometrypass_shader");
+    p = Create<GLShaderProgram> ("pbr_deferred_geometrypass_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("default_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("pbr_deferred_geometrypass_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vNormal");
-        glBindAttribLocation (p->GetProgramId (), 2, "vUV");
-        glBindAttribLocation (p->GetProgramId (), 3, "vTangent");
-        glBindAttribLocation (p->GetProgramId (), 4, "vBitangent");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vNormal");
+        p->BindAttribLocation (2, "vUV");
+        p->BindAttribLocation (3, "vTangent");
+        p->BindAttribLocation (4, "vBitangent");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tAlbedo"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tMetallic"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tRoughness"), 3);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tAO"), 4);
-    }
-    p->BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAlbedo"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tMetallic"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tRoughness"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAO"), 4);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // PBR model (deferred, lighting pass)
-    p = Create<GLShaderProgram> ("pbr_deferred_lightingpass_shader");
+    p = Create<GLShaderProgram> ("pbr_deferred_lightingpass_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("pbr_deferred_lightingpass_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation(p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation(p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tPosition"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tAlbedo"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tMetallicRoughnessAO"), 3);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tUnused"), 4);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
-    }
-    p->BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
-    p->BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);  
-    p->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAlbedo"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tMetallicRoughnessAO"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tUnused"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDepth"), CILANTRO_GBUFFER_DEPTH_BINDING);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+    });
+
+    // PBR model (deferred, lighting pass with light volumes)
+    p = Create<GLShaderProgram> ("pbr_deferred_lightingpass_lightvolume_shader", m_programBinaryCache);
+    p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("lightvolume_vertex_shader"));
+    p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("pbr_deferred_lightingpass_fragment_shader"));
+    if (GLUtils::GetGLSLVersion ().versionNumber < 330)
+    {
+        p->BindAttribLocation (0, "vPosition");
+    }
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tAlbedo"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tMetallicRoughnessAO"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tUnused"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDepth"), CILANTRO_GBUFFER_DEPTH_BINDING);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+    });
 
     // Blinn-Phong model (forward)
-    p = Create<GLShaderProgram> ("blinnphong_forward_shader");
+    p = Create<GLShaderProgram> ("blinnphong_forward_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("default_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("blinnphong_forward_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation(p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation(p->GetProgramId (), 1, "vNormal");
-        glBindAttribLocation(p->GetProgramId (), 2, "vUV");
-        glBindAttribLocation(p->GetProgramId (), 3, "vTangent");
-        glBindAttribLocation(p->GetProgramId (), 4, "vBitangent");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vNormal");
+        p->BindAttribLocation (2, "vUV");
+        p->BindAttribLocation (3, "vTangent");
+        p->BindAttribLocation (4, "vBitangent");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tDiffuse"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tSpecular"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tEmissive"), 3);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING); 
-    }
-    p->BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
-    p->BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
-    p->BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS); 
-    p->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDiffuse"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tSpecular"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tEmissive"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        program.BindUniformBlock ("UniformMaterialBlock", EGlUBOType::UBO_MATERIALS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
     
     // Blinn-Phong model (deferred, geometry pass)
-    p = Create<GLShaderProgram> ("blinnphong_deferred_geometrypass_shader");
+    p = Create<GLShaderProgram> ("blinnphong_deferred_geometrypass_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("default_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("blinnphong_deferred_geometrypass_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation(p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation(p->GetProgramId (), 1, "vNormal");
-        glBindAttribLocation(p->GetProgramId (), 2, "vUV");
-        glBindAttribLocation(p->GetProgramId (), 3, "vTangent");
-        glBindAttribLocation(p->GetProgramId (), 4, "vBitangent");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vNormal");
+        p->BindAttribLocation (2, "vUV");
+        p->BindAttribLocation (3, "vTangent");
+        p->BindAttribLocation (4, "vBitangent");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tDiffuse"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tSpecular"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tEmissive"), 3);
-    }    
-    p->BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDiffuse"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tSpecular"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tEmissive"), 3);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        program.BindUniformBlock ("UniformMaterialBlock", EGlUBOType::UBO_MATERIALS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // Blinn-Phong model (deferred, lighting pass)
-    p = Create<GLShaderProgram> ("blinnphong_deferred_lightingpass_shader");
+    p = Create<GLShaderProgram> ("blinnphong_deferred_lightingpass_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("blinnphong_deferred_lightingpass_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation(p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation(p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tPosition"), 0);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tNormal"), 1);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tDiffuse"), 2);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tEmissive"), 3);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tSpecular"), 4);
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
-    }
-    p->BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
-    p->BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
-    p->BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);   
-    p->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES); 
-    p->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDiffuse"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tSpecular"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tEmissive"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDepth"), CILANTRO_GBUFFER_DEPTH_BINDING);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+    });
+
+    // Blinn-Phong model (deferred, lighting pass with light volumes)
+    p = Create<GLShaderProgram> ("blinnphong_deferred_lightingpass_lightvolume_shader", m_programBinaryCache);
+    p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("lightvolume_vertex_shader"));
+    p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("blinnphong_deferred_lightingpass_fragment_shader"));
+    if (GLUtils::GetGLSLVersion ().versionNumber < 330)
+    {
+        p->BindAttribLocation (0, "vPosition");
+    }
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tNormal"), 0);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDiffuse"), 1);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tSpecular"), 2);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tEmissive"), 3);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tDepth"), CILANTRO_GBUFFER_DEPTH_BINDING);
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "tShadowMap"), CILANTRO_SHADOW_MAP_BINDING);
+        }
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+        program.BindUniformBlock ("UniformDirectionalLightsBlock", EGlUBOType::UBO_DIRECTIONALLIGHTS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("PointLightsBlock", EGlSSBOType::SSBO_POINTLIGHTS);
+            program.BindShaderStorageBlock ("SpotLightsBlock", EGlSSBOType::SSBO_SPOTLIGHTS);
+            program.BindShaderStorageBlock ("LightClustersBlock", EGlSSBOType::SSBO_LIGHTCLUSTERS);
+            program.BindShaderStorageBlock ("LightIndicesBlock", EGlSSBOType::SSBO_LIGHTINDICES);
+        }
+        else
+        {
+            program.BindUniformBlock ("UniformPointLightsBlock", EGlUBOType::UBO_POINTLIGHTS);
+            program.BindUniformBlock ("UniformSpotLightsBlock", EGlUBOType::UBO_SPOTLIGHTS);
+        }
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+    });
 
     // Screen quad rendering
-    p = Create<GLShaderProgram> ("flatquad_shader");
+    p = Create<GLShaderProgram> ("flatquad_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_fragment_shader"));   
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "fScreenTexture"), 0);
-    }
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "fScreenTexture"), 0);
+        }
+    });
 
     // Post-processing HDR
-    p = Create<GLShaderProgram> ("post_hdr_shader");
+    p = Create<GLShaderProgram> ("post_hdr_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("post_hdr_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "fScreenTexture"), 0);
-    }
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "fScreenTexture"), 0);
+        }
+    });
 
     // Post-processing gamma
-    p = Create<GLShaderProgram> ("post_gamma_shader");
+    p = Create<GLShaderProgram> ("post_gamma_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("post_gamma_fragment_shader"));   
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "fScreenTexture"), 0);
-    }
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "fScreenTexture"), 0);
+        }
+    });
 
     // Post-processing fxaa
-    p = Create<GLShaderProgram> ("post_fxaa_shader");
+    p = Create<GLShaderProgram> ("post_fxaa_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("flatquad_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("post_fxaa_fragment_shader"));   
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
-        glBindAttribLocation (p->GetProgramId (), 1, "vTextureCoordinates");
+        p->BindAttribLocation (0, "vPosition");
+        p->BindAttribLocation (1, "vTextureCoordinates");
     }
-    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    p->SetLinkCallback ([] (GLShaderProgram& program)
     {
-        glUniform1i (glGetUniformLocation (p->GetProgramId (), "fScreenTexture"), 0);
-    }
-    GLUtils::CheckGLError (MSG_LOCATION);
+        program.Use ();
+        if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+        {
+            glUniform1i (glGetUniformLocation (program.GetProgramId (), "fScreenTexture"), 0);
+        }
+    });
 
     // Shadow map (directional)
-    p = Create<GLShaderProgram> ("shadowmap_directional_shader");
+    p = Create<GLShaderProgram> ("shadowmap_directional_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_directional_geometry_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_fragment_shader"));
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
+        p->BindAttribLocation (0, "vPosition");
     }
-    p->BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        program.BindUniformBlock ("UniformDirectionalLightViewMatricesBlock", EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // Shadow map (spot)
-    p = Create<GLShaderProgram> ("shadowmap_spot_shader");
+    p = Create<GLShaderProgram> ("shadowmap_spot_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_spot_geometry_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_fragment_shader"));
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
+        p->BindAttribLocation (0, "vPosition");
     }
-    p->BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        program.BindUniformBlock ("UniformSpotLightViewMatricesBlock", EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // Shadow map (point)
-    p = Create<GLShaderProgram> ("shadowmap_point_shader");
+    p = Create<GLShaderProgram> ("shadowmap_point_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_point_geometry_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("shadowmap_fragment_shader"));
-    p->Link ();
-    p->Use (); 
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
+        p->BindAttribLocation (0, "vPosition");
     }
-    p->BindUniformBlock ("UniformPointLightViewMatricesBlock", EGlUBOType::UBO_POINTLIGHTVIEWMATRICES);
-    p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-    GLUtils::CheckGLError (MSG_LOCATION);
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        program.BindUniformBlock ("UniformPointLightViewMatricesBlock", EGlUBOType::UBO_POINTLIGHTVIEWMATRICES);
+        program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+        {
+            program.BindShaderStorageBlock ("InstanceTransformsBlock", EGlSSBOType::SSBO_INSTANCETRANSFORMS);
+        }
+        if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+        {
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+        }
+    });
 
     // AABB rendering
-    p = Create<GLShaderProgram> ("aabb_shader");
+    p = Create<GLShaderProgram> ("aabb_shader", m_programBinaryCache);
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("aabb_vertex_shader"));
     p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("aabb_fragment_shader"));
-    p->Link ();
-    p->Use ();
     if (GLUtils::GetGLSLVersion ().versionNumber < 330)
     {
-        glBindAttribLocation (p->GetProgramId (), 0, "vPosition");
+        p->BindAttribLocation (0, "vPosition");
     }
-    p->BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
-    GLUtils::CheckGLError (MSG_LOCATION);
+    p->SetLinkCallback ([] (GLShaderProgram& program)
+    {
+        program.Use ();
+        program.BindUniformBlock ("UniformMatricesBlock", EGlUBOType::UBO_MATRICES);
+    });
 
     if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
     { 
         // AABB compute shader
-        p = Create<GLShaderProgram> ("aabb_compute_shader");
+        p = Create<GLShaderProgram> ("aabb_compute_shader", m_programBinaryCache);
         p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("aabb_compute_shader"));
-        p->Link ();
-        p->Use ();
-        p->BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
-        p->BindShaderStorageBlock ("VertexBufferBlock", EGlSSBOType::SSBO_VERTICES);  
-        p->BindShaderStorageBlock ("BoneIndicesBufferBlock", EGlSSBOType::SSBO_BONEINDICES);
-        p->BindShaderStorageBlock ("BoneWeightsBufferBlock", EGlSSBOType::SSBO_BONEWEIGHTS);
-        p->BindShaderStorageBlock ("AABBBufferBlock", EGlSSBOType::SSBO_AABB);
-        GLUtils::CheckGLError (MSG_LOCATION);
+        p->SetLinkCallback ([] (GLShaderProgram& program)
+        {
+            program.Use ();
+            program.BindUniformBlock ("UniformBoneTransformationsBlock", EGlUBOType::UBO_BONETRANSFORMATIONS);
+            program.BindShaderStorageBlock ("VertexBufferBlock", EGlSSBOType::SSBO_VERTICES);
+            program.BindShaderStorageBlock ("BoneIndicesBufferBlock", EGlSSBOType::SSBO_BONEINDICES);
+            program.BindShaderStorageBlock ("BoneWeightsBufferBlock", EGlSSBOType::SSBO_BONEWEIGHTS);
+            program.BindShaderStorageBlock ("AABBBufferBlock", EGlSSBOType::SSBO_AABB);
+        });
+    }
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        // frustum culling of indirect draws
+        p = Create<GLShaderProgram> ("cull_compute_shader", m_programBinaryCache);
+        p->AttachShader (GetGameScene ()->GetGame ()->GetResourceManager ()->GetByName<GLShader>("cull_compute_shader"));
+        p->SetLinkCallback ([] (GLShaderProgram& program)
+        {
+            program.Use ();
+            program.BindShaderStorageBlock ("ObjectTransformsBlock", EGlSSBOType::SSBO_OBJECTTRANSFORMS);
+            program.BindShaderStorageBlock ("CullObjectsBlock", EGlSSBOType::SSBO_CULLOBJECTS);
+            program.BindShaderStorageBlock ("DrawCommandsBlock", EGlSSBOType::SSBO_DRAWCOMMANDS);
+        });
     }
 
 }
@@ -1504,10 +2046,14 @@ void GLRenderer::LoadMatrixUniformBuffers (std::shared_ptr<Camera> camera)
     // load projection matrix
     std::memcpy (m_uniformMatrixBuffer->projectionMatrix, Mathf::Transpose (projection)[0], 16 * sizeof (GLfloat));
 
-    // load to GPU - view and projection
+    // load inverse view-projection matrix
+    std::memcpy (m_uniformMatrixBuffer->inverseViewProjectionMatrix, Mathf::Transpose (Mathf::Invert (projection * view))[0], 16 * sizeof (GLfloat));
+
+    // load to GPU - view, projection and inverse view-projection
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_MATRICES]);
     glBufferSubData (GL_UNIFORM_BUFFER, 0, 16 * sizeof (GLfloat), m_uniformMatrixBuffer->viewMatrix);
     glBufferSubData (GL_UNIFORM_BUFFER, 16 * sizeof (GLfloat), 16 * sizeof (GLfloat), m_uniformMatrixBuffer->projectionMatrix);
+    glBufferSubData (GL_UNIFORM_BUFFER, 32 * sizeof (GLfloat), 16 * sizeof (GLfloat), m_uniformMatrixBuffer->inverseViewProjectionMatrix);
     glBindBuffer (GL_UNIFORM_BUFFER, 0);
 }
 
@@ -1518,21 +2064,21 @@ void GLRenderer::DeinitializeMatrixUniformBuffers ()
 
 void GLRenderer::InitializeLightViewMatrixUniformBuffers ()
 {
-    // create unform buffers for light view transforms
+    // create unform buffers for light view transforms (followed by shadow atlas tiles of lights, directional lights are followed by splits of their cascades and camera depth plane)
 
     glGenBuffers (1, &m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTVIEWMATRICES]);
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTVIEWMATRICES]);
-    glBufferData (GL_UNIFORM_BUFFER, 16 * sizeof (GLfloat) * CILANTRO_MAX_DIRECTIONAL_LIGHTS, NULL, GL_DYNAMIC_DRAW);
+    glBufferData (GL_UNIFORM_BUFFER, ((16 + 4 + 1) * CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS + 4) * sizeof (GLfloat), NULL, GL_DYNAMIC_DRAW);
     glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_DIRECTIONALLIGHTVIEWMATRICES), m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTVIEWMATRICES]);
 
     glGenBuffers (1, &m_uniformBuffers->UBO[UBO_SPOTLIGHTVIEWMATRICES]);
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTVIEWMATRICES]);
-    glBufferData (GL_UNIFORM_BUFFER, 16 * sizeof (GLfloat) * CILANTRO_MAX_SPOT_LIGHTS, NULL, GL_DYNAMIC_DRAW);
+    glBufferData (GL_UNIFORM_BUFFER, (16 + 4) * sizeof (GLfloat) * CILANTRO_MAX_SPOT_LIGHTS, NULL, GL_DYNAMIC_DRAW);
     glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES), m_uniformBuffers->UBO[UBO_SPOTLIGHTVIEWMATRICES]);
 
     glGenBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTVIEWMATRICES]);
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTVIEWMATRICES]);
-    glBufferData (GL_UNIFORM_BUFFER, 6 * 16 * sizeof (GLfloat) * CILANTRO_MAX_POINT_LIGHTS, NULL, GL_DYNAMIC_DRAW);
+    glBufferData (GL_UNIFORM_BUFFER, 6 * (16 + 4) * sizeof (GLfloat) * CILANTRO_MAX_POINT_LIGHTS, NULL, GL_DYNAMIC_DRAW);
     glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_POINTLIGHTVIEWMATRICES), m_uniformBuffers->UBO[UBO_POINTLIGHTVIEWMATRICES]);
 
     GLUtils::CheckGLError (MSG_LOCATION);
@@ -1540,68 +2086,181 @@ void GLRenderer::InitializeLightViewMatrixUniformBuffers ()
 
 void GLRenderer::LoadLightViewMatrixUniformBuffers ()
 {
-    auto frustumVertices = GetGameScene ()->GetActiveCamera ()->GetFrustumVertices (m_width, m_height);
+    auto camera = GetGameScene ()->GetActiveCamera ();
+    auto frustumVertices = camera->GetFrustumVertices (m_width, m_height);
     AABB sceneAABB = GetGameScene ()->GetGameObjectManager ()->GetByName<GameObject> ("root")->GetHierarchyAABB ();
 
-    // calculate and load lightview matrix for each directional light
-    for (auto&& light : m_directionalLights)
+    // only lights fitting into light view matrices buffers cast shadows
+    size_t directionalLightCount = std::min (GetDirectionalLightCount (), static_cast<size_t>(CILANTRO_MAX_DIRECTIONAL_LIGHTS));
+    size_t spotLightCount = std::min (GetSpotLightCount (), static_cast<size_t>(CILANTRO_MAX_SPOT_LIGHTS));
+    size_t pointLightCount = std::min (GetPointLightCount (), static_cast<size_t>(CILANTRO_MAX_POINT_LIGHTS));
+
+    // view of active camera to size tiles of lights by their screen coverage and to split directional lights into cascades
+    Matrix4f view = camera->GetViewMatrix ();
+    Matrix4f projection = camera->GetProjectionMatrix (m_width, m_height);
+    float nearPlane, farPlane;
+    CalculateViewDepthRange (camera, nearPlane, farPlane);
+
+    // view depth of fragments is distance from this plane (negated z axis of view space)
+    for (int i = 0; i < 4; i++)
     {
-        // generate matrix
-        auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<DirectionalLight> (light.first);
-        Matrix4f lightViewProjection = l->GenLightViewProjectionMatrix (frustumVertices, sceneAABB);
+        m_uniformLightViewMatrixBuffer->cascadeDepthPlane[i] = -view[2][i];
+    }
 
-        // copy to buffer
-        std::memcpy (m_uniformLightViewMatrixBuffer->directionalLightView + light.second * 16, Mathf::Transpose (lightViewProjection)[0], 16 * sizeof (GLfloat));
+    // contents of atlas are lost when shadow map framebuffer (bound with its viewport by shadow map stage) is resized
+    if (m_viewport[2] != m_shadowAtlasResolution)
+    {
+        m_shadowAtlasResolution = m_viewport[2];
+        m_isShadowAtlasInvalid = true;
     }
 
-    // calculate and load lightview matrix for each spot light
-    for (auto&& light : m_spotLights)
+    // release tiles of removed lights
+    auto resizeTiles = [&](std::vector<SGlShadowTile>& tiles, size_t tileCount)
     {
-        // generate matrix
-        auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<SpotLight> (light.first);
-        Matrix4f lightViewProjection = l->GenLightViewProjectionMatrix (frustumVertices, sceneAABB, false, l->GetOuterCutoff () * 2.0f, l->GetBoundingSphereRadius (0.01f));
+        for (size_t i = tileCount; i < tiles.size (); i++)
+        {
+            m_shadowAtlas.Free (tiles[i].region);
+        }
 
-        // copy to buffer
-        std::memcpy (m_uniformLightViewMatrixBuffer->spotLightView + light.second * 16, Mathf::Transpose (lightViewProjection)[0], 16 * sizeof (GLfloat));
-    }
+        tiles.resize (tileCount, SGlShadowTile { { 0, 0, 0 }, false });
+    };
 
-    // calculate and load 6 lightview matrices for each point light
-    for (auto&& light : m_pointLights)
+    resizeTiles (m_directionalLightShadowTiles, directionalLightCount * CILANTRO_MAX_SHADOW_CASCADES);
+    resizeTiles (m_spotLightShadowTiles, spotLightCount);
+    resizeTiles (m_pointLightShadowTiles, pointLightCount * 6);
+
+    // repack atlas and retry once if it is too fragmented to fit all tiles
+    for (int pass = 0; pass < 2; pass++)
     {
-        // generate matrices
-        auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<PointLight> (light.first);
-        Vector3f lightPosition = l->GetPosition ();
-        Matrix4f lightProjection = Mathf::GenPerspectiveProjectionMatrix (1.0f, Mathf::Deg2Rad (90.0f), l->GetEscapeRadius (), l->GetBoundingSphereRadius (0.01f));
+        bool isAllocated = true;
+
+        // calculate lightview matrix for each cascade of each directional light
+        for (auto&& light : m_directionalLights)
+        {
+            if (light.second >= directionalLightCount)
+            {
+                continue;
+            }
+
+            auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<DirectionalLight> (light.first);
+            unsigned int cascadeCount = l->GetShadowCascadeCount ();
+            GLfloat* cascadeSplits = m_uniformLightViewMatrixBuffer->directionalLightCascadeSplits + light.second * CILANTRO_MAX_SHADOW_CASCADES;
+
+            for (unsigned int c = 0; c < CILANTRO_MAX_SHADOW_CASCADES; c++)
+            {
+                size_t idx = light.second * CILANTRO_MAX_SHADOW_CASCADES + c;
+                GLfloat* bufferTile = m_uniformLightViewMatrixBuffer->directionalLightTile + idx * 4;
+
+                // unused cascades have no tile
+                if (c >= cascadeCount)
+                {
+                    m_shadowAtlas.Free (m_directionalLightShadowTiles[idx].region);
+                    m_directionalLightShadowTiles[idx] = SGlShadowTile { { 0, 0, 0 }, false };
+                    std::fill (bufferTile, bufferTile + 4, 0.0f);
+                    cascadeSplits[c] = cascadeSplits[cascadeCount - 1];
+
+                    continue;
+                }
+
+                // generate matrix
+                Matrix4f lightViewProjection = l->GenCascadeViewProjectionMatrix (frustumVertices, nearPlane, farPlane, c, sceneAABB, CILANTRO_SHADOW_CASCADE_TILE_SIZE);
+                cascadeSplits[c] = l->GetShadowCascadeSplit (c + 1, nearPlane, farPlane);
+
+                // copy to buffer
+                isAllocated &= UpdateShadowTile (m_directionalLightShadowTiles[idx], CILANTRO_SHADOW_CASCADE_TILE_SIZE, lightViewProjection, true, 
+                    m_uniformLightViewMatrixBuffer->directionalLightView + idx * 16, bufferTile);
+            }
+        }
+
+        // calculate lightview matrix for each spot light
+        for (auto&& light : m_spotLights)
+        {
+            if (light.second >= spotLightCount)
+            {
+                continue;
+            }
+
+            // generate matrix
+            auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<SpotLight> (light.first);
+            Matrix4f lightViewProjection = l->GenLightViewProjectionMatrix (frustumVertices, sceneAABB, false, l->GetOuterCutoff () * 2.0f, l->GetBoundingSphereRadius (0.01f));
+            unsigned int tileSize = CalculateShadowTileSize (view, projection, nearPlane, farPlane, m_uniformSpotLightBuffer->spotLights[light.second].lightPosition, m_spotLightRadii[light.second]);
+            bool isVisible = IsLightInView (m_uniformSpotLightBuffer->spotLights[light.second].lightPosition, m_spotLightRadii[light.second]);
+
+            // copy to buffer
+            isAllocated &= UpdateShadowTile (m_spotLightShadowTiles[light.second], tileSize, lightViewProjection, isVisible, 
+                m_uniformLightViewMatrixBuffer->spotLightView + light.second * 16, m_uniformLightViewMatrixBuffer->spotLightTile + light.second * 4);
+        }
+
+        // calculate 6 lightview matrices for each point light
+        for (auto&& light : m_pointLights)
+        {
+            if (light.second >= pointLightCount)
+            {
+                continue;
+            }
+
+            // generate matrices
+            auto l = GetGameScene ()->GetGameObjectManager ()->GetByHandle<PointLight> (light.first);
+            Vector3f lightPosition = l->GetPosition ();
+            Matrix4f lightProjection = Mathf::GenPerspectiveProjectionMatrix (1.0f, Mathf::Deg2Rad (90.0f), l->GetEscapeRadius (), l->GetBoundingSphereRadius (0.01f));
+            unsigned int tileSize = CalculateShadowTileSize (view, projection, nearPlane, farPlane, m_uniformPointLightBuffer->pointLights[light.second].lightPosition, m_pointLightRadii[light.second]);
+            bool isVisible = IsLightInView (m_uniformPointLightBuffer->pointLights[light.second].lightPosition, m_pointLightRadii[light.second]);
+
+            std::array<Matrix4f, 6> lightViews = {
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (1.0f, 0.0f, 0.0f), Vector3f (0.0f, -1.0f, 0.0f)),
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (-1.0f, 0.0f, 0.0f), Vector3f (0.0f, -1.0f, 0.0f)),
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 1.0f, 0.0f), Vector3f (0.0f, 0.0f, 1.0f)),
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, -1.0f, 0.0f), Vector3f (0.0f, 0.0f, -1.0f)),
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 0.0f, 1.0f), Vector3f (0.0f, -1.0f, 0.0f)),
+                Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 0.0f, -1.0f), Vector3f (0.0f, -1.0f, 0.0f))
+            };
+
+            // copy to buffer (right, left, top, bottom, front, back)
+            for (size_t f = 0; f < 6; f++)
+            {
+                size_t idx = light.second * 6 + f;
+                isAllocated &= UpdateShadowTile (m_pointLightShadowTiles[idx], tileSize, lightProjection * lightViews[f], isVisible, 
+                    m_uniformLightViewMatrixBuffer->pointLightView + idx * 16, m_uniformLightViewMatrixBuffer->pointLightTile + idx * 4);
+            }
+        }
 
-        Matrix4f lightViewRight = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (1.0f, 0.0f, 0.0f), Vector3f (0.0f, -1.0f, 0.0f));
-        Matrix4f lightViewLeft = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (-1.0f, 0.0f, 0.0f), Vector3f (0.0f, -1.0f, 0.0f));
-        Matrix4f lightViewTop = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 1.0f, 0.0f), Vector3f (0.0f, 0.0f, 1.0f));
-        Matrix4f lightViewBottom = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, -1.0f, 0.0f), Vector3f (0.0f, 0.0f, -1.0f));
-        Matrix4f lightViewFront = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 0.0f, 1.0f), Vector3f (0.0f, -1.0f, 0.0f));
-        Matrix4f lightViewBack = Mathf::GenCameraViewMatrix (lightPosition, lightPosition + Vector3f (0.0f, 0.0f, -1.0f), Vector3f (0.0f, -1.0f, 0.0f));
+        if (isAllocated)
+        {
+            break;
+        }
 
-        // copy to buffer
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 0 * 16, Mathf::Transpose (lightProjection * lightViewRight)[0], 16 * sizeof (GLfloat));
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 1 * 16, Mathf::Transpose (lightProjection * lightViewLeft)[0], 16 * sizeof (GLfloat));
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 2 * 16, Mathf::Transpose (lightProjection * lightViewTop)[0], 16 * sizeof (GLfloat));
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 3 * 16, Mathf::Transpose (lightProjection * lightViewBottom)[0], 16 * sizeof (GLfloat));
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 4 * 16, Mathf::Transpose (lightProjection * lightViewFront)[0], 16 * sizeof (GLfloat));
-        std::memcpy (m_uniformLightViewMatrixBuffer->pointLightView + light.second * 6 * 16 + 5 * 16, Mathf::Transpose (lightProjection * lightViewBack)[0], 16 * sizeof (GLfloat));
+        RepackShadowAtlas ();
     }
 
+    m_changedShadowCasterBounds.clear ();
+    m_isShadowAtlasInvalid = false;
+
+    // find meshes casting shadows into redrawn tiles
+    CullShadowCasters (directionalLightCount, spotLightCount, pointLightCount);
+
+    // clear tiles redrawn in this frame
+    ClearShadowTiles (m_uniformLightViewMatrixBuffer->directionalLightTile, directionalLightCount * CILANTRO_MAX_SHADOW_CASCADES);
+    ClearShadowTiles (m_uniformLightViewMatrixBuffer->spotLightTile, spotLightCount);
+    ClearShadowTiles (m_uniformLightViewMatrixBuffer->pointLightTile, pointLightCount * 6);
+
     // load to GPU - directional light view
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTVIEWMATRICES]);
-    glBufferSubData (GL_UNIFORM_BUFFER, 0, 16 * sizeof (GLfloat) * m_uniformDirectionalLightBuffer->directionalLightCount, m_uniformLightViewMatrixBuffer->directionalLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, 0, CILANTRO_MAX_SHADOW_CASCADES * 16 * sizeof (GLfloat) * directionalLightCount, m_uniformLightViewMatrixBuffer->directionalLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS * 16 * sizeof (GLfloat), CILANTRO_MAX_SHADOW_CASCADES * 4 * sizeof (GLfloat) * directionalLightCount, m_uniformLightViewMatrixBuffer->directionalLightTile);
+    glBufferSubData (GL_UNIFORM_BUFFER, CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS * (16 + 4) * sizeof (GLfloat), CILANTRO_MAX_SHADOW_CASCADES * sizeof (GLfloat) * directionalLightCount, m_uniformLightViewMatrixBuffer->directionalLightCascadeSplits);
+    glBufferSubData (GL_UNIFORM_BUFFER, CILANTRO_MAX_SHADOW_CASCADES * CILANTRO_MAX_DIRECTIONAL_LIGHTS * (16 + 4 + 1) * sizeof (GLfloat), 4 * sizeof (GLfloat), m_uniformLightViewMatrixBuffer->cascadeDepthPlane);
     glBindBuffer (GL_UNIFORM_BUFFER, 0);
 
     // load to GPU - spot light view
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTVIEWMATRICES]);
-    glBufferSubData (GL_UNIFORM_BUFFER, 0, 16 * sizeof (GLfloat) * m_uniformSpotLightBuffer->spotLightCount, m_uniformLightViewMatrixBuffer->spotLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, 0, 16 * sizeof (GLfloat) * spotLightCount, m_uniformLightViewMatrixBuffer->spotLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, 16 * sizeof (GLfloat) * CILANTRO_MAX_SPOT_LIGHTS, 4 * sizeof (GLfloat) * spotLightCount, m_uniformLightViewMatrixBuffer->spotLightTile);
     glBindBuffer (GL_UNIFORM_BUFFER, 0);
 
     // load to GPU - point light views
     glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTVIEWMATRICES]);
-    glBufferSubData (GL_UNIFORM_BUFFER, 0, 6 * 16 * sizeof (GLfloat) * m_uniformPointLightBuffer->pointLightCount, m_uniformLightViewMatrixBuffer->pointLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, 0, 6 * 16 * sizeof (GLfloat) * pointLightCount, m_uniformLightViewMatrixBuffer->pointLightView);
+    glBufferSubData (GL_UNIFORM_BUFFER, 6 * 16 * sizeof (GLfloat) * CILANTRO_MAX_POINT_LIGHTS, 6 * 4 * sizeof (GLfloat) * pointLightCount, m_uniformLightViewMatrixBuffer->pointLightTile);
     glBindBuffer (GL_UNIFORM_BUFFER, 0);
 
 }
@@ -1613,8 +2272,268 @@ void GLRenderer::DeinitializeLightViewMatrixUniformBuffers ()
     glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTVIEWMATRICES]);
 }
 
+void GLRenderer::CollectShadowCasterBoundsRecursive (handle_t objectHandle)
+{
+    auto object = GetGameScene ()->GetGameObjectManager ()->GetByHandle<GameObject> (objectHandle);
+
+    if (std::dynamic_pointer_cast<BoneObject> (object) != nullptr)
+    {
+        // skinned meshes deform with their bones, redraw all tiles
+        m_isShadowAtlasInvalid = true;
+    }
+    else if (std::dynamic_pointer_cast<MeshObject> (object) != nullptr)
+    {
+        // tiles overlapping both previous and current bounds need to be redrawn
+        auto find = m_shadowCasterBounds.find (objectHandle);
+        if (find != m_shadowCasterBounds.end ())
+        {
+            m_changedShadowCasterBounds.push_back (find->second);
+        }
+
+        AABB bounds = std::dynamic_pointer_cast<MeshObject> (object)->GetAABB ();
+        m_changedShadowCasterBounds.push_back (bounds);
+        m_shadowCasterBounds[objectHandle] = bounds;
+    }
+
+    for (auto&& childObject : object->GetChildren ())
+    {
+        CollectShadowCasterBoundsRecursive (childObject.lock ()->GetHandle ());
+    }
+}
+
+bool GLRenderer::IsLightInView (const GLfloat* position, float radius) const
+{
+    // lights without finite range affect whole scene
+    if (!(radius > 0.0f) || std::isinf (radius))
+    {
+        return true;
+    }
+
+    return m_viewFrustum.Intersects (Vector3f (position[0], position[1], position[2]), Vector3f (radius, radius, radius));
+}
+
+unsigned int GLRenderer::CalculateShadowTileSize (const Matrix4f& view, const Matrix4f& projection, float nearPlane, float farPlane, const GLfloat* position, float radius) const
+{
+    float ndcMin[2];
+    float ndcMax[2];
+
+    // lights not visible from camera keep only smallest tiles
+    if (!CalculateLightScreenBounds (view, projection, nearPlane, farPlane, position, radius, ndcMin, ndcMax))
+    {
+        return CILANTRO_SHADOW_MAP_MIN_TILE_SIZE;
+    }
+
+    // tile size proportional to portion of screen covered by light
+    float coverage = std::max (ndcMax[0] - ndcMin[0], ndcMax[1] - ndcMin[1]) * 0.5f;
+
+    return std::clamp (static_cast<unsigned int> (coverage * CILANTRO_SHADOW_MAP_SIZE), static_cast<unsigned int> (CILANTRO_SHADOW_MAP_MIN_TILE_SIZE), static_cast<unsigned int> (CILANTRO_SHADOW_MAP_MAX_TILE_SIZE));
+}
+
+bool GLRenderer::UpdateShadowTile (SGlShadowTile& tile, unsigned int tileSize, const Matrix4f& lightViewProjection, bool isVisible, GLfloat* bufferMatrix, GLfloat* bufferTile)
+{
+    bool isAllocated = true;
+    bool isStale = m_isShadowAtlasInvalid || tile.isPending;
+    SShadowAtlasTile& region = tile.region;
+
+    // reallocate tiles smaller than needed or 4 times larger (so that small changes of screen coverage do not move tiles)
+    tileSize = m_shadowAtlas.GetTileSize (tileSize);
+    if (region.size == 0 || tileSize > region.size || tileSize * 4 <= region.size)
+    {
+        SShadowAtlasTile previousRegion = region;
+        m_shadowAtlas.Free (region);
+
+        // fall back to smaller tiles if atlas is full
+        region = m_shadowAtlas.Allocate (tileSize);
+        while (region.size == 0 && tileSize > m_shadowAtlas.GetMinTileSize ())
+        {
+            tileSize /= 2;
+            region = m_shadowAtlas.Allocate (tileSize);
+        }
+
+        isAllocated = region.size > 0;
+        isStale |= region.x != previousRegion.x || region.y != previousRegion.y || region.size != previousRegion.size;
+    }
+
+    // light view changed
+    GLfloat matrix[16];
+    std::memcpy (matrix, Mathf::Transpose (lightViewProjection)[0], 16 * sizeof (GLfloat));
+    if (std::memcmp (bufferMatrix, matrix, 16 * sizeof (GLfloat)) != 0)
+    {
+        std::memcpy (bufferMatrix, matrix, 16 * sizeof (GLfloat));
+        isStale = true;
+    }
+
+    // shadow casters moved within light view
+    if (!isStale && !m_changedShadowCasterBounds.empty ())
+    {
+        Frustum lightFrustum (lightViewProjection);
+        isStale = std::any_of (m_changedShadowCasterBounds.begin (), m_changedShadowCasterBounds.end (), [&](const AABB& bounds) { return lightFrustum.Intersects (bounds); });
+    }
+
+    // lights not affecting the view redraw their tiles once they become visible
+    tile.isPending = isStale && !isVisible;
+
+    float atlasSize = static_cast<float> (m_shadowAtlas.GetSize ());
+    bufferTile[0] = region.x / atlasSize;
+    bufferTile[1] = region.y / atlasSize;
+    bufferTile[2] = region.size / atlasSize;
+    bufferTile[3] = (isStale && isVisible && region.size > 0) ? 1.0f : 0.0f;
+
+    return isAllocated;
+}
+
+void GLRenderer::CullShadowCasters (size_t directionalLightCount, size_t spotLightCount, size_t pointLightCount)
+{
+    auto gameScene = GetGameScene ();
+    const AABBTree& spatialIndex = gameScene->GetSpatialIndex ();
+
+    // objects outside of spatial index (skinned meshes) are drawn for every redrawn light
+    const std::vector<handle_t>& unindexedObjects = gameScene->GetUnindexedObjects ();
+
+    auto cullLight = [&](ELightType lightType, size_t lightId, const GLfloat* bufferMatrices, const GLfloat* bufferTiles, size_t tileCount)
+    {
+        auto& masks = m_shadowCasterMasks[static_cast<int> (lightType)];
+        bool isRedrawn = false;
+
+        m_queriedShadowCasters.clear ();
+        for (size_t t = 0; t < tileCount; t++)
+        {
+            const GLfloat* matrix = bufferMatrices + t * 16;
+
+            // only tiles redrawn in this frame need casters
+            if (bufferTiles[t * 4 + 3] == 0.0f)
+            {
+                continue;
+            }
+
+            // buffer holds matrices column by column
+            Matrix4f lightViewProjection (
+                Vector4f (matrix[0], matrix[1], matrix[2], matrix[3]),
+                Vector4f (matrix[4], matrix[5], matrix[6], matrix[7]),
+                Vector4f (matrix[8], matrix[9], matrix[10], matrix[11]),
+                Vector4f (matrix[12], matrix[13], matrix[14], matrix[15]));
+
+            spatialIndex.QueryFrustum (Frustum (lightViewProjection), m_queriedShadowCasters);
+            isRedrawn = true;
+        }
+
+        if (isRedrawn)
+        {
+            m_queriedShadowCasters.insert (m_queriedShadowCasters.end (), unindexedObjects.begin (), unindexedObjects.end ());
+        }
+
+        for (handle_t objectHandle : m_queriedShadowCasters)
+        {
+            // skip objects without geometry
+            if (m_sceneGeometryBuffers.find (objectHandle) == m_sceneGeometryBuffers.end ())
+            {
+                continue;
+            }
+
+            auto find = masks.find (objectHandle);
+            if (find == masks.end ())
+            {
+                m_shadowCasters[static_cast<int> (lightType)].push_back (objectHandle);
+                masks[objectHandle] = 1u << lightId;
+            }
+            else
+            {
+                find->second |= 1u << lightId;
+            }
+        }
+    };
+
+    for (int i = 0; i < 3; i++)
+    {
+        m_shadowCasters[i].clear ();
+        m_shadowCasterMasks[i].clear ();
+    }
+
+    for (size_t i = 0; i < directionalLightCount; i++)
+    {
+        cullLight (ELightType::LIGHT_DIRECTIONAL, i, m_uniformLightViewMatrixBuffer->directionalLightView + i * CILANTRO_MAX_SHADOW_CASCADES * 16, 
+            m_uniformLightViewMatrixBuffer->directionalLightTile + i * CILANTRO_MAX_SHADOW_CASCADES * 4, CILANTRO_MAX_SHADOW_CASCADES);
+    }
+
+    for (size_t i = 0; i < spotLightCount; i++)
+    {
+        cullLight (ELightType::LIGHT_SPOT, i, m_uniformLightViewMatrixBuffer->spotLightView + i * 16, m_uniformLightViewMatrixBuffer->spotLightTile + i * 4, 1);
+    }
+
+    for (size_t i = 0; i < pointLightCount; i++)
+    {
+        cullLight (ELightType::LIGHT_POINT, i, m_uniformLightViewMatrixBuffer->pointLightView + i * 6 * 16, m_uniformLightViewMatrixBuffer->pointLightTile + i * 6 * 4, 6);
+    }
+}
+
+void GLRenderer::ClearShadowTiles (const GLfloat* bufferTiles, size_t tileCount)
+{
+    glEnable (GL_SCISSOR_TEST);
+
+    for (size_t i = 0; i < tileCount; i++)
+    {
+        const GLfloat* tile = bufferTiles + i * 4;
+
+        if (tile[3] != 0.0f)
+        {
+            // tiles are in texture coordinates, shadow map framebuffer may be resized
+            GLint x = static_cast<GLint> (std::round (tile[0] * m_shadowAtlasResolution));
+            GLint y = static_cast<GLint> (std::round (tile[1] * m_shadowAtlasResolution));
+            GLsizei size = static_cast<GLsizei> (std::round (tile[2] * m_shadowAtlasResolution));
+
+            glScissor (x, y, size, size);
+            glClear (GL_DEPTH_BUFFER_BIT);
+        }
+    }
+
+    glDisable (GL_SCISSOR_TEST);
+}
+
+void GLRenderer::RepackShadowAtlas ()
+{
+    m_shadowAtlas.Clear ();
+
+    for (auto* tiles : { &m_directionalLightShadowTiles, &m_spotLightShadowTiles, &m_pointLightShadowTiles })
+    {
+        std::fill (tiles->begin (), tiles->end (), SGlShadowTile { { 0, 0, 0 }, false });
+    }
+
+    m_isShadowAtlasInvalid = true;
+}
+
 void GLRenderer::InitializeObjectBuffers ()
 {
+    // create shared geometry storage
+    m_geometryPool->Initialize ();
+
+    // create identity instance transformation for non-instanced draws
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        SGlObjectTransform identity;
+        Matrix4f identityMatrix;
+        identityMatrix.InitIdentity ();
+        LoadObjectTransform (identity, identityMatrix);
+
+        glGenBuffers (1, &m_identityInstanceTransformBuffer);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_identityInstanceTransformBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlObjectTransform), &identity, GL_STATIC_DRAW);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // create streaming buffers for indirect draws
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        m_objectTransformsRingBuffer->Initialize ();
+        m_drawCommandsRingBuffer->Initialize ();
+
+        // buffers written by culling compute shader (draw commands buffer is sized on first use)
+        glGenBuffers (1, &m_culledDrawCommandsBuffer);
+        glGenBuffers (1, &m_drawCountBuffer);
+        glBindBuffer (GL_ATOMIC_COUNTER_BUFFER, m_drawCountBuffer);
+        glBufferData (GL_ATOMIC_COUNTER_BUFFER, sizeof (GLuint), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer (GL_ATOMIC_COUNTER_BUFFER, 0);
+    }
+
     // create and load object buffers for all existing objects
     for (auto&& gameObject : GetGameScene ()->GetGameObjectManager ())
     {
@@ -1630,20 +2549,153 @@ void GLRenderer::DeinitializeObjectBuffers ()
 {
     for (auto&& buffer : m_sceneGeometryBuffers)
     {
-        glDeleteBuffers (1, &buffer.second->boneTransformationsUBO);
-        
         if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
         {
-            glDeleteBuffers (1, &buffer.second->vertexPositionsSSBO);
-            glDeleteBuffers (1, &buffer.second->boneIndicesSSBO);
-            glDeleteBuffers (1, &buffer.second->boneWeightsSSBO);
-            glDeleteBuffers (1, &buffer.second->aabbSSBO);
-        }    
+            glDeleteBuffers (1, &buffer.second->instanceTransformsSSBO);
+        }
+
+        ReleaseMeshGeometryBuffers (buffer.second->meshHandle);
+        delete buffer.second;
+    }
+
+    m_sceneGeometryBuffers.clear ();
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        glDeleteBuffers (1, &m_identityInstanceTransformBuffer);
+    }
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        m_objectTransformsRingBuffer->Deinitialize ();
+        m_drawCommandsRingBuffer->Deinitialize ();
+
+        glDeleteBuffers (1, &m_culledDrawCommandsBuffer);
+        glDeleteBuffers (1, &m_drawCountBuffer);
+    }
+
+    m_geometryPool->Deinitialize ();
+}
+
+SGlMeshGeometryBuffers* GLRenderer::AcquireMeshGeometryBuffers (std::shared_ptr<Mesh> mesh)
+{
+    auto find = m_meshGeometryBuffers.find (mesh->GetHandle ());
+
+    if (find != m_meshGeometryBuffers.end ())
+    {
+        // mesh already drawn by other object
+        find->second->referenceCount++;
+
+        return find->second;
+    }
+
+    // first object drawing the mesh, generate buffers (loaded by caller)
+    SGlMeshGeometryBuffers* g = new SGlMeshGeometryBuffers ();
+    m_meshGeometryBuffers.insert ({ mesh->GetHandle (), g });
+    g->referenceCount = 1;
+    g->meshVersion = std::numeric_limits<size_t>::max ();
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        // generate AABB compute shader input SSBO buffers
+        glGenBuffers (1, &g->vertexPositionsSSBO);
+        glGenBuffers (1, &g->boneIndicesSSBO);
+        glGenBuffers (1, &g->boneWeightsSSBO);
+
+        // generate AABB result SSBO buffer
+        glGenBuffers (1, &g->aabbSSBO);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, g->aabbSSBO);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlEncodedAABB), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    return g;
+}
+
+void GLRenderer::LoadMeshGeometryBuffers (std::shared_ptr<Mesh> mesh, SGlMeshGeometryBuffers* buffers)
+{
+    size_t vertexCount = mesh->GetVertexCount ();
+    std::vector<SGlVertex> vertices (vertexCount);
+
+    // release previous space in geometry pool (nothing is allocated before first load) and reserve space for current mesh
+    m_geometryPool->Free (buffers->geometryAllocation);
+    buffers->geometryAllocation = m_geometryPool->Allocate (vertexCount, mesh->GetIndexCount ());
+
+    // interleave vertex data (missing attributes are left zeroed)
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        std::memcpy (vertices[v].position, mesh->GetVerticesData () + v * 3, 3 * sizeof (GLfloat));
+
+        if (mesh->GetNormalsData () != nullptr)
+        {
+            std::memcpy (vertices[v].normal, mesh->GetNormalsData () + v * 3, 3 * sizeof (GLfloat));
+        }
+
+        if (mesh->GetUVData () != nullptr)
+        {
+            std::memcpy (vertices[v].uv, mesh->GetUVData () + v * 2, 2 * sizeof (GLfloat));
+        }
+
+        if (mesh->GetTangentData () != nullptr)
+        {
+            std::memcpy (vertices[v].tangent, mesh->GetTangentData () + v * 3, 3 * sizeof (GLfloat));
+        }
+
+        if (mesh->GetBitangentData () != nullptr)
+        {
+            std::memcpy (vertices[v].bitangent, mesh->GetBitangentData () + v * 3, 3 * sizeof (GLfloat));
+        }
+
+        std::memcpy (vertices[v].boneIndices, mesh->GetBoneIndicesData () + v * CILANTRO_MAX_BONE_INFLUENCES, CILANTRO_MAX_BONE_INFLUENCES * sizeof (GLuint));
+        std::memcpy (vertices[v].boneWeights, mesh->GetBoneWeightsData () + v * CILANTRO_MAX_BONE_INFLUENCES, CILANTRO_MAX_BONE_INFLUENCES * sizeof (GLfloat));
+    }
+
+    // load vertex and index data
+    m_geometryPool->Load (buffers->geometryAllocation, vertices.data (), mesh->GetFacesData ());
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        // load vertex positions array buffer (SSBO)
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffers->vertexPositionsSSBO);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, vertexCount * sizeof (GLfloat) * 3, mesh->GetVerticesData (), GL_STATIC_DRAW);
+
+        // load bone indices array buffer (SSBO)
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffers->boneIndicesSSBO);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, vertexCount * sizeof (GLuint) * CILANTRO_MAX_BONE_INFLUENCES, mesh->GetBoneIndicesData (), GL_STATIC_DRAW);
+
+        // load bone weights array buffer (SSBO)
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffers->boneWeightsSSBO);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, vertexCount * sizeof (GLfloat) * CILANTRO_MAX_BONE_INFLUENCES, mesh->GetBoneWeightsData (), GL_STATIC_DRAW);
+
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    buffers->meshVersion = mesh->GetVersion ();
+}
 
-        glDeleteBuffers (CILANTRO_VBO_COUNT, buffer.second->VBO);
-        glDeleteBuffers (1, &buffer.second->EBO);
-        glDeleteVertexArrays (1, &buffer.second->VAO);
+void GLRenderer::ReleaseMeshGeometryBuffers (handle_t meshHandle)
+{
+    auto find = m_meshGeometryBuffers.find (meshHandle);
+
+    if (find == m_meshGeometryBuffers.end () || --find->second->referenceCount > 0)
+    {
+        return;
+    }
+
+    // last object drawing the mesh released it
+    SGlMeshGeometryBuffers* g = find->second;
+    m_geometryPool->Free (g->geometryAllocation);
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        glDeleteBuffers (1, &g->vertexPositionsSSBO);
+        glDeleteBuffers (1, &g->boneIndicesSSBO);
+        glDeleteBuffers (1, &g->boneWeightsSSBO);
+        glDeleteBuffers (1, &g->aabbSSBO);
     }
+
+    delete g;
+    m_meshGeometryBuffers.erase (find);
 }
 
 void GLRenderer::InitializeQuadGeometryBuffer ()
@@ -1703,47 +2755,178 @@ void GLRenderer::DeinitializeQuadGeometryBuffer ()
     glDeleteBuffers(1, &m_surfaceGeometryBuffer->VBO[EGlVBOType::VBO_VERTICES]);
 }
 
-void GLRenderer::InitializeLightUniformBuffers ()
+void GLRenderer::InitializeLightVolumeGeometryBuffers ()
 {
-    m_uniformPointLightBuffer->pointLightCount = 0;
-    m_uniformSpotLightBuffer->spotLightCount = 0;
-    m_uniformDirectionalLightBuffer->directionalLightCount = 0;
+    const unsigned int slices = 16;
+    const unsigned int stacks = 8;
+    std::vector<float> vertices;
+    std::vector<GLuint> indices;
 
-    // create uniform buffer for point lights
-    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
-    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
-    glBufferData (GL_UNIFORM_BUFFER, sizeof (SGlUniformPointLightBuffer), m_uniformPointLightBuffer, GL_DYNAMIC_DRAW);
-    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_POINTLIGHTS), m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+    // unit sphere (counter-clockwise faces seen from outside), scaled so that faces enclose sphere of radius 1
+    float scale = 1.0f / (std::cos (Mathf::Pi () / slices) * std::cos (0.5f * Mathf::Pi () / stacks));
 
-    // create uniform buffer for directional lights
-    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
-    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
-    glBufferData (GL_UNIFORM_BUFFER, sizeof (SGlUniformDirectionalLightBuffer), m_uniformDirectionalLightBuffer, GL_DYNAMIC_DRAW);
-    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_DIRECTIONALLIGHTS), m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
+    for (unsigned int j = 0; j <= stacks; j++)
+    {
+        float phi = Mathf::Pi () * j / stacks;
 
-    // create uniform buffer for spot lights
-    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
-    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
-    glBufferData (GL_UNIFORM_BUFFER, sizeof (SGlUniformSpotLightBuffer), m_uniformSpotLightBuffer, GL_DYNAMIC_DRAW);
-    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_SPOTLIGHTS), m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+        for (unsigned int i = 0; i < slices; i++)
+        {
+            float theta = 2.0f * Mathf::Pi () * i / slices;
 
-    // scan objects vector for lights and populate light buffers
-    for (auto&& gameObject : GetGameScene ()->GetGameObjectManager ())
+            vertices.push_back (scale * std::sin (phi) * std::cos (theta));
+            vertices.push_back (scale * std::sin (phi) * std::sin (theta));
+            vertices.push_back (scale * std::cos (phi));
+        }
+    }
+
+    for (unsigned int j = 0; j < stacks; j++)
     {
-        if (std::dynamic_pointer_cast<Light> (gameObject) != nullptr)
+        for (unsigned int i = 0; i < slices; i++)
         {
-            gameObject->OnUpdate (*this);
+            GLuint a = j * slices + i;
+            GLuint b = (j + 1) * slices + i;
+            GLuint c = (j + 1) * slices + (i + 1) % slices;
+            GLuint d = j * slices + (i + 1) % slices;
+
+            indices.insert (indices.end (), { a, b, c, a, c, d });
         }
     }
 
-}
+    LoadLightVolumeGeometryBuffer (m_sphereGeometryBuffer, vertices, indices);
 
-void GLRenderer::DeinitializeLightUniformBuffers ()
-{
-    // delete all light buffers
-    glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+    // unit cone with apex at origin and base of radius 1 at z = 1, scaled so that faces enclose circular base
+    vertices.clear ();
+    indices.clear ();
+    scale = 1.0f / std::cos (Mathf::Pi () / slices);
+
+    vertices.insert (vertices.end (), { 0.0f, 0.0f, 0.0f });
+    vertices.insert (vertices.end (), { 0.0f, 0.0f, 1.0f });
+
+    for (unsigned int i = 0; i < slices; i++)
+    {
+        float theta = 2.0f * Mathf::Pi () * i / slices;
+
+        vertices.push_back (scale * std::cos (theta));
+        vertices.push_back (scale * std::sin (theta));
+        vertices.push_back (1.0f);
+    }
+
+    for (unsigned int i = 0; i < slices; i++)
+    {
+        GLuint a = 2 + i;
+        GLuint b = 2 + (i + 1) % slices;
+
+        // side and base
+        indices.insert (indices.end (), { 0, b, a, 1, a, b });
+    }
+
+    LoadLightVolumeGeometryBuffer (m_coneGeometryBuffer, vertices, indices);
+
+    GLUtils::CheckGLError (MSG_LOCATION);
+}
+
+void GLRenderer::LoadLightVolumeGeometryBuffer (SGlGeometryBuffers* buffer, const std::vector<float>& vertices, const std::vector<GLuint>& indices)
+{
+    glGenVertexArrays (1, &buffer->VAO);
+    glBindVertexArray (buffer->VAO);
+
+    glGenBuffers (1, &buffer->VBO[EGlVBOType::VBO_VERTICES]);
+    glBindBuffer (GL_ARRAY_BUFFER, buffer->VBO[EGlVBOType::VBO_VERTICES]);
+    glBufferData (GL_ARRAY_BUFFER, vertices.size () * sizeof (float), vertices.data (), GL_STATIC_DRAW);
+    glVertexAttribPointer (EGlVBOType::VBO_VERTICES, 3, GL_FLOAT, GL_FALSE, 3 * sizeof (float), (void*)0);
+    glEnableVertexAttribArray (EGlVBOType::VBO_VERTICES);
+
+    glGenBuffers (1, &buffer->EBO);
+    glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+    glBufferData (GL_ELEMENT_ARRAY_BUFFER, indices.size () * sizeof (GLuint), indices.data (), GL_STATIC_DRAW);
+
+    glBindBuffer (GL_ARRAY_BUFFER, 0);
+    glBindVertexArray (0);
+
+    buffer->indexCount = indices.size ();
+}
+
+void GLRenderer::DeinitializeLightVolumeGeometryBuffers ()
+{
+    for (auto&& buffer : { m_sphereGeometryBuffer, m_coneGeometryBuffer })
+    {
+        glDeleteVertexArrays (1, &buffer->VAO);
+        glDeleteBuffers (1, &buffer->VBO[EGlVBOType::VBO_VERTICES]);
+        glDeleteBuffers (1, &buffer->EBO);
+    }
+}
+
+void GLRenderer::InitializeLightUniformBuffers ()
+{
+    m_uniformPointLightBuffer->pointLightCount = 0;
+    m_uniformSpotLightBuffer->spotLightCount = 0;
+    m_uniformDirectionalLightBuffer->directionalLightCount = 0;
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        // create storage buffers for point and spot lights (sized for light count only, grown when lights are added)
+        m_pointLightsBufferSize = sizeof (m_uniformPointLightBuffer->pointLightCount) + 3 * sizeof (GLint);
+        glGenBuffers (1, &m_pointLightsBuffer);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_pointLightsBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, m_pointLightsBufferSize, m_uniformPointLightBuffer, GL_DYNAMIC_DRAW);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_POINTLIGHTS), m_pointLightsBuffer);
+
+        m_spotLightsBufferSize = sizeof (m_uniformSpotLightBuffer->spotLightCount) + 3 * sizeof (GLint);
+        glGenBuffers (1, &m_spotLightsBuffer);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_spotLightsBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, m_spotLightsBufferSize, m_uniformSpotLightBuffer, GL_DYNAMIC_DRAW);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_SPOTLIGHTS), m_spotLightsBuffer);
+
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    else
+    {
+        // create uniform buffer for point lights
+        glGenBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+        glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+        glBufferData (GL_UNIFORM_BUFFER, sizeof (m_uniformPointLightBuffer->pointLightCount) + 3 * sizeof (GLint) + CILANTRO_MAX_POINT_LIGHTS * sizeof (SGlPointLightStruct), NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (m_uniformPointLightBuffer->pointLightCount), &m_uniformPointLightBuffer->pointLightCount);
+        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_POINTLIGHTS), m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+
+        // create uniform buffer for spot lights
+        glGenBuffers (1, &m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+        glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+        glBufferData (GL_UNIFORM_BUFFER, sizeof (m_uniformSpotLightBuffer->spotLightCount) + 3 * sizeof (GLint) + CILANTRO_MAX_SPOT_LIGHTS * sizeof (SGlSpotLightStruct), NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (m_uniformSpotLightBuffer->spotLightCount), &m_uniformSpotLightBuffer->spotLightCount);
+        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_SPOTLIGHTS), m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+    }
+
+    // create uniform buffer for directional lights
+    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
+    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
+    glBufferData (GL_UNIFORM_BUFFER, sizeof (SGlUniformDirectionalLightBuffer), m_uniformDirectionalLightBuffer, GL_DYNAMIC_DRAW);
+    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_DIRECTIONALLIGHTS), m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
+
+    // scan objects vector for lights and populate light buffers
+    for (auto&& gameObject : GetGameScene ()->GetGameObjectManager ())
+    {
+        if (std::dynamic_pointer_cast<Light> (gameObject) != nullptr)
+        {
+            gameObject->OnUpdate (*this);
+        }
+    }
+
+}
+
+void GLRenderer::DeinitializeLightUniformBuffers ()
+{
+    // delete all light buffers
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        glDeleteBuffers (1, &m_pointLightsBuffer);
+        glDeleteBuffers (1, &m_spotLightsBuffer);
+    }
+    else
+    {
+        glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_POINTLIGHTS]);
+        glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
+    }
     glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_DIRECTIONALLIGHTS]);
-    glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_SPOTLIGHTS]);
 }
 
 void GLRenderer::UpdateLightBufferRecursive (handle_t objectHandle)
@@ -1762,16 +2945,982 @@ void GLRenderer::UpdateLightBufferRecursive (handle_t objectHandle)
 
 }
 
+void GLRenderer::LoadLightStorageBuffer (GLuint buffer, GLsizeiptr& bufferSize, GLuint lightCount, const void* lights, size_t lightSize, size_t lightId)
+{
+    // light array follows light count padded to alignment of light structure
+    GLsizeiptr lightsOffset = sizeof (lightCount) + 3 * sizeof (GLint);
+    GLsizeiptr requiredSize = lightsOffset + lightCount * lightSize;
+
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffer);
+
+    if (requiredSize > bufferSize)
+    {
+        // grow buffer and reload all lights
+        bufferSize = std::max (requiredSize, 2 * bufferSize);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, bufferSize, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData (GL_SHADER_STORAGE_BUFFER, lightsOffset, lightCount * lightSize, lights);
+    }
+    else
+    {
+        // load light at given index
+        glBufferSubData (GL_SHADER_STORAGE_BUFFER, lightsOffset + lightId * lightSize, lightSize, static_cast<const GLubyte*>(lights) + lightId * lightSize);
+    }
+
+    // load light count
+    glBufferSubData (GL_SHADER_STORAGE_BUFFER, 0, sizeof (lightCount), &lightCount);
+
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GLRenderer::InitializeLightClusterBuffers ()
+{
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        m_lightClusters.resize (CILANTRO_LIGHT_CLUSTERS_X * CILANTRO_LIGHT_CLUSTERS_Y * CILANTRO_LIGHT_CLUSTERS_Z);
+
+        // create storage buffer for clusters (fixed size grid)
+        glGenBuffers (1, &m_lightClustersBuffer);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_lightClustersBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlLightClustersHeader) + m_lightClusters.size () * sizeof (SGlLightCluster), NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_LIGHTCLUSTERS), m_lightClustersBuffer);
+
+        // create storage buffer for light index list (initially one light per cluster, grown when needed)
+        m_lightIndicesBufferSize = m_lightClusters.size () * sizeof (GLuint);
+        glGenBuffers (1, &m_lightIndicesBuffer);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_lightIndicesBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, m_lightIndicesBufferSize, NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_LIGHTINDICES), m_lightIndicesBuffer);
+
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+
+        GLUtils::CheckGLError (MSG_LOCATION);
+    }
+}
+
+void GLRenderer::LoadLightClusterBuffers (std::shared_ptr<Camera> camera)
+{
+    Matrix4f view = camera->GetViewMatrix ();
+    Matrix4f projection = camera->GetProjectionMatrix (m_width, m_height);
+    size_t pointLightCount = GetPointLightCount ();
+    size_t spotLightCount = GetSpotLightCount ();
+
+    // depth range of view frustum, sliced exponentially so that clusters keep similar proportions
+    CalculateViewDepthRange (camera, m_lightClustersHeader.nearPlane, m_lightClustersHeader.farPlane);
+    m_lightClustersHeader.sliceScale = CILANTRO_LIGHT_CLUSTERS_Z / std::log (m_lightClustersHeader.farPlane / m_lightClustersHeader.nearPlane);
+
+    // find clusters overlapped by each light (point lights followed by spot lights)
+    m_lightClusterRanges.resize (pointLightCount + spotLightCount);
+    for (size_t i = 0; i < pointLightCount; i++)
+    {
+        m_lightClusterRanges[i] = CalculateLightClusterRange (view, projection, m_uniformPointLightBuffer->pointLights[i].lightPosition, m_pointLightRadii[i]);
+    }
+    for (size_t i = 0; i < spotLightCount; i++)
+    {
+        m_lightClusterRanges[pointLightCount + i] = CalculateLightClusterRange (view, projection, m_uniformSpotLightBuffer->spotLights[i].lightPosition, m_spotLightRadii[i]);
+    }
+
+    // count lights in each cluster
+    std::fill (m_lightClusters.begin (), m_lightClusters.end (), SGlLightCluster {});
+    for (size_t i = 0; i < m_lightClusterRanges.size (); i++)
+    {
+        const SGlLightClusterRange& r = m_lightClusterRanges[i];
+
+        if (r.isVisible)
+        {
+            for (GLuint z = r.minCluster[2]; z <= r.maxCluster[2]; z++)
+            {
+                for (GLuint y = r.minCluster[1]; y <= r.maxCluster[1]; y++)
+                {
+                    for (GLuint x = r.minCluster[0]; x <= r.maxCluster[0]; x++)
+                    {
+                        SGlLightCluster& c = m_lightClusters[x + CILANTRO_LIGHT_CLUSTERS_X * (y + CILANTRO_LIGHT_CLUSTERS_Y * z)];
+
+                        if (i < pointLightCount)
+                        {
+                            c.pointLightCount++;
+                        }
+                        else
+                        {
+                            c.spotLightCount++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // assign ranges in light index list (cluster's point lights followed by its spot lights)
+    GLuint lightIndexCount = 0;
+    for (auto&& c : m_lightClusters)
+    {
+        c.pointLightOffset = lightIndexCount;
+        lightIndexCount += c.pointLightCount;
+        c.spotLightOffset = lightIndexCount;
+        lightIndexCount += c.spotLightCount;
+        c.pointLightCount = 0;
+        c.spotLightCount = 0;
+    }
+
+    // fill light index list
+    m_lightIndices.resize (lightIndexCount);
+    for (size_t i = 0; i < m_lightClusterRanges.size (); i++)
+    {
+        const SGlLightClusterRange& r = m_lightClusterRanges[i];
+
+        if (r.isVisible)
+        {
+            for (GLuint z = r.minCluster[2]; z <= r.maxCluster[2]; z++)
+            {
+                for (GLuint y = r.minCluster[1]; y <= r.maxCluster[1]; y++)
+                {
+                    for (GLuint x = r.minCluster[0]; x <= r.maxCluster[0]; x++)
+                    {
+                        SGlLightCluster& c = m_lightClusters[x + CILANTRO_LIGHT_CLUSTERS_X * (y + CILANTRO_LIGHT_CLUSTERS_Y * z)];
+
+                        if (i < pointLightCount)
+                        {
+                            m_lightIndices[c.pointLightOffset + c.pointLightCount++] = static_cast<GLuint>(i);
+                        }
+                        else
+                        {
+                            m_lightIndices[c.spotLightOffset + c.spotLightCount++] = static_cast<GLuint>(i - pointLightCount);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // load clusters to GPU
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_lightClustersBuffer);
+    glBufferSubData (GL_SHADER_STORAGE_BUFFER, 0, sizeof (SGlLightClustersHeader), &m_lightClustersHeader);
+    glBufferSubData (GL_SHADER_STORAGE_BUFFER, sizeof (SGlLightClustersHeader), m_lightClusters.size () * sizeof (SGlLightCluster), m_lightClusters.data ());
+
+    // load light index list to GPU (grow buffer if needed)
+    GLsizeiptr lightIndicesSize = lightIndexCount * sizeof (GLuint);
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_lightIndicesBuffer);
+    if (lightIndicesSize > m_lightIndicesBufferSize)
+    {
+        m_lightIndicesBufferSize = std::max (lightIndicesSize, 2 * m_lightIndicesBufferSize);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, m_lightIndicesBufferSize, NULL, GL_DYNAMIC_DRAW);
+    }
+    if (lightIndicesSize > 0)
+    {
+        glBufferSubData (GL_SHADER_STORAGE_BUFFER, 0, lightIndicesSize, m_lightIndices.data ());
+    }
+
+    glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GLRenderer::DeinitializeLightClusterBuffers ()
+{
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
+    {
+        glDeleteBuffers (1, &m_lightClustersBuffer);
+        glDeleteBuffers (1, &m_lightIndicesBuffer);
+    }
+}
+
+SGlLightClusterRange GLRenderer::CalculateLightClusterRange (const Matrix4f& view, const Matrix4f& projection, const GLfloat* position, float radius) const
+{
+    const GLuint clusterCount[3] = { CILANTRO_LIGHT_CLUSTERS_X, CILANTRO_LIGHT_CLUSTERS_Y, CILANTRO_LIGHT_CLUSTERS_Z };
+    const SGlLightClustersHeader& h = m_lightClustersHeader;
+    SGlLightClusterRange range;
+
+    // lights without finite range overlap all clusters
+    if (!(radius > 0.0f) || std::isinf (radius))
+    {
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            range.minCluster[i] = 0;
+            range.maxCluster[i] = clusterCount[i] - 1;
+        }
+        range.isVisible = true;
+
+        return range;
+    }
+
+    // depth slices overlapped by bounding sphere
+    Vector4f center = view * Vector4f (position[0], position[1], position[2], 1.0f);
+    float minDepth = -center[2] - radius;
+    float maxDepth = -center[2] + radius;
+
+    range.isVisible = (maxDepth >= h.nearPlane) && (minDepth <= h.farPlane);
+    if (!range.isVisible)
+    {
+        return range;
+    }
+
+    float minSlice = std::floor (std::log (std::max (minDepth, h.nearPlane) / h.nearPlane) * h.sliceScale);
+    float maxSlice = std::floor (std::log (std::min (maxDepth, h.farPlane) / h.nearPlane) * h.sliceScale);
+    range.minCluster[2] = static_cast<GLuint>(std::clamp (minSlice, 0.0f, clusterCount[2] - 1.0f));
+    range.maxCluster[2] = static_cast<GLuint>(std::clamp (maxSlice, 0.0f, clusterCount[2] - 1.0f));
+
+    // screen tiles overlapped by projected bounding box of sphere
+    float ndcMin[2];
+    float ndcMax[2];
+
+    range.isVisible = CalculateLightScreenBounds (view, projection, h.nearPlane, h.farPlane, position, radius, ndcMin, ndcMax);
+
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        range.minCluster[i] = static_cast<GLuint>(std::clamp (std::floor ((ndcMin[i] * 0.5f + 0.5f) * clusterCount[i]), 0.0f, clusterCount[i] - 1.0f));
+        range.maxCluster[i] = static_cast<GLuint>(std::clamp (std::floor ((ndcMax[i] * 0.5f + 0.5f) * clusterCount[i]), 0.0f, clusterCount[i] - 1.0f));
+    }
+
+    return range;
+}
+
+void GLRenderer::CalculateViewDepthRange (std::shared_ptr<Camera> camera, float& nearPlane, float& farPlane) const
+{
+    Matrix4f view = camera->GetViewMatrix ();
+
+    nearPlane = std::numeric_limits<float>::max ();
+    farPlane = 0.0f;
+    for (auto&& vertex : camera->GetFrustumVertices (m_width, m_height))
+    {
+        float depth = -(view * Vector4f (vertex, 1.0f))[2];
+        nearPlane = std::min (nearPlane, depth);
+        farPlane = std::max (farPlane, depth);
+    }
+    nearPlane = std::max (nearPlane, 0.01f);
+    farPlane = std::max (farPlane, 2.0f * nearPlane);
+}
+
+bool GLRenderer::CalculateLightScreenBounds (const Matrix4f& view, const Matrix4f& projection, float nearPlane, float farPlane, const GLfloat* position, float radius, float* ndcMin, float* ndcMax) const
+{
+    // whole screen for lights without finite range
+    ndcMin[0] = ndcMin[1] = -1.0f;
+    ndcMax[0] = ndcMax[1] = 1.0f;
+
+    if (!(radius > 0.0f) || std::isinf (radius))
+    {
+        return true;
+    }
+
+    Vector4f center = view * Vector4f (position[0], position[1], position[2], 1.0f);
+    float minDepth = -center[2] - radius;
+    float maxDepth = -center[2] + radius;
+
+    // sphere outside of depth range
+    if (maxDepth < nearPlane || minDepth > farPlane)
+    {
+        return false;
+    }
+
+    // whole screen if sphere reaches near plane, otherwise projected bounding box of sphere
+    if (minDepth <= nearPlane)
+    {
+        return true;
+    }
+
+    ndcMin[0] = ndcMin[1] = std::numeric_limits<float>::max ();
+    ndcMax[0] = ndcMax[1] = std::numeric_limits<float>::lowest ();
+
+    for (unsigned int corner = 0; corner < 8; corner++)
+    {
+        Vector4f v (center[0] + ((corner & 1) ? radius : -radius), center[1] + ((corner & 2) ? radius : -radius), center[2] + ((corner & 4) ? radius : -radius), 1.0f);
+        Vector4f clip = projection * v;
+
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            ndcMin[i] = std::min (ndcMin[i], clip[i] / clip[3]);
+            ndcMax[i] = std::max (ndcMax[i], clip[i] / clip[3]);
+        }
+    }
+
+    return (ndcMax[0] >= -1.0f) && (ndcMin[0] <= 1.0f) && (ndcMax[1] >= -1.0f) && (ndcMin[1] <= 1.0f);
+}
+
+void GLRenderer::InitializeBoneTransformationBuffers ()
+{
+    Matrix4f identity;
+    identity.InitIdentity ();
+
+    // create streaming buffer for bone transformation palettes of skinned meshes
+    m_boneTransformationsRingBuffer->Initialize ();
+
+    // create static palette for meshes without bones (all vertices reference identity matrix at index 0)
+    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+    glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_BONES * sizeof (GLfloat) * 16, NULL, GL_STATIC_DRAW);
+    glBufferSubData (GL_UNIFORM_BUFFER, 0, 16 * sizeof (GLfloat), identity[0]);
+    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+    glBindBuffer (GL_UNIFORM_BUFFER, 0);
+
+    GLUtils::CheckGLError (MSG_LOCATION);
+}
+
+void GLRenderer::LoadBoneTransformationBuffer (std::shared_ptr<MeshObject> meshObject, SGlGeometryBuffers* buffer, bool reuseFrameAllocation)
+{
+    GLsizeiptr blockSize = CILANTRO_MAX_BONES * sizeof (GLfloat) * 16;
+    GLsizeiptr paletteSize;
+    size_t boneCount = meshObject->GetMesh ()->GetMeshBones ().size ();
+
+    // mesh without bones - bind static identity palette, nothing to load
+    if (boneCount == 0)
+    {
+        glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+        return;
+    }
+
+    // load palette unless it was already loaded in current frame
+    if (!reuseFrameAllocation || buffer->boneTransformationsFrame != m_boneTransformationsRingBuffer->GetFrameSerial ())
+    {
+        // only copy matrices in use (identity + mesh bones), but reserve the whole uniform block
+        paletteSize = static_cast<GLsizeiptr> (std::min (boneCount + 1, static_cast<size_t> (CILANTRO_MAX_BONES))) * sizeof (GLfloat) * 16;
+        buffer->boneTransformationsOffset = m_boneTransformationsRingBuffer->Allocate (meshObject->GetBoneTransformationsMatrixArray (true), paletteSize, blockSize);
+        buffer->boneTransformationsFrame = reuseFrameAllocation ? m_boneTransformationsRingBuffer->GetFrameSerial () : 0;
+    }
+
+    m_boneTransformationsRingBuffer->BindRange (static_cast<GLuint>(EGlUBOType::UBO_BONETRANSFORMATIONS), buffer->boneTransformationsOffset, blockSize);
+}
+
+void GLRenderer::DeinitializeBoneTransformationBuffers ()
+{
+    m_boneTransformationsRingBuffer->Deinitialize ();
+    glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+}
+
+void GLRenderer::InitializeMaterialUniformBuffers ()
+{
+    GLint offsetAlignment = 1;
+
+    // blocks are bound as ranges, so their offsets must be multiples of alignment required by driver
+    glGetIntegerv (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment <= 0)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid uniform buffer offset alignment" << offsetAlignment;
+    }
+
+    m_materialBlockStride = ((CILANTRO_MATERIAL_BLOCK_SIZE + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+
+    // create uniform buffer for properties of all materials (blocks are loaded on first use of material)
+    glGenBuffers (1, &m_uniformBuffers->UBO[UBO_MATERIALS]);
+    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_MATERIALS]);
+    glBufferData (GL_UNIFORM_BUFFER, CILANTRO_MAX_MATERIALS * m_materialBlockStride, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer (GL_UNIFORM_BUFFER, 0);
+
+    m_materials.clear ();
+    m_invalidatedMaterials.clear ();
+
+    GLUtils::CheckGLError (MSG_LOCATION);
+}
+
+void GLRenderer::LoadMaterialUniformBuffer (std::shared_ptr<Material> material, std::shared_ptr<GLShaderProgram> shaderProgram)
+{
+    std::array<GLubyte, CILANTRO_MATERIAL_BLOCK_SIZE> block {};
+    GLint blockSize = shaderProgram->GetUniformBlockSize ("UniformMaterialBlock");
+    auto find = m_materials.find (material->GetHandle ());
+    size_t index;
+
+    // assign next free block to new material
+    if (find == m_materials.end ())
+    {
+        if (m_materials.size () >= CILANTRO_MAX_MATERIALS)
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Maximum number of materials exceeded" << CILANTRO_MAX_MATERIALS;
+        }
+
+        index = m_materials.size ();
+        m_materials.insert ({ material->GetHandle (), index });
+    }
+    else
+    {
+        index = find->second;
+    }
+
+    if (blockSize > CILANTRO_MATERIAL_BLOCK_SIZE)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Material block of shader" << shaderProgram->GetName () << "exceeds" << CILANTRO_MATERIAL_BLOCK_SIZE << "bytes";
+    }
+
+    // pack properties at offsets of material block members in shader program (std140 layout)
+    for (auto&& property : material->GetPropertiesMap ())
+    {
+        GLenum type = GL_NONE;
+        GLint offset = shaderProgram->GetUniformBlockMemberOffset ("UniformMaterialBlock", property.first, type);
+
+        if (offset < 0)
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid material uniform" << property.first << "in shader" << shaderProgram->GetName () << "for" << material->GetName ();
+        }
+
+        if ((property.second.size () == 1 && type == GL_FLOAT) || (property.second.size () == 3 && type == GL_FLOAT_VEC3))
+        {
+            std::memcpy (block.data () + offset, property.second.data (), property.second.size () * sizeof (GLfloat));
+        }
+        else
+        {
+            LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid vector size for material property" << property.first << "in shader" << shaderProgram->GetName () << "for" << material->GetName ();
+        }
+    }
+
+    glBindBuffer (GL_UNIFORM_BUFFER, m_uniformBuffers->UBO[UBO_MATERIALS]);
+    glBufferSubData (GL_UNIFORM_BUFFER, static_cast<GLintptr> (index) * m_materialBlockStride, CILANTRO_MATERIAL_BLOCK_SIZE, block.data ());
+    glBindBuffer (GL_UNIFORM_BUFFER, 0);
+
+    m_invalidatedMaterials.erase (material->GetHandle ());
+}
+
+void GLRenderer::DeinitializeMaterialUniformBuffers ()
+{
+    glDeleteBuffers (1, &m_uniformBuffers->UBO[UBO_MATERIALS]);
+}
+
+SGlTexture* GLRenderer::AcquireTexture (std::shared_ptr<Texture> texture)
+{
+    auto find = m_textures.find (texture.get ());
+
+    if (find != m_textures.end ())
+    {
+        // texture already loaded for other material unit
+        find->second->referenceCount++;
+
+        return find->second;
+    }
+
+    // first reference, load texture
+    SGlTexture* t = new SGlTexture ();
+    m_textures.insert ({ texture.get (), t });
+    t->resource = texture.get ();
+    t->referenceCount = 1;
+    LoadTexture (texture, t);
+
+    return t;
+}
+
+void GLRenderer::LoadTexture (std::shared_ptr<Texture> texture, SGlTexture* buffer)
+{
+    GLsizei width = static_cast<GLsizei> (texture->GetWidth ());
+    GLsizei height = static_cast<GLsizei> (texture->GetHeight ());
+    GLenum format;
+    GLenum internalFormat;
+
+    switch (texture->GetChannels ())
+    {
+    case 1:
+        format = GL_RED;
+        internalFormat = GL_R8;
+        break;
+    case 4:
+        format = GL_RGBA;
+        internalFormat = GL_RGBA8;
+        break;
+    default:
+        format = GL_RGB;
+        internalFormat = GL_RGB8;
+    }
+
+    // immutable storage can not be resized, so texture object is recreated if dimensions or format change
+    if (buffer->texture != 0 && (buffer->width != width || buffer->height != height || buffer->internalFormat != internalFormat))
+    {
+        glDeleteTextures (1, &buffer->texture);
+        buffer->texture = 0;
+    }
+
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+
+    if (buffer->texture == 0)
+    {
+        glGenTextures (1, &buffer->texture);
+        glBindTexture (GL_TEXTURE_2D, buffer->texture);
+
+        if (glTexStorage2D != NULL)
+        {
+            // allocate all mip levels at once
+            GLsizei levels = 1;
+            while ((std::max (width, height) >> levels) > 0)
+            {
+                levels++;
+            }
+
+            glTexStorage2D (GL_TEXTURE_2D, levels, internalFormat, width, height);
+            glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, texture->Data ());
+        }
+        else
+        {
+            glTexImage2D (GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, texture->Data ());
+        }
+
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        buffer->width = width;
+        buffer->height = height;
+        buffer->internalFormat = internalFormat;
+    }
+    else
+    {
+        // reload contents of existing storage
+        glBindTexture (GL_TEXTURE_2D, buffer->texture);
+        glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, texture->Data ());
+    }
+
+    glGenerateMipmap (GL_TEXTURE_2D);
+    glBindTexture (GL_TEXTURE_2D, 0);
+}
+
+void GLRenderer::ReleaseTexture (SGlTexture* buffer)
+{
+    if (--buffer->referenceCount > 0)
+    {
+        return;
+    }
+
+    // last unit referencing the texture released it
+    glDeleteTextures (1, &buffer->texture);
+    m_textures.erase (buffer->resource);
+    delete buffer;
+}
+
+void GLRenderer::DeinitializeTextures ()
+{
+    for (auto&& texture : m_textures)
+    {
+        glDeleteTextures (1, &texture.second->texture);
+        delete texture.second;
+    }
+
+    for (auto&& units : m_materialTextureUnits)
+    {
+        delete units.second;
+    }
+
+    m_textures.clear ();
+    m_materialTextureUnits.clear ();
+}
+
+std::shared_ptr<GLShaderProgram> GLRenderer::UseMaterial (std::shared_ptr<Material> material)
+{
+    // get shader program for rendered material (geometry pass)
+    auto geometryShaderProgram = m_shaderProgramManager->GetByName<GLShaderProgram> (
+        m_isDeferredRendering
+        ? material->GetDeferredGeometryPassShaderProgram ()
+        : material->GetForwardShaderProgram ()
+    );
+    geometryShaderProgram->Use ();
+
+    // bind textures for active material and bind a shadow map
+    if (m_materialTextureUnits.find (material->GetHandle ()) != m_materialTextureUnits.end ())
+    {
+        SGlMaterialTextureUnits* u = m_materialTextureUnits[material->GetHandle ()];
+
+        for (GLuint i = 0; i < u->unitsCount; i++)
+        {
+            glActiveTexture (GL_TEXTURE0 + i);
+            glBindTexture (GL_TEXTURE_2D, (u->textureUnits[i] != nullptr) ? u->textureUnits[i]->texture : 0);
+        }
+
+        // bind shadow maps (if exist)
+        if (m_isShadowMapping && (GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()) != nullptr)
+        {
+            if (GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()->IsDepthTextureArrayEnabled ())
+            {
+                GetCurrentRenderStage ()->GetLinkedDepthTextureArrayFramebuffer ()->BindFramebufferDepthTextureArrayAsColor (CILANTRO_SHADOW_MAP_BINDING);
+            }
+        }
+
+    }
+    else
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Missing texture for material" << material->GetName ();
+    }
+
+    // load material properties block if material is new or modified, then bind its range of materials buffer
+    auto materialIndex = m_materials.find (material->GetHandle ());
+    if (materialIndex == m_materials.end () || m_invalidatedMaterials.contains (material->GetHandle ()))
+    {
+        LoadMaterialUniformBuffer (material, geometryShaderProgram);
+        materialIndex = m_materials.find (material->GetHandle ());
+    }
+
+    glBindBufferRange (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_MATERIALS), m_uniformBuffers->UBO[UBO_MATERIALS], static_cast<GLintptr> (materialIndex->second) * m_materialBlockStride, CILANTRO_MATERIAL_BLOCK_SIZE);
+
+    // set shadow map uniform (if shadow mapping is enabled)
+    // this is only required for forward rendering, because deferred rendering uses a different shader program for lighting pass (DeferredLightingRenderStage)
+    if (!m_isDeferredRendering)
+    {
+        geometryShaderProgram->SetUniformInt (geometryShaderProgram->GetUniformHandle (UNIFORM_SHADOWMAPENABLED), m_isShadowMapping ? 1 : 0);
+    }
+    
+    // get camera position in world space and set uniform value
+    if (!m_isDeferredRendering)
+    {
+        geometryShaderProgram->SetUniformVector3f (geometryShaderProgram->GetUniformHandle (UNIFORM_EYEPOSITION), GetGameScene ()->GetActiveCamera ()->GetPosition ());
+    }
+
+    // get shader program for rendered material (lighting pass)
+    if (m_isDeferredRendering)
+    {
+        auto lightingShaderProgram = m_shaderProgramManager->GetByName<GLShaderProgram>(material->GetDeferredLightingPassShaderProgram ());
+        lightingShaderProgram->Use ();
+
+        // get camera position in world space and set uniform value (this needs to be done again for deferred lighting shader program)
+        lightingShaderProgram->SetUniformVector3f (lightingShaderProgram->GetUniformHandle (UNIFORM_EYEPOSITION), GetGameScene ()->GetActiveCamera ()->GetPosition ());
+
+    }
+
+    geometryShaderProgram->Use ();
+
+    return geometryShaderProgram;
+}
+
+void GLRenderer::LoadObjectTransform (SGlObjectTransform& transform, std::shared_ptr<MeshObject> meshObject)
+{
+    LoadObjectTransform (transform, meshObject->GetWorldTransformMatrix ());
+    transform.shadowCasterMask = GetShadowCasterMask (meshObject->GetHandle ());
+}
+
+void GLRenderer::LoadObjectTransform (SGlObjectTransform& transform, const Matrix4f& modelMatrix)
+{
+    Matrix3f normalMatrix = Mathf::Invert (Mathf::Transpose (Matrix3f (modelMatrix)));
+
+    // copy model matrix
+    std::memcpy (transform.modelMatrix, Mathf::Transpose (modelMatrix)[0], 16 * sizeof (GLfloat));
+
+    // copy normal matrix columns
+    for (unsigned int c = 0; c < 3; c++)
+    {
+        transform.normalMatrix[c * 4 + 0] = normalMatrix[0][c];
+        transform.normalMatrix[c * 4 + 1] = normalMatrix[1][c];
+        transform.normalMatrix[c * 4 + 2] = normalMatrix[2][c];
+        transform.normalMatrix[c * 4 + 3] = 0.0f;
+    }
+
+    // objects drawn outside of shadow map pass are not masked
+    transform.shadowCasterMask = std::numeric_limits<GLuint>::max ();
+    std::fill (transform.padding, transform.padding + 3, 0u);
+}
+
+GLuint GLRenderer::GetShadowCasterMask (handle_t meshObjectHandle) const
+{
+    if (m_drawnShadowCasterMasks == nullptr)
+    {
+        return std::numeric_limits<GLuint>::max ();
+    }
+
+    auto find = m_drawnShadowCasterMasks->find (meshObjectHandle);
+
+    return find != m_drawnShadowCasterMasks->end () ? find->second : 0u;
+}
+
 void GLRenderer::RenderGeometryBuffer (SGlGeometryBuffers* buffer, GLuint type)
 {
     // bind
     glBindVertexArray (buffer->VAO);
     
     // draw
-    glDrawElements (type, static_cast<GLsizei> (buffer->indexCount) * sizeof (GLuint), GL_UNSIGNED_INT, 0);
+    glDrawElements (type, static_cast<GLsizei> (buffer->indexCount), GL_UNSIGNED_INT, 0);
     
     // unbind
     glBindVertexArray (0);
 }
 
+void GLRenderer::RenderLightVolume (std::shared_ptr<IShaderProgram> shader, EGlLightVolumeType type, size_t lightId, const Matrix4f& model, SGlGeometryBuffers* volume, const float* ndcMin, const float* ndcMax)
+{
+    GLint rect[4];
+
+    // scissor rectangle of light's projected bounding sphere (in window coordinates of current viewport)
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        float min = std::clamp (ndcMin[i] * 0.5f + 0.5f, 0.0f, 1.0f);
+        float max = std::clamp (ndcMax[i] * 0.5f + 0.5f, 0.0f, 1.0f);
+
+        rect[i] = m_viewport[i] + static_cast<GLint> (std::floor (min * m_viewport[2 + i]));
+        rect[2 + i] = m_viewport[i] + static_cast<GLint> (std::ceil (max * m_viewport[2 + i])) - rect[i];
+    }
+
+    glScissor (rect[0], rect[1], rect[2], rect[3]);
+
+    GLShaderProgram& glShader = static_cast<GLShaderProgram&> (*shader);
+
+    glShader.SetUniformMatrix4f (glShader.GetUniformHandle (UNIFORM_MODEL), model);
+    glShader.SetUniformInt (glShader.GetUniformHandle (UNIFORM_LIGHTVOLUMETYPE), type);
+    glShader.SetUniformInt (glShader.GetUniformHandle (UNIFORM_LIGHTVOLUMEIDX), static_cast<int> (lightId));
+
+    RenderGeometryBuffer (volume, GL_TRIANGLES);
+}
+
+void GLRenderer::RenderMeshObject (std::shared_ptr<IShaderProgram> shader, std::shared_ptr<MeshObject> meshObject, bool loadNormalMatrix)
+{
+    SGlGeometryBuffers* b = m_sceneGeometryBuffers[meshObject->GetHandle ()];
+    const SGlGeometryAllocation& g = b->meshGeometry->geometryAllocation;
+    SGlObjectTransform transform;
+    GLintptr transformOffset;
+    auto instancedMeshObject = std::dynamic_pointer_cast<InstancedMeshObject> (meshObject);
+    GLsizei instanceCount = (instancedMeshObject != nullptr) ? static_cast<GLsizei> (instancedMeshObject->GetInstanceCount ()) : 1;
+    GLShaderProgram& glShader = static_cast<GLShaderProgram&> (*shader);
+
+    if (instanceCount == 0)
+    {
+        return;
+    }
+
+    // load bone transformation matrix array to buffer (shared with other passes in the same frame)
+    LoadBoneTransformationBuffer (meshObject, b, true);
+
+    if (GLUtils::GetGLSLVersion ().versionNumber < 430)
+    {
+        // no storage buffers, draw instances one by one with object transformation combined with instance transformation
+        m_geometryPool->Bind ();
+        for (GLsizei i = 0; i < instanceCount; i++)
+        {
+            Matrix4f modelMatrix = (instancedMeshObject != nullptr) ? meshObject->GetWorldTransformMatrix () * instancedMeshObject->GetInstanceTransform (i) : meshObject->GetWorldTransformMatrix ();
+
+            // get world matrix for drawn objects and set uniform value
+            glShader.SetUniformMatrix4f (glShader.GetUniformHandle (UNIFORM_MODEL), modelMatrix);
+            if (m_drawnShadowCasterMasks != nullptr)
+            {
+                glShader.SetUniformUInt (glShader.GetUniformHandle (UNIFORM_SHADOWCASTERMASK), GetShadowCasterMask (meshObject->GetHandle ()));
+            }
+
+            // calculate normal matrix for drawn objects and set uniform value
+            if (loadNormalMatrix)
+            {
+                glShader.SetUniformMatrix3f (glShader.GetUniformHandle (UNIFORM_NORMAL), Mathf::Invert (Mathf::Transpose (Matrix3f (modelMatrix))));
+            }
+
+            glDrawElementsBaseVertex (GL_TRIANGLES, static_cast<GLsizei> (g.indexCount), GL_UNSIGNED_INT, (GLvoid*) (g.firstIndex * sizeof (GLuint)), g.baseVertex);
+        }
+        m_geometryPool->Unbind ();
+
+        return;
+    }
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 460)
+    {
+        // load world and normal matrices to per-draw storage buffer (draw's base instance is 0)
+        LoadObjectTransform (transform, meshObject);
+        transformOffset = m_objectTransformsRingBuffer->Allocate (&transform, sizeof (SGlObjectTransform), sizeof (SGlObjectTransform));
+        m_objectTransformsRingBuffer->BindRange (static_cast<GLuint>(EGlSSBOType::SSBO_OBJECTTRANSFORMS), transformOffset, sizeof (SGlObjectTransform));
+    }
+    else
+    {
+        // get world matrix for drawn objects and set uniform value
+        glShader.SetUniformMatrix4f (glShader.GetUniformHandle (UNIFORM_MODEL), meshObject->GetWorldTransformMatrix ());
+        if (m_drawnShadowCasterMasks != nullptr)
+        {
+            glShader.SetUniformUInt (glShader.GetUniformHandle (UNIFORM_SHADOWCASTERMASK), GetShadowCasterMask (meshObject->GetHandle ()));
+        }
+
+        // calculate normal matrix for drawn objects and set uniform value
+        if (loadNormalMatrix)
+        {
+            glShader.SetUniformMatrix3f (glShader.GetUniformHandle (UNIFORM_NORMAL), Mathf::Invert (Mathf::Transpose (Matrix3f (meshObject->GetWorldTransformMatrix ()))));
+        }
+    }
+
+    // instance transformations (relative to object), fetched by instance id
+    if (instancedMeshObject != nullptr)
+    {
+        LoadInstanceTransformBuffer (instancedMeshObject, b);
+    }
+    else
+    {
+        glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_INSTANCETRANSFORMS), m_identityInstanceTransformBuffer);
+    }
+
+    // draw
+    m_geometryPool->Bind ();
+    glDrawElementsInstancedBaseVertex (GL_TRIANGLES, static_cast<GLsizei> (g.indexCount), GL_UNSIGNED_INT, (GLvoid*) (g.firstIndex * sizeof (GLuint)), instanceCount, g.baseVertex);
+    m_geometryPool->Unbind ();
+}
+
+void GLRenderer::LoadInstanceTransformBuffer (std::shared_ptr<InstancedMeshObject> instancedMeshObject, SGlGeometryBuffers* buffer)
+{
+    // reload only if instances were modified since last load
+    if (buffer->instanceTransformsVersion != instancedMeshObject->GetInstanceTransformsVersion ())
+    {
+        const std::vector<Matrix4f>& instanceTransforms = instancedMeshObject->GetInstanceTransforms ();
+        std::vector<SGlObjectTransform> transforms (instanceTransforms.size ());
+
+        for (size_t i = 0; i < instanceTransforms.size (); i++)
+        {
+            LoadObjectTransform (transforms[i], instanceTransforms[i]);
+        }
+
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, buffer->instanceTransformsSSBO);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, transforms.size () * sizeof (SGlObjectTransform), transforms.data (), GL_DYNAMIC_DRAW);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+
+        buffer->instanceTransformsVersion = instancedMeshObject->GetInstanceTransformsVersion ();
+    }
+
+    glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_INSTANCETRANSFORMS), buffer->instanceTransformsSSBO);
+}
+
+void GLRenderer::RenderMeshObjects (std::shared_ptr<IShaderProgram> shader, const std::vector<handle_t>& meshObjects)
+{
+    bool isIndirectDrawSupported = GLUtils::GetGLSLVersion ().versionNumber >= 460;
+
+    shader->Use ();
+    m_unskinnedMeshObjects.clear ();
+
+    for (handle_t meshObjectHandle : meshObjects)
+    {
+        auto m = GetGameScene ()->GetGameObjectManager ()->GetByHandle<MeshObject> (meshObjectHandle);
+
+        // meshes without bones are drawn together with a single indirect draw
+        if (isIndirectDrawSupported && m->GetMesh ()->GetMeshBones ().empty () && std::dynamic_pointer_cast<InstancedMeshObject> (m) == nullptr)
+        {
+            m_unskinnedMeshObjects.push_back (meshObjectHandle);
+            continue;
+        }
+
+        // draw
+        RenderMeshObject (shader, m, false);
+    }
+
+    if (!m_unskinnedMeshObjects.empty ())
+    {
+        shader->Use ();
+        RenderMeshObjectsIndirect (shader, m_unskinnedMeshObjects, false);
+    }
+}
+
+void GLRenderer::RenderMeshObjectsIndirect (std::shared_ptr<IShaderProgram> shader, const std::vector<handle_t>& meshObjects, bool isCulled)
+{
+    // transforms and cull data of a run share ring buffer region, larger runs are drawn in chunks fitting one region
+    unsigned int allocationCount = isCulled ? 2 : 1;
+    size_t drawSize = sizeof (SGlObjectTransform) + (isCulled ? sizeof (SGlCullObject) : 0);
+    size_t maxChunkSize = static_cast<size_t> (m_objectTransformsRingBuffer->GetMaxReservedSize (allocationCount)) / drawSize;
+
+    for (size_t first = 0; first < meshObjects.size (); first += maxChunkSize)
+    {
+        size_t count = std::min (maxChunkSize, meshObjects.size () - first);
+
+        RenderMeshObjectsIndirect (shader, meshObjects.data () + first, count, isCulled);
+    }
+}
+
+void GLRenderer::RenderMeshObjectsIndirect (std::shared_ptr<IShaderProgram> shader, const handle_t* meshObjects, size_t meshObjectCount, bool isCulled)
+{
+    GLsizei drawCount = static_cast<GLsizei> (meshObjectCount);
+    GLsizeiptr transformsSize = drawCount * sizeof (SGlObjectTransform);
+    GLsizeiptr commandsSize = drawCount * sizeof (SGlDrawElementsIndirectCommand);
+    GLsizeiptr cullObjectsSize = isCulled ? drawCount * sizeof (SGlCullObject) : 0;
+    GLintptr transformsOffset;
+    GLintptr commandsOffset;
+    GLintptr cullObjectsOffset;
+
+    // without indirect count draws, culled commands stay in place with zero instance count
+    bool isDrawCountSupported = glMultiDrawElementsIndirectCount != NULL;
+
+    m_drawObjectTransforms.resize (drawCount);
+    m_drawCommands.resize (drawCount);
+    m_cullObjects.resize (isCulled ? drawCount : 0);
+
+    // build per-draw transforms and draw commands (base instance is index of draw's transforms)
+    for (size_t i = 0; i < meshObjectCount; i++)
+    {
+        auto meshObject = GetGameScene ()->GetGameObjectManager ()->GetByHandle<MeshObject> (meshObjects[i]);
+        SGlGeometryAllocation& g = m_sceneGeometryBuffers[meshObjects[i]]->meshGeometry->geometryAllocation;
+
+        LoadObjectTransform (m_drawObjectTransforms[i], meshObject);
+
+        if (isCulled)
+        {
+            const AABB& bounds = GetGameScene ()->GetModelSpaceBounds (meshObject);
+            Vector3f center = (bounds.GetLowerBound () + bounds.GetUpperBound ()) * 0.5f;
+            Vector3f extents = (bounds.GetUpperBound () - bounds.GetLowerBound ()) * 0.5f;
+
+            m_cullObjects[i] = { { center[0], center[1], center[2], 0.0f }, { extents[0], extents[1], extents[2], 0.0f }, g.indexCount, g.firstIndex, g.baseVertex, static_cast<GLuint> (i) };
+        }
+        else
+        {
+            m_drawCommands[i] = { g.indexCount, 1, g.firstIndex, g.baseVertex, static_cast<GLuint> (i) };
+        }
+    }
+
+    // load to GPU (cull data must not wrap over transforms of the same chunk)
+    m_objectTransformsRingBuffer->Reserve (transformsSize + cullObjectsSize, isCulled ? 2 : 1);
+    transformsOffset = m_objectTransformsRingBuffer->Allocate (m_drawObjectTransforms.data (), transformsSize, transformsSize);
+    m_objectTransformsRingBuffer->BindRange (static_cast<GLuint>(EGlSSBOType::SSBO_OBJECTTRANSFORMS), transformsOffset, transformsSize);
+
+    if (isCulled)
+    {
+        // draw commands are generated by culling compute shader
+        cullObjectsOffset = m_objectTransformsRingBuffer->Allocate (m_cullObjects.data (), cullObjectsSize, cullObjectsSize);
+        m_objectTransformsRingBuffer->BindRange (static_cast<GLuint>(EGlSSBOType::SSBO_CULLOBJECTS), cullObjectsOffset, cullObjectsSize);
+        CullDrawCommands (drawCount, isDrawCountSupported);
+        shader->Use ();
+    }
+    else
+    {
+        commandsOffset = m_drawCommandsRingBuffer->Allocate (m_drawCommands.data (), commandsSize, commandsSize);
+    }
+
+    // objects without bones use static identity palette, objects without instances use identity instance transformation
+    glBindBufferBase (GL_UNIFORM_BUFFER, static_cast<int>(EGlUBOType::UBO_BONETRANSFORMATIONS), m_uniformBuffers->UBO[UBO_BONETRANSFORMATIONS]);
+    glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_INSTANCETRANSFORMS), m_identityInstanceTransformBuffer);
+
+    // draw
+    m_geometryPool->Bind ();
+    if (isCulled && isDrawCountSupported)
+    {
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, m_culledDrawCommandsBuffer);
+        glBindBuffer (GL_PARAMETER_BUFFER, m_drawCountBuffer);
+        glMultiDrawElementsIndirectCount (GL_TRIANGLES, GL_UNSIGNED_INT, 0, 0, drawCount, 0);
+        glBindBuffer (GL_PARAMETER_BUFFER, 0);
+    }
+    else if (isCulled)
+    {
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, m_culledDrawCommandsBuffer);
+        glMultiDrawElementsIndirect (GL_TRIANGLES, GL_UNSIGNED_INT, 0, drawCount, 0);
+    }
+    else
+    {
+        glBindBuffer (GL_DRAW_INDIRECT_BUFFER, m_drawCommandsRingBuffer->GetBufferGLId ());
+        glMultiDrawElementsIndirect (GL_TRIANGLES, GL_UNSIGNED_INT, (const GLvoid*) commandsOffset, drawCount, 0);
+    }
+    glBindBuffer (GL_DRAW_INDIRECT_BUFFER, 0);
+    m_geometryPool->Unbind ();
+}
+
+void GLRenderer::CullDrawCommands (GLsizei drawCount, bool compactDrawCommands)
+{
+    GLsizeiptr commandsSize = drawCount * sizeof (SGlDrawElementsIndirectCommand);
+    GLuint zero = 0;
+    float planes[24];
+
+    // grow output buffer (contents are regenerated with every dispatch)
+    if (commandsSize > m_culledDrawCommandsBufferSize)
+    {
+        m_culledDrawCommandsBufferSize = std::max (commandsSize, 2 * m_culledDrawCommandsBufferSize);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, m_culledDrawCommandsBuffer);
+        glBufferData (GL_SHADER_STORAGE_BUFFER, m_culledDrawCommandsBufferSize, NULL, GL_DYNAMIC_COPY);
+        glBindBuffer (GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // reset counter of surviving draws
+    glBindBuffer (GL_ATOMIC_COUNTER_BUFFER, m_drawCountBuffer);
+    glBufferSubData (GL_ATOMIC_COUNTER_BUFFER, 0, sizeof (GLuint), &zero);
+    glBindBuffer (GL_ATOMIC_COUNTER_BUFFER, 0);
+
+    glBindBufferBase (GL_SHADER_STORAGE_BUFFER, static_cast<int>(EGlSSBOType::SSBO_DRAWCOMMANDS), m_culledDrawCommandsBuffer);
+    glBindBufferBase (GL_ATOMIC_COUNTER_BUFFER, static_cast<int>(EGlACBType::ACB_DRAWCOUNT), m_drawCountBuffer);
+
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        Vector4f plane = m_viewFrustum.GetPlane (i);
+
+        planes[i * 4] = plane[0];
+        planes[i * 4 + 1] = plane[1];
+        planes[i * 4 + 2] = plane[2];
+        planes[i * 4 + 3] = plane[3];
+    }
+
+    // test bounds against view frustum and write draw commands
+    auto computeShader = m_shaderProgramManager->GetByName<GLShaderProgram> ("cull_compute_shader");
+    computeShader->Use ();
+    computeShader->SetUniformFloatv (computeShader->GetUniformHandle (UNIFORM_FRUSTUMPLANES), planes, 24);
+    computeShader->SetUniformUInt (computeShader->GetUniformHandle (UNIFORM_OBJECTCOUNT), static_cast<unsigned int> (drawCount));
+    computeShader->SetUniformInt (computeShader->GetUniformHandle (UNIFORM_COMPACTDRAWCOMMANDS), compactDrawCommands ? 1 : 0);
+    computeShader->Compute ((static_cast<GLuint> (drawCount) + CILANTRO_COMPUTE_GROUP_SIZE - 1) / CILANTRO_COMPUTE_GROUP_SIZE, 1, 1);
+
+    // make commands and their count visible to indirect draw
+    glMemoryBarrier (GL_COMMAND_BARRIER_BIT);
+}
+
 } // namespace cilantro
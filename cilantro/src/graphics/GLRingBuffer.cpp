@@ -0,0 +1,217 @@
+#include "cilantroengine.h"
+#include "graphics/GLRingBuffer.h"
+#include "graphics/GLUtils.h"
+#include "system/LogMessage.h"
+#include <cstring>
+
+namespace cilantro {
+
+GLRingBuffer::GLRingBuffer (GLenum target, GLsizeiptr regionSize, unsigned int regionCount)
+    : m_target (target)
+    , m_buffer (0)
+    , m_regionSize (regionSize)
+    , m_regionCount (regionCount)
+    , m_regionFences (regionCount, nullptr)
+    , m_currentRegion (0)
+    , m_currentOffset (0)
+    , m_offsetAlignment (1)
+    , m_isPersistentlyMapped (false)
+    , m_mappedData (nullptr)
+    , m_frameSerial (1)
+{
+}
+
+GLRingBuffer::~GLRingBuffer ()
+{
+}
+
+void GLRingBuffer::Initialize ()
+{
+    GLsizeiptr bufferSize = m_regionSize * m_regionCount;
+
+    // get offset alignment required for binding ranges of the buffer
+    if (m_target == GL_UNIFORM_BUFFER)
+    {
+        glGetIntegerv (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_offsetAlignment);
+    }
+    else if (GLUtils::GetGLSLVersion ().versionNumber >= 430 && m_target == GL_SHADER_STORAGE_BUFFER)
+    {
+        glGetIntegerv (GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &m_offsetAlignment);
+    }
+
+    glGenBuffers (1, &m_buffer);
+    glBindBuffer (m_target, m_buffer);
+
+    if (GLUtils::GetGLSLVersion ().versionNumber >= 440)
+    {
+        // immutable storage, mapped once for the lifetime of the buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage (m_target, bufferSize, NULL, flags);
+        m_mappedData = static_cast<GLubyte*> (glMapBufferRange (m_target, 0, bufferSize, flags));
+        m_isPersistentlyMapped = (m_mappedData != nullptr);
+    }
+    else
+    {
+        glBufferData (m_target, bufferSize, NULL, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer (m_target, 0);
+
+    GLUtils::CheckGLError (MSG_LOCATION);
+}
+
+void GLRingBuffer::Deinitialize ()
+{
+    for (auto&& fence : m_regionFences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync (fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_isPersistentlyMapped)
+    {
+        glBindBuffer (m_target, m_buffer);
+        glUnmapBuffer (m_target);
+        glBindBuffer (m_target, 0);
+
+        m_mappedData = nullptr;
+        m_isPersistentlyMapped = false;
+    }
+
+    glDeleteBuffers (1, &m_buffer);
+}
+
+GLintptr GLRingBuffer::Allocate (const void* data, GLsizeiptr dataSize, GLsizeiptr reservedSize)
+{
+    GLintptr offset;
+    GLintptr regionOffset;
+
+    if (reservedSize > m_regionSize || dataSize > reservedSize)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Ring buffer allocation of" << reservedSize << "bytes exceeds region size" << m_regionSize;
+    }
+
+    // align allocation start
+    offset = ((m_currentOffset + m_offsetAlignment - 1) / m_offsetAlignment) * m_offsetAlignment;
+
+    // region exhausted within a single frame - wait until GPU consumed it and start over
+    if (offset + reservedSize > m_regionSize)
+    {
+        RestartRegion ();
+        offset = 0;
+    }
+
+    m_currentOffset = offset + reservedSize;
+    regionOffset = m_currentRegion * m_regionSize + offset;
+
+    // copy data
+    if (m_isPersistentlyMapped)
+    {
+        std::memcpy (m_mappedData + regionOffset, data, dataSize);
+    }
+    else
+    {
+        glBindBuffer (m_target, m_buffer);
+        glBufferSubData (m_target, regionOffset, dataSize, data);
+        glBindBuffer (m_target, 0);
+    }
+
+    return regionOffset;
+}
+
+void GLRingBuffer::Reserve (GLsizeiptr size, unsigned int allocationCount)
+{
+    if (size > GetMaxReservedSize (allocationCount))
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Ring buffer reservation of" << size << "bytes exceeds region size" << m_regionSize;
+    }
+
+    // every allocation may be padded to offset alignment
+    if (m_currentOffset + size + allocationCount * (m_offsetAlignment - 1) > m_regionSize)
+    {
+        RestartRegion ();
+    }
+}
+
+GLsizeiptr GLRingBuffer::GetMaxReservedSize (unsigned int allocationCount) const
+{
+    return m_regionSize - allocationCount * (m_offsetAlignment - 1);
+}
+
+void GLRingBuffer::BindRange (GLuint index, GLintptr offset, GLsizeiptr size) const
+{
+    glBindBufferRange (m_target, index, m_buffer, offset, size);
+}
+
+void GLRingBuffer::NextFrame ()
+{
+    if (m_isPersistentlyMapped)
+    {
+        // GPU is done with current region once all commands issued so far complete
+        m_regionFences[m_currentRegion] = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    m_currentRegion = (m_currentRegion + 1) % m_regionCount;
+    m_currentOffset = 0;
+    m_frameSerial++;
+
+    if (m_isPersistentlyMapped)
+    {
+        WaitForRegion (m_currentRegion);
+    }
+}
+
+size_t GLRingBuffer::GetFrameSerial () const
+{
+    return m_frameSerial;
+}
+
+GLuint GLRingBuffer::GetBufferGLId () const
+{
+    return m_buffer;
+}
+
+void GLRingBuffer::WaitForRegion (unsigned int region)
+{
+    GLenum waitResult;
+
+    if (m_regionFences[region] == nullptr)
+    {
+        return;
+    }
+
+    // poll first, then flush and block in 1ms steps
+    waitResult = glClientWaitSync (m_regionFences[region], 0, 0);
+    while (waitResult == GL_TIMEOUT_EXPIRED)
+    {
+        waitResult = glClientWaitSync (m_regionFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+
+    if (waitResult == GL_WAIT_FAILED)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Ring buffer fence wait failed";
+    }
+
+    glDeleteSync (m_regionFences[region]);
+    m_regionFences[region] = nullptr;
+}
+
+void GLRingBuffer::RestartRegion ()
+{
+    if (m_isPersistentlyMapped)
+    {
+        m_regionFences[m_currentRegion] = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        WaitForRegion (m_currentRegion);
+    }
+
+    m_currentOffset = 0;
+
+    // allocations made earlier in this frame are overwritten from now on, they must not be reused
+    m_frameSerial++;
+}
+
+} // namespace cilantro
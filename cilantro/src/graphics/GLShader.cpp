@@ -1,17 +1,20 @@
 #include "graphics/GLShader.h"
 #include "graphics/GLRenderer.h"
 #include "graphics/GLUtils.h"
+#include "graphics/GLProgramBinaryCache.h"
 #include "system/LogMessage.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace cilantro {
 
-GLShader::GLShader (const std::string& path, EShaderType shaderType) : Shader (path, shaderType)
+GLShader::GLShader (const std::string& path, EShaderType shaderType) 
+    : Shader (path, shaderType)
+    , m_isCompiled (false)
 {
-    GLint success;
-    char errorLog[512];
-
     switch (shaderType)
     {
         case EShaderType::VERTEX_SHADER:
@@ -31,28 +34,33 @@ GLShader::GLShader (const std::string& path, EShaderType shaderType) : Shader (p
     SetDefaults ();
     Load (path);
     Compile ();
-
-    glGetShaderiv (m_glShaderId, GL_COMPILE_STATUS, &success);
-
-    if (!success)
-    {
-        glGetShaderInfoLog (m_glShaderId, 512, nullptr, errorLog);
-        glDeleteShader (m_glShaderId);
-        LogMessage () << m_shaderSource;
-        LogMessage () << errorLog;
-        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Unable to compile shader" << m_glShaderId << path;
-    }
 }
 
 void GLShader::Compile ()
 {
-    GLint status;
+    m_isCompiled = false;
+}
+
+void GLShader::CompileSource ()
+{
     const char* src;
 
+    if (m_isCompiled)
+    {
+        return;
+    }
+
     src = m_shaderSource.c_str ();
     glShaderSource (m_glShaderId, 1, &src, NULL);
     glCompileShader (m_glShaderId); 
 
+    m_isCompiled = true;
+}
+
+void GLShader::CheckCompileStatus ()
+{
+    GLint status;
+
     glGetShaderiv(m_glShaderId, GL_COMPILE_STATUS, &status);
     if (!status) 
     {
@@ -62,11 +70,30 @@ void GLShader::Compile ()
 
         glGetShaderInfoLog(m_glShaderId, length, &length, &errorLog[0]);
         glDeleteShader(m_glShaderId);
+        LogMessage () << m_shaderSource;
         LogMessage(MSG_LOCATION) << errorLog;
-        LogMessage(MSG_LOCATION, EXIT_FAILURE) << "Unable to compile shader" << m_glShaderId;
+        LogMessage(MSG_LOCATION, EXIT_FAILURE) << "Unable to compile shader" << m_glShaderId << path;
     } 
 }
 
+uint64_t GLShader::GetSourceKey (uint64_t hash) const
+{
+    uint32_t shaderType = static_cast<uint32_t> (m_shaderType);
+
+    // static parameters in stable order
+    std::vector<std::pair<std::string, std::string>> parameters (m_parameterValMap.begin (), m_parameterValMap.end ());
+    std::sort (parameters.begin (), parameters.end ());
+
+    hash = GLProgramBinaryCache::Hash (&shaderType, sizeof (shaderType), hash);
+    for (auto&& [parameter, value] : parameters)
+    {
+        hash = GLProgramBinaryCache::Hash (parameter, hash);
+        hash = GLProgramBinaryCache::Hash (value, hash);
+    }
+
+    return GLProgramBinaryCache::Hash (m_shaderSource, hash);
+}
+
 void GLShader::SetDefaults ()
 {
     Shader::SetDefaults ();
@@ -81,11 +108,26 @@ void GLShader::SetDefaults ()
     SetStaticParameter ("UBO_SPOTLIGHTVIEWMATRICES", std::to_string (static_cast<int> (EGlUBOType::UBO_SPOTLIGHTVIEWMATRICES)));
     SetStaticParameter ("UBO_POINTLIGHTVIEWMATRICES", std::to_string (static_cast<int> (EGlUBOType::UBO_POINTLIGHTVIEWMATRICES)));
     SetStaticParameter ("UBO_BONETRANSFORMATIONS", std::to_string (static_cast<int> (EGlUBOType::UBO_BONETRANSFORMATIONS)));
+    SetStaticParameter ("UBO_MATERIALS", std::to_string (static_cast<int> (EGlUBOType::UBO_MATERIALS)));
 
     SetStaticParameter ("SSBO_VERTICES", std::to_string (static_cast<int> (EGlSSBOType::SSBO_VERTICES)));
     SetStaticParameter ("SSBO_BONEINDICES", std::to_string (static_cast<int> (EGlSSBOType::SSBO_BONEINDICES)));
     SetStaticParameter ("SSBO_BONEWEIGHTS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_BONEWEIGHTS)));
     SetStaticParameter ("SSBO_AABB", std::to_string (static_cast<int> (EGlSSBOType::SSBO_AABB)));
+    SetStaticParameter ("SSBO_OBJECTTRANSFORMS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_OBJECTTRANSFORMS)));
+    SetStaticParameter ("SSBO_CULLOBJECTS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_CULLOBJECTS)));
+    SetStaticParameter ("SSBO_DRAWCOMMANDS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_DRAWCOMMANDS)));
+    SetStaticParameter ("SSBO_INSTANCETRANSFORMS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_INSTANCETRANSFORMS)));
+    SetStaticParameter ("SSBO_POINTLIGHTS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_POINTLIGHTS)));
+    SetStaticParameter ("SSBO_SPOTLIGHTS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_SPOTLIGHTS)));
+    SetStaticParameter ("SSBO_LIGHTCLUSTERS", std::to_string (static_cast<int> (EGlSSBOType::SSBO_LIGHTCLUSTERS)));
+    SetStaticParameter ("SSBO_LIGHTINDICES", std::to_string (static_cast<int> (EGlSSBOType::SSBO_LIGHTINDICES)));
+
+    SetStaticParameter ("ACB_DRAWCOUNT", std::to_string (static_cast<int> (EGlACBType::ACB_DRAWCOUNT)));
+
+    SetStaticParameter ("LIGHTVOLUME_NONE", std::to_string (static_cast<int> (EGlLightVolumeType::LIGHTVOLUME_NONE)));
+    SetStaticParameter ("LIGHTVOLUME_POINT", std::to_string (static_cast<int> (EGlLightVolumeType::LIGHTVOLUME_POINT)));
+    SetStaticParameter ("LIGHTVOLUME_SPOT", std::to_string (static_cast<int> (EGlLightVolumeType::LIGHTVOLUME_SPOT)));
 }
 
 GLuint GLShader::GetShaderId () const
@@ -1,5 +1,6 @@
 #include "graphics/GLShaderProgram.h"
 #include "graphics/GLShader.h"
+#include "graphics/GLProgramBinaryCache.h"
 #include "graphics/GLUtils.h"
 #include "system/LogMessage.h"
 #include "math/Vector2f.h"
@@ -7,13 +8,26 @@
 #include "math/Vector4f.h"
 #include "math/Matrix3f.h"
 #include "math/Matrix4f.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 namespace cilantro {
 
-GLShaderProgram::GLShaderProgram () 
+// names of uniforms in EGlUniformType order
+static const char* rendererUniformNames[UNIFORM_COUNT] = {
+    "mModel", "mNormal", "shadowCasterMask", "eyePosition", "shadowMapEnabled", "lightVolumeType", "lightVolumeIdx", "frustumPlanes", "objectCount", "compactDrawCommands"
+};
+
+GLShaderProgram::GLShaderProgram (std::shared_ptr<GLProgramBinaryCache> binaryCache) 
     : ShaderProgram ()
+    , m_binaryCache (binaryCache)
+    , m_linkState (EGlProgramLinkState::UNLINKED)
+    , m_isLoadedFromCache (false)
+    , m_programKey (0)
 {
     m_glShaderProgramId = glCreateProgram ();
+    m_rendererUniformHandles.fill (-1);
 }
 
 void GLShaderProgram::AttachShader (const std::shared_ptr<IShader> shader)
@@ -21,17 +35,83 @@ void GLShaderProgram::AttachShader (const std::shared_ptr<IShader> shader)
     auto glShader = std::static_pointer_cast<GLShader> (shader);
 
     glAttachShader (m_glShaderProgramId, glShader->GetShaderId ());
+    m_shaders.push_back (glShader);
+    m_linkState = EGlProgramLinkState::UNLINKED;
 }
 
 void GLShaderProgram::Link ()
 {
-    GLint success;
+    // program is linked again on next use
+    m_linkState = EGlProgramLinkState::UNLINKED;
+}
+
+void GLShaderProgram::Prepare ()
+{
+    bool isCacheEnabled = m_binaryCache != nullptr && m_binaryCache->IsEnabled ();
+
+    if (m_linkState != EGlProgramLinkState::UNLINKED)
+    {
+        return;
+    }
+
+    m_linkState = EGlProgramLinkState::LINKING;
+    m_isLoadedFromCache = false;
+
+    if (isCacheEnabled)
+    {
+        m_programKey = m_binaryCache->GetDriverKey ();
+        for (auto&& shader : m_shaders)
+        {
+            m_programKey = shader->GetSourceKey (m_programKey);
+        }
+
+        // attribute bindings are part of linked program (in order of binding, later ones override earlier)
+        for (auto&& [index, attributeName] : m_attribLocations)
+        {
+            uint32_t attributeIndex = static_cast<uint32_t> (index);
+
+            m_programKey = GLProgramBinaryCache::Hash (&attributeIndex, sizeof (attributeIndex), m_programKey);
+            m_programKey = GLProgramBinaryCache::Hash (attributeName, m_programKey);
+        }
+
+        // skip compilation and linking if binary of the same program is cached
+        if (m_binaryCache->Load (m_glShaderProgramId, m_programKey))
+        {
+            m_isLoadedFromCache = true;
+            return;
+        }
+
+        glProgramParameteri (m_glShaderProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    for (auto&& attribLocation : m_attribLocations)
+    {
+        glBindAttribLocation (m_glShaderProgramId, attribLocation.first, attribLocation.second.c_str ());
+    }
+
+    // no status is queried here, so that drivers can compile and link programs in parallel
+    for (auto&& shader : m_shaders)
+    {
+        shader->CompileSource ();
+    }
 
     glLinkProgram (m_glShaderProgramId);
+}
+
+void GLShaderProgram::FinishLink ()
+{
+    GLint success;
+
     glGetProgramiv (m_glShaderProgramId, GL_LINK_STATUS, &success);
 
     if (!success)
     {
+        // report compilation errors first
+        for (auto&& shader : m_shaders)
+        {
+            shader->CheckCompileStatus ();
+        }
+
         GLint length;
         glGetProgramiv (m_glShaderProgramId, GL_INFO_LOG_LENGTH, &length);
         std::string errorLog(length, ' ');
@@ -39,174 +119,287 @@ void GLShaderProgram::Link ()
         glGetProgramInfoLog (m_glShaderProgramId, length, nullptr, &errorLog[0]);
         glDeleteProgram (m_glShaderProgramId);
         LogMessage () << errorLog;
-        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Unable to link program" << m_glShaderProgramId;
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Unable to link program" << m_glShaderProgramId << this->GetName ();
+    }
+
+    if (m_binaryCache != nullptr && m_binaryCache->IsEnabled () && !m_isLoadedFromCache)
+    {
+        m_binaryCache->Store (m_glShaderProgramId, m_programKey);
     }
+
+    m_linkState = EGlProgramLinkState::LINKED;
+
+    // locations and values are reset by linking
+    ReflectUniforms ();
+
+    if (m_linkCallback)
+    {
+        m_linkCallback (*this);
+    }
+
+    GLUtils::CheckGLError (MSG_LOCATION);
 }
 
-bool GLShaderProgram::HasUniform (const std::string& uniformName) const
+void GLShaderProgram::EnsureLinked () const
 {
-    GLuint location = GetUniformLocationId (uniformName);
-
-    if (location == GL_INVALID_INDEX)
+    if (m_linkState == EGlProgramLinkState::LINKED)
     {
-        return false;
+        return;
     }
 
-    return true;
+    // linking is deferred until program is used, so it completes in const accessors too
+    auto program = const_cast<GLShaderProgram*> (this);
+    program->Prepare ();
+    program->FinishLink ();
+}
+
+void GLShaderProgram::BindAttribLocation (GLuint index, const std::string& attributeName)
+{
+    m_attribLocations.push_back ({ index, attributeName });
+    m_linkState = EGlProgramLinkState::UNLINKED;
+}
+
+void GLShaderProgram::SetLinkCallback (TProgramLinkCallback callback)
+{
+    m_linkCallback = callback;
+}
+
+EGlProgramLinkState GLShaderProgram::GetLinkState () const
+{
+    return m_linkState;
+}
+
+bool GLShaderProgram::HasUniform (const std::string& uniformName) const
+{
+    return FindUniform (uniformName) >= 0;
 }
 
 IShaderProgram& GLShaderProgram::SetUniformInt (const std::string& uniformName, int uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    return SetUniformInt (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformUInt (const std::string& uniformName, unsigned int uniformValue)
+{
+    return SetUniformUInt (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformFloat (const std::string& uniformName, float uniformValue)
+{
+    return SetUniformFloat (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformFloatv (const std::string& uniformName, const float* uniformValue, size_t count)
+{
+    return SetUniformFloatv (GetUniformHandle (uniformName), uniformValue, count);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformVector2f (const std::string& uniformName, const Vector2f& uniformValue)
+{
+    return SetUniformVector2f (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformVector3f (const std::string& uniformName, const Vector3f& uniformValue)
+{
+    return SetUniformVector3f (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformVector4f (const std::string& uniformName, const Vector4f& uniformValue)
+{
+    return SetUniformVector4f (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformMatrix3f (const std::string& uniformName, const Matrix3f& uniformValue)
+{
+    return SetUniformMatrix3f (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformMatrix4f (const std::string& uniformName, const Matrix4f& uniformValue)
+{
+    return SetUniformMatrix4f (GetUniformHandle (uniformName), uniformValue);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformMatrix3fv (const std::string& uniformName, const float* uniformValue, size_t count)
+{
+    return SetUniformMatrix3fv (GetUniformHandle (uniformName), uniformValue, count);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformMatrix4fv (const std::string& uniformName, const float* uniformValue, size_t count)
+{
+    return SetUniformMatrix4fv (GetUniformHandle (uniformName), uniformValue, count);
+}
+
+IShaderProgram& GLShaderProgram::SetUniformInt (GLint uniformHandle, int uniformValue)
+{
+    if (UpdateUniformValue (uniformHandle, &uniformValue, sizeof (int)))
     {
-        glUniform1i (location, uniformValue);
+        glUniform1i (m_uniforms[uniformHandle].location, uniformValue);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformUInt (const std::string& uniformName, unsigned int uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformUInt (GLint uniformHandle, unsigned int uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, &uniformValue, sizeof (unsigned int)))
     {
-        glUniform1ui (location, uniformValue);
+        glUniform1ui (m_uniforms[uniformHandle].location, uniformValue);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformFloat (const std::string& uniformName, float uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformFloat (GLint uniformHandle, float uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, &uniformValue, sizeof (float)))
     {
-        glUniform1f (location, uniformValue);
+        glUniform1f (m_uniforms[uniformHandle].location, uniformValue);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformFloatv (const std::string& uniformName, const float* uniformValue, size_t count)
+IShaderProgram& GLShaderProgram::SetUniformFloatv (GLint uniformHandle, const float* uniformValue, size_t count)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, uniformValue, count * sizeof (float)))
     {
-        glUniform1fv (location, static_cast<GLsizei> (count), uniformValue);
+        glUniform1fv (m_uniforms[uniformHandle].location, static_cast<GLsizei> (count), uniformValue);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformVector2f (const std::string& uniformName, const Vector2f& uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformVector2f (GLint uniformHandle, const Vector2f& uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, &uniformValue[0], 2 * sizeof (float)))
     {
-        glUniform2fv (location, 1, &uniformValue[0]);
+        glUniform2fv (m_uniforms[uniformHandle].location, 1, &uniformValue[0]);
     }
+
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformVector3f (const std::string& uniformName, const Vector3f& uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformVector3f (GLint uniformHandle, const Vector3f& uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, &uniformValue[0], 3 * sizeof (float)))
     {
-        glUniform3fv (location, 1, &uniformValue[0]);
+        glUniform3fv (m_uniforms[uniformHandle].location, 1, &uniformValue[0]);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformVector4f (const std::string& uniformName, const Vector4f& uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformVector4f (GLint uniformHandle, const Vector4f& uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, &uniformValue[0], 4 * sizeof (float)))
     {
-        glUniform4fv (location, 1, &uniformValue[0]);
+        glUniform4fv (m_uniforms[uniformHandle].location, 1, &uniformValue[0]);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformMatrix3f (const std::string& uniformName, const Matrix3f& uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformMatrix3f (GLint uniformHandle, const Matrix3f& uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, uniformValue[0], 9 * sizeof (float)))
     {
-        glUniformMatrix3fv (location, 1, GL_TRUE, uniformValue[0]);
+        glUniformMatrix3fv (m_uniforms[uniformHandle].location, 1, GL_TRUE, uniformValue[0]);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformMatrix4f (const std::string& uniformName, const Matrix4f& uniformValue)
+IShaderProgram& GLShaderProgram::SetUniformMatrix4f (GLint uniformHandle, const Matrix4f& uniformValue)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, uniformValue[0], 16 * sizeof (float)))
     {
-        glUniformMatrix4fv (location, 1, GL_TRUE, uniformValue[0]);
+        glUniformMatrix4fv (m_uniforms[uniformHandle].location, 1, GL_TRUE, uniformValue[0]);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformMatrix3fv (const std::string& uniformName, const float* uniformValue, size_t count)
+IShaderProgram& GLShaderProgram::SetUniformMatrix3fv (GLint uniformHandle, const float* uniformValue, size_t count)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, uniformValue, count * 9 * sizeof (float)))
     {
-        glUniformMatrix3fv (location, static_cast<GLsizei> (count), GL_TRUE, uniformValue);
+        glUniformMatrix3fv (m_uniforms[uniformHandle].location, static_cast<GLsizei> (count), GL_TRUE, uniformValue);
     }
 
     return *this;
 }
 
-IShaderProgram& GLShaderProgram::SetUniformMatrix4fv (const std::string& uniformName, const float* uniformValue, size_t count)
+IShaderProgram& GLShaderProgram::SetUniformMatrix4fv (GLint uniformHandle, const float* uniformValue, size_t count)
 {
-    GLuint location = GetUniformLocationId (uniformName);
-    if (location != GL_INVALID_INDEX)
+    if (UpdateUniformValue (uniformHandle, uniformValue, count * 16 * sizeof (float)))
     {
-        glUniformMatrix4fv (location, static_cast<GLsizei> (count), GL_TRUE, uniformValue);
+        glUniformMatrix4fv (m_uniforms[uniformHandle].location, static_cast<GLsizei> (count), GL_TRUE, uniformValue);
     }
 
     return *this;
 }
 
+GLint GLShaderProgram::GetUniformHandle (const std::string& uniformName) const
+{
+    GLint uniformHandle = FindUniform (uniformName);
+
+    if (uniformHandle < 0)
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Uniform" << uniformName << "not found in shader program" << this->GetName ();
+    }
+
+    return uniformHandle;
+}
+
+GLint GLShaderProgram::GetUniformHandle (EGlUniformType uniform) const
+{
+    EnsureLinked ();
+
+    return m_rendererUniformHandles[uniform];
+}
+
+size_t GLShaderProgram::GetNameHash (const std::string& name)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (auto&& c : name)
+    {
+        hash ^= static_cast<unsigned char> (c);
+        hash *= 1099511628211ull;
+    }
+
+    return static_cast<size_t> (hash);
+}
+
 void GLShaderProgram::Use () const
 {
+    EnsureLinked ();
     glUseProgram (m_glShaderProgramId);
 }
 
 void GLShaderProgram::Compute (unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
 {
+    EnsureLinked ();
     glDispatchCompute (groupsX, groupsY, groupsZ);
     glMemoryBarrier (GL_SHADER_STORAGE_BARRIER_BIT);
 }
 
 GLuint GLShaderProgram::GetProgramId () const
 {
+    EnsureLinked ();
+
     return m_glShaderProgramId;
 }
 
 GLuint GLShaderProgram::GetUniformLocationId (const std::string& uniformName) const
 {
-    this->Use ();
-    GLuint paramUniformLocation = glGetUniformLocation (m_glShaderProgramId, uniformName.c_str ());
-
-    if (paramUniformLocation == GL_INVALID_INDEX)
-    {
-        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Uniform" << uniformName << "not found in shader program" << this->GetName ();
-    }
-
-    return paramUniformLocation;
+    return static_cast<GLuint> (m_uniforms[GetUniformHandle (uniformName)].location);
 }
 
 void GLShaderProgram::BindUniformBlock (const std::string& blockName, EGlUBOType bp)
 {
-    GLuint uniformBlockIndex = glGetUniformBlockIndex (m_glShaderProgramId, blockName.c_str ());
+    const SGlUniformBlock* block = FindUniformBlock (blockName);
+    GLuint uniformBlockIndex = (block != nullptr) ? block->index : GL_INVALID_INDEX;
     GLint actualBinding = -1;
 
     if (uniformBlockIndex != GL_INVALID_INDEX)
@@ -227,6 +420,8 @@ void GLShaderProgram::BindUniformBlock (const std::string& blockName, EGlUBOType
 
 void GLShaderProgram::BindShaderStorageBlock(const std::string& blockName, EGlSSBOType bp)
 {
+    EnsureLinked ();
+
     if (GLUtils::GetGLSLVersion ().versionNumber >= 430)
     {
         GLuint blockIndex = glGetProgramResourceIndex(m_glShaderProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
@@ -259,11 +454,178 @@ void GLShaderProgram::BindShaderStorageBlock(const std::string& blockName, EGlSS
     }
 }
 
+GLint GLShaderProgram::GetUniformBlockSize (const std::string& blockName) const
+{
+    const SGlUniformBlock* block = FindUniformBlock (blockName);
 
-} // namespace cilantro
+    return (block != nullptr) ? block->dataSize : -1;
+}
 
+GLint GLShaderProgram::GetUniformBlockMemberOffset (const std::string& blockName, const std::string& memberName, GLenum& memberType) const
+{
+    const SGlUniformBlock* block = FindUniformBlock (blockName);
+    size_t nameHash = GetNameHash (memberName);
 
+    if (block == nullptr)
+    {
+        return -1;
+    }
 
+    auto it = std::lower_bound (m_uniformBlockMembers.begin (), m_uniformBlockMembers.end (), nameHash, [] (const SGlUniformBlockMember& member, size_t hash) { return member.nameHash < hash; });
+    for (; it != m_uniformBlockMembers.end () && it->nameHash == nameHash; ++it)
+    {
+        if (it->name == memberName && it->blockIndex == block->index)
+        {
+            memberType = it->type;
+            return it->offset;
+        }
+    }
+
+    return -1;
+}
 
+void GLShaderProgram::ReflectUniforms ()
+{
+    GLint count;
+    GLint maxNameLength;
 
+    m_uniforms.clear ();
+    m_uniformBlocks.clear ();
+    m_uniformBlockMembers.clear ();
+
+    // active uniforms (members of uniform blocks have no location, their offset in block is kept instead)
+    glGetProgramiv (m_glShaderProgramId, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv (m_glShaderProgramId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<GLchar> name (std::max (maxNameLength, 1));
+
+    for (GLint i = 0; i < count; i++)
+    {
+        SGlUniform u;
+        GLsizei length;
+
+        glGetActiveUniform (m_glShaderProgramId, static_cast<GLuint> (i), maxNameLength, &length, &u.size, &u.type, name.data ());
+        u.name = std::string (name.data (), length);
+        u.location = glGetUniformLocation (m_glShaderProgramId, u.name.c_str ());
+
+        if (u.location < 0)
+        {
+            GLuint uniformIndex = static_cast<GLuint> (i);
+            GLint blockIndex;
+            SGlUniformBlockMember m;
+
+            glGetActiveUniformsiv (m_glShaderProgramId, 1, &uniformIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+            if (blockIndex >= 0)
+            {
+                glGetActiveUniformsiv (m_glShaderProgramId, 1, &uniformIndex, GL_UNIFORM_OFFSET, &m.offset);
+                m.name = u.name;
+                m.nameHash = GetNameHash (m.name);
+                m.blockIndex = static_cast<GLuint> (blockIndex);
+                m.type = u.type;
+                m_uniformBlockMembers.push_back (m);
+            }
+
+            continue;
+        }
+
+        // arrays are reported as name[0]
+        if (u.name.size () > 3 && u.name.compare (u.name.size () - 3, 3, "[0]") == 0)
+        {
+            u.name.resize (u.name.size () - 3);
+        }
+
+        u.nameHash = GetNameHash (u.name);
+        u.isValueSet = false;
+        m_uniforms.push_back (u);
+    }
+
+    // active uniform blocks
+    glGetProgramiv (m_glShaderProgramId, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv (m_glShaderProgramId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+    name.resize (std::max (maxNameLength, 1));
+
+    for (GLint i = 0; i < count; i++)
+    {
+        SGlUniformBlock b;
+        GLsizei length;
+
+        glGetActiveUniformBlockName (m_glShaderProgramId, static_cast<GLuint> (i), maxNameLength, &length, name.data ());
+        b.name = std::string (name.data (), length);
+        b.nameHash = GetNameHash (b.name);
+        b.index = static_cast<GLuint> (i);
+        glGetActiveUniformBlockiv (m_glShaderProgramId, b.index, GL_UNIFORM_BLOCK_DATA_SIZE, &b.dataSize);
+        m_uniformBlocks.push_back (b);
+    }
+
+    std::sort (m_uniforms.begin (), m_uniforms.end (), [] (const SGlUniform& a, const SGlUniform& b) { return a.nameHash < b.nameHash; });
+    std::sort (m_uniformBlocks.begin (), m_uniformBlocks.end (), [] (const SGlUniformBlock& a, const SGlUniformBlock& b) { return a.nameHash < b.nameHash; });
+    std::sort (m_uniformBlockMembers.begin (), m_uniformBlockMembers.end (), [] (const SGlUniformBlockMember& a, const SGlUniformBlockMember& b) { return a.nameHash < b.nameHash; });
+
+    // resolve uniforms loaded by renderer, so that it does not look them up by name for every draw
+    for (size_t i = 0; i < UNIFORM_COUNT; i++)
+    {
+        m_rendererUniformHandles[i] = FindUniform (rendererUniformNames[i]);
+    }
+}
+
+GLint GLShaderProgram::FindUniform (const std::string& uniformName) const
+{
+    EnsureLinked ();
+
+    size_t nameHash = GetNameHash (uniformName);
+
+    auto it = std::lower_bound (m_uniforms.begin (), m_uniforms.end (), nameHash, [] (const SGlUniform& uniform, size_t hash) { return uniform.nameHash < hash; });
+    for (; it != m_uniforms.end () && it->nameHash == nameHash; ++it)
+    {
+        if (it->name == uniformName)
+        {
+            return static_cast<GLint> (it - m_uniforms.begin ());
+        }
+    }
+
+    return -1;
+}
+
+const SGlUniformBlock* GLShaderProgram::FindUniformBlock (const std::string& blockName) const
+{
+    EnsureLinked ();
+
+    size_t nameHash = GetNameHash (blockName);
+
+    auto it = std::lower_bound (m_uniformBlocks.begin (), m_uniformBlocks.end (), nameHash, [] (const SGlUniformBlock& block, size_t hash) { return block.nameHash < hash; });
+    for (; it != m_uniformBlocks.end () && it->nameHash == nameHash; ++it)
+    {
+        if (it->name == blockName)
+        {
+            return &(*it);
+        }
+    }
+
+    return nullptr;
+}
+
+bool GLShaderProgram::UpdateUniformValue (GLint uniformHandle, const void* value, size_t valueSize)
+{
+    if (uniformHandle < 0 || uniformHandle >= static_cast<GLint> (m_uniforms.size ()))
+    {
+        return false;
+    }
+
+    SGlUniform& u = m_uniforms[uniformHandle];
+
+    if (u.isValueSet && u.value.size () == valueSize && std::memcmp (u.value.data (), value, valueSize) == 0)
+    {
+        return false;
+    }
+
+    u.value.resize (valueSize);
+    std::memcpy (u.value.data (), value, valueSize);
+    u.isValueSet = true;
+
+    // glUniform* loads to currently used program
+    this->Use ();
+
+    return true;
+}
+
+} // namespace cilantro
 
@@ -0,0 +1,93 @@
+#include "cilantroengine.h"
+#include "graphics/RenderQueue.h"
+#include <array>
+#include <bit>
+
+namespace cilantro {
+
+RenderQueue::RenderQueue ()
+{
+}
+
+RenderQueue::~RenderQueue ()
+{
+}
+
+void RenderQueue::Clear ()
+{
+    m_items.clear ();
+}
+
+void RenderQueue::Push (uint64_t key, handle_t objectHandle, handle_t materialHandle)
+{
+    m_items.push_back ({ key, objectHandle, materialHandle });
+}
+
+void RenderQueue::Sort ()
+{
+    std::array<size_t, 256> offsets;
+
+    if (m_items.size () < 2)
+    {
+        return;
+    }
+
+    m_sortBuffer.resize (m_items.size ());
+
+    // LSD radix sort, 8 bits per pass
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        offsets.fill (0);
+
+        for (auto&& item : m_items)
+        {
+            offsets[(item.key >> shift) & 0xff]++;
+        }
+
+        // skip pass if all keys share the same digit
+        if (offsets[(m_items[0].key >> shift) & 0xff] == m_items.size ())
+        {
+            continue;
+        }
+
+        // convert counts to starting offsets
+        size_t sum = 0;
+        for (auto&& offset : offsets)
+        {
+            size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        for (auto&& item : m_items)
+        {
+            m_sortBuffer[offsets[(item.key >> shift) & 0xff]++] = item;
+        }
+
+        m_items.swap (m_sortBuffer);
+    }
+}
+
+const std::vector<SRenderQueueItem>& RenderQueue::GetItems () const
+{
+    return m_items;
+}
+
+uint64_t RenderQueue::MakeKey (unsigned int stencil, handle_t program, handle_t material, unsigned int geometry, float depth)
+{
+    // bit pattern of non-negative float grows monotonically with its value, keep the top 24 bits
+    uint32_t depthBits = std::bit_cast<uint32_t> (depth < 0.0f ? 0.0f : depth) >> 8;
+
+    return (static_cast<uint64_t> (stencil & 0xff) << CILANTRO_RENDER_KEY_STENCIL_SHIFT)
+        | (static_cast<uint64_t> (program & 0xff) << CILANTRO_RENDER_KEY_PROGRAM_SHIFT)
+        | (static_cast<uint64_t> (material & 0xffff) << CILANTRO_RENDER_KEY_MATERIAL_SHIFT)
+        | (static_cast<uint64_t> (geometry & 0xff) << CILANTRO_RENDER_KEY_GEOMETRY_SHIFT)
+        | (static_cast<uint64_t> (depthBits & 0xffffff) << CILANTRO_RENDER_KEY_DEPTH_SHIFT);
+}
+
+unsigned int RenderQueue::GetGeometry (uint64_t key)
+{
+    return static_cast<unsigned int> ((key >> CILANTRO_RENDER_KEY_GEOMETRY_SHIFT) & 0xff);
+}
+
+} // namespace cilantro
@@ -12,6 +12,7 @@ RenderStage::RenderStage (std::shared_ptr<IRenderer> renderer)
     , m_isDepthTestEnabled (true)
     , m_isFaceCullingEnabled (true)
     , m_isFramebufferEnabled (true)
+    , m_isRenderScaleEnabled (true)
 
     , m_isClearColorOnFrameEnabled (true)
     , m_isClearDepthOnFrameEnabled (true)
@@ -120,6 +121,10 @@ void RenderStage::OnFrame ()
         {
             m_linkedDepthStencilFramebuffer->BindFramebufferRenderbuffer ();
         } 
+        else if (m_linkedDepthStencilFramebuffer->IsDepthStencilTextureEnabled ())
+        {
+            m_linkedDepthStencilFramebuffer->BindFramebufferDepthStencilTextureAsDepthStencil ();
+        }
         else if (m_linkedDepthStencilFramebuffer->GetDepthArrayLayerCount () > 0)
         {
             m_linkedDepthStencilFramebuffer->BindFramebufferDepthTextureArrayAsDepth ();
@@ -174,6 +179,13 @@ void RenderStage::OnFrame ()
     {
         width = m_linkedDrawFramebuffer->GetWidth ();
         height = m_linkedDrawFramebuffer->GetHeight ();
+
+        // dynamic resolution: draw into part of framebuffer, stage drawing to window upscales it
+        if (m_isRenderScaleEnabled)
+        {
+            width = static_cast<size_t> (width * GetRenderer ()->GetRenderScale ());
+            height = static_cast<size_t> (height * GetRenderer ()->GetRenderScale ());
+        }
     }
     else
     {
@@ -226,7 +238,14 @@ std::shared_ptr<IRenderStage> RenderStage::SetMultisampleEnabled (bool value)
             height = m_framebuffer->GetHeight ();
 
             m_framebuffer->Deinitialize ();
-            m_framebuffer = GetRenderer ()->CreateFramebuffer (width, height, rgbTextureCount, rgbaTextureCount, depthArrayLayerCount, hasDSRenderbuffer, m_isMultisampleEnabled);
+            if (m_framebuffer->IsDepthStencilTextureEnabled ())
+            {
+                m_framebuffer = GetRenderer ()->CreateFramebuffer (width, height, m_framebuffer->GetColorTextureFormats (), true, m_isMultisampleEnabled);
+            }
+            else
+            {
+                m_framebuffer = GetRenderer ()->CreateFramebuffer (width, height, rgbTextureCount, rgbaTextureCount, depthArrayLayerCount, hasDSRenderbuffer, m_isMultisampleEnabled);
+            }
             m_framebuffer->Initialize ();
         }
     }
@@ -1,22 +1,34 @@
 #include "graphics/Renderer.h"
 #include "graphics/IRenderStage.h"
+#include "graphics/RenderStage.h"
 #include "graphics/ShadowMapRenderStage.h"
 #include "graphics/DeferredGeometryRenderStage.h"
 #include "graphics/ForwardGeometryRenderStage.h"
 #include "graphics/IFramebuffer.h"
 #include "scene/GameScene.h"
+#include "scene/MeshObject.h"
+#include "scene/Camera.h"
+#include "resource/Mesh.h"
+#include "math/Frustum.h"
 #include "system/Timer.h"
 #include "system/LogMessage.h"
+#include "system/Profiler.h"
+#include <algorithm>
 #include <cmath>
 
 namespace cilantro {
 
 Renderer::Renderer (std::shared_ptr<GameScene> gameScene, unsigned int width, unsigned int height, bool shadowMappingEnabled, bool deferredRenderingEnabled)
     : m_gameScene (gameScene)
-    , m_isDeferredRendering (deferredRenderingEnabled)
-    , m_isShadowMapping (shadowMappingEnabled)
     , m_width (width)
     , m_height (height)
+    , m_isDeferredRendering (deferredRenderingEnabled)
+    , m_isShadowMapping (shadowMappingEnabled)
+    , m_isGPUCulling (false)
+    , m_isLightVolumes (false)
+    , m_isDynamicResolution (false)
+    , m_renderScale (1.0f)
+    , m_targetFrameTime (1.0f / CILANTRO_FPS)
 {
     m_totalRenderedFrames = 0L;
     m_totalDroppedFrames = 0L;
@@ -25,6 +37,9 @@ Renderer::Renderer (std::shared_ptr<GameScene> gameScene, unsigned int width, un
 
     m_lightingShaderStagesCount = 0;
 
+    m_currentRenderStageIdx = 0;
+    m_isRenderGraphDirty = true;
+
     m_renderStageManager = std::make_shared<TRenderStageManager> ();
     m_shaderProgramManager = std::make_shared<TShaderProgramManager> ();
 }
@@ -40,6 +55,15 @@ void Renderer::Initialize ()
 
 void Renderer::Deinitialize ()
 {
+    for (handle_t stageHandle : m_renderPipeline)
+    {
+        auto stageTime = m_renderStageGPUTimes.find (stageHandle);
+        if (stageTime != m_renderStageGPUTimes.end ())
+        {
+            LogMessage (MSG_LOCATION) << "Render stage" << m_renderStageManager->GetByHandle<RenderStage> (stageHandle)->GetName () << "GPU time:" << stageTime->second * 1000.0f << "ms";
+        }
+    }
+
     DeinitializeRenderStages ();
 
     LogMessage (MSG_LOCATION) << "Rendered" << m_totalRenderedFrames << "frames in" << m_totalRenderTime << "seconds; thoretical FPS =" << std::round (m_totalRenderedFrames / m_totalFrameRenderTime) << "; real FPS = " << std::round (m_totalRenderedFrames / m_totalRenderTime);
@@ -95,12 +119,16 @@ std::shared_ptr<IRenderStage> Renderer::GetCurrentRenderStage ()
 
 TRenderPipeline& Renderer::GetRenderPipeline ()
 {
+    // pipeline may be modified through returned reference
+    m_isRenderGraphDirty = true;
+
     return m_renderPipeline;
 }
 
 std::shared_ptr<IRenderer> Renderer::RotateRenderPipelineLeft ()
 {
     std::rotate (m_renderPipeline.begin (), m_renderPipeline.begin () + 1, m_renderPipeline.end ());
+    m_isRenderGraphDirty = true;
 
     return std::dynamic_pointer_cast<IRenderer> (shared_from_this ());
 }
@@ -108,48 +136,27 @@ std::shared_ptr<IRenderer> Renderer::RotateRenderPipelineLeft ()
 std::shared_ptr<IRenderer> Renderer::RotateRenderPipelineRight ()
 {
     std::rotate (m_renderPipeline.rbegin (), m_renderPipeline.rbegin () + 1, m_renderPipeline.rend ());
+    m_isRenderGraphDirty = true;
 
     return std::dynamic_pointer_cast<IRenderer> (shared_from_this ());
 }
 
 std::shared_ptr<IFramebuffer> Renderer::GetPipelineFramebuffer (EPipelineLink link)
 {
-    if ((m_currentRenderStageIdx == 0 && link == EPipelineLink::LINK_PREVIOUS) || 
-        (m_currentRenderStageIdx < 2 && link == EPipelineLink::LINK_PREVIOUS_MINUS_1) ||
-        (m_renderPipeline.size () < 2 && link == EPipelineLink::LINK_SECOND) || 
-        (m_renderPipeline.size () < 3 && link == EPipelineLink::LINK_THIRD))
-    {
-        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Pipeline index out of bounds";
-    }
+    RenderStage* linkedStage = nullptr;
 
-    if (link == EPipelineLink::LINK_FIRST)
-    {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline.front ())->GetFramebuffer ();
-    }
-    else if (link == EPipelineLink::LINK_SECOND)
+    if (m_currentRenderStageIdx < m_renderGraph.size ())
     {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline[1])->GetFramebuffer ();
+        linkedStage = m_renderGraph[m_currentRenderStageIdx].linkedStages[static_cast<size_t> (link)];
     }
-    else if (link == EPipelineLink::LINK_THIRD)
-    {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline[2])->GetFramebuffer ();
-    }
-    else if (link == EPipelineLink::LINK_PREVIOUS)
-    {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline[m_currentRenderStageIdx - 1])->GetFramebuffer ();
-    }
-    else if (link == EPipelineLink::LINK_PREVIOUS_MINUS_1)
-    {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline[m_currentRenderStageIdx - 2])->GetFramebuffer ();
-    }
-    else if (link == EPipelineLink::LINK_LAST)
-    {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline.back ())->GetFramebuffer ();
-    }
-    else /* LINK_CURRENT */
+
+    if (linkedStage == nullptr)
     {
-        return GetRenderStageManager ()->GetByHandle<IRenderStage> (m_renderPipeline[m_currentRenderStageIdx])->GetFramebuffer ();
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Pipeline index out of bounds";
+        return nullptr;
     }
+
+    return linkedStage->GetFramebuffer ();
 }
 
 void Renderer::RenderFrame ()
@@ -162,11 +169,35 @@ void Renderer::RenderFrame ()
         GetGameScene ()->GetTimer ()->ResetSplitTime ();
     }
 
+    // resolution of this frame's stages
+    if (m_isDynamicResolution)
+    {
+        float frameTime;
+        float renderScale;
+
+        if (GetMeasuredFrameTime (frameTime, renderScale))
+        {
+            UpdateRenderScale (frameTime, renderScale);
+        }
+    }
+
+    // find objects visible from active camera
+    CullScene (GetGameScene ()->GetActiveCamera ());
+
+    // stages were added or reordered
+    if (m_isRenderGraphDirty)
+    {
+        CompileRenderGraph ();
+    }
+
     // run stages
-    for (handle_t stageHandle : m_renderPipeline)
+    for (auto&& node : m_renderGraph)
     {
-        m_currentRenderStage = m_renderStageManager->GetByHandle<IRenderStage> (stageHandle);
-        m_currentRenderStage->OnFrame ();
+        CILANTRO_PROFILE_ZONE (node.stageName.c_str ());
+        m_currentRenderStage = node.stage;
+        BeginRenderStage (node.stageHandle, node.stageName);
+        node.stage->OnFrame ();
+        EndRenderStage (node.stageHandle);
         m_currentRenderStageIdx++;
     }
 
@@ -179,6 +210,49 @@ void Renderer::RenderFrame ()
     m_totalFrameRenderTime += GetGameScene ()->GetTimer ()->GetFrameRenderTime ();
 }
 
+void Renderer::CullScene (std::shared_ptr<Camera> camera)
+{
+    auto gameScene = GetGameScene ();
+
+    m_viewFrustum = camera->GetFrustum (m_width, m_height);
+    std::fill (m_isObjectVisible.begin (), m_isObjectVisible.end (), false);
+
+    if (IsGPUCulling ())
+    {
+        // all objects are submitted, meshes are tested against frustum when their draws are generated
+        m_visibleObjects.clear ();
+        for (auto gameObject : gameScene->GetGameObjectManager ())
+        {
+            m_visibleObjects.push_back (gameObject->GetHandle ());
+        }
+    }
+    else
+    {
+        // objects which are not in spatial index are never culled
+        m_visibleObjects = gameScene->GetUnindexedObjects ();
+        gameScene->GetSpatialIndex ().QueryFrustum (m_viewFrustum, m_visibleObjects);
+    }
+
+    for (handle_t objectHandle : m_visibleObjects)
+    {
+        if (objectHandle >= m_isObjectVisible.size ())
+        {
+            m_isObjectVisible.resize (objectHandle + 1, false);
+        }
+        m_isObjectVisible[objectHandle] = true;
+    }
+}
+
+const std::vector<handle_t>& Renderer::GetVisibleObjects () const
+{
+    return m_visibleObjects;
+}
+
+bool Renderer::IsVisible (handle_t objectHandle) const
+{
+    return objectHandle < m_isObjectVisible.size () && m_isObjectVisible[objectHandle];
+}
+
 AABB Renderer::CalculateAABB (std::shared_ptr<MeshObject> meshObject)
 {
     AABB aabb;
@@ -223,6 +297,114 @@ bool Renderer::IsShadowMapping () const
     return m_isShadowMapping;
 }
 
+void Renderer::SetGPUCullingEnabled (bool value)
+{
+    m_isGPUCulling = value;
+}
+
+bool Renderer::IsGPUCulling () const
+{
+    return m_isGPUCulling;
+}
+
+void Renderer::SetLightVolumesEnabled (bool value)
+{
+    m_isLightVolumes = value;
+}
+
+bool Renderer::IsLightVolumes () const
+{
+    return m_isLightVolumes;
+}
+
+void Renderer::SetDynamicResolutionEnabled (bool value)
+{
+    m_isDynamicResolution = value;
+
+    if (!value)
+    {
+        m_renderScale = 1.0f;
+    }
+}
+
+bool Renderer::IsDynamicResolution () const
+{
+    return m_isDynamicResolution;
+}
+
+void Renderer::SetTargetFrameTime (float frameTime)
+{
+    m_targetFrameTime = frameTime;
+}
+
+float Renderer::GetRenderScale () const
+{
+    return m_renderScale;
+}
+
+bool Renderer::GetMeasuredFrameTime (float& frameTime, float& renderScale)
+{
+    // last frame was rendered at current scale (it is updated before stages run)
+    frameTime = GetGameScene ()->GetTimer ()->GetFrameRenderTime ();
+    renderScale = m_renderScale;
+
+    return true;
+}
+
+void Renderer::UpdateRenderScale (float frameTime, float renderScale)
+{
+    if (!(frameTime > 0.0f) || !(renderScale > 0.0f))
+    {
+        return;
+    }
+
+    // frame time is roughly proportional to number of rendered pixels (square of scale),
+    // scale is derived from the one measured frame used, so that older measurements do not compound
+    float scale = renderScale * std::sqrt (m_targetFrameTime / frameTime);
+
+    // drop resolution at once when over budget, raise it gradually and only with headroom, so that it does not oscillate
+    if (frameTime > m_targetFrameTime)
+    {
+        m_renderScale = scale;
+    }
+    else if (frameTime < 0.85f * m_targetFrameTime)
+    {
+        m_renderScale += 0.1f * (scale - m_renderScale);
+    }
+
+    m_renderScale = std::clamp (m_renderScale, CILANTRO_MIN_RENDER_SCALE, 1.0f);
+}
+
+float Renderer::GetRenderStageGPUTime (handle_t renderStageHandle) const
+{
+    auto stageTime = m_renderStageGPUTimes.find (renderStageHandle);
+
+    return stageTime != m_renderStageGPUTimes.end () ? stageTime->second : 0.0f;
+}
+
+void Renderer::BeginRenderStage (handle_t /*renderStageHandle*/, const std::string& /*renderStageName*/)
+{
+}
+
+void Renderer::EndRenderStage (handle_t /*renderStageHandle*/)
+{
+}
+
+void Renderer::UpdateRenderStageGPUTime (handle_t renderStageHandle, float time)
+{
+    auto stageTime = m_renderStageGPUTimes.find (renderStageHandle);
+
+    // exponential moving average (first sample initializes it)
+    if (stageTime == m_renderStageGPUTimes.end ())
+    {
+        m_renderStageGPUTimes[renderStageHandle] = time;
+    }
+    else
+    {
+        stageTime->second += 0.05f * (time - stageTime->second);
+    }
+}
+
 void Renderer::InitializeRenderStages ()
 {
     if (m_isShadowMapping == true)
@@ -230,6 +412,8 @@ void Renderer::InitializeRenderStages ()
         auto shadow = this->Create<ShadowMapRenderStage> ("shadow_map");
         shadow->SetFaceCullingEnabled (true);
         shadow->SetFaceCullingMode (EFaceCullingFace::FACE_FRONT, EFaceCullingDirection::DIR_CCW);
+        // cached tiles of shadow map atlas are kept, redrawn tiles are cleared by renderer
+        shadow->SetClearDepthOnFrameEnabled (false);
         shadow->Initialize ();
     }
 
@@ -264,10 +448,46 @@ void Renderer::InitializeRenderStages ()
 
 void Renderer::DeinitializeRenderStages ()
 {
+    m_renderGraph.clear ();
+    m_currentRenderStage = nullptr;
+
     for (auto&& stage : m_renderStageManager)
     {
         stage->Deinitialize ();
     }
 }
 
+void Renderer::CompileRenderGraph ()
+{
+    size_t stageCount = m_renderPipeline.size ();
+
+    m_renderGraph.resize (stageCount);
+
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        SRenderGraphNode& node = m_renderGraph[i];
+
+        node.stageHandle = m_renderPipeline[i];
+        node.stage = m_renderStageManager->GetByHandle<RenderStage> (node.stageHandle);
+        node.stageName = node.stage->GetName ();
+    }
+
+    // links are relative to position of stage in pipeline
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        auto& linkedStages = m_renderGraph[i].linkedStages;
+        auto stageAt = [&] (size_t idx) { return idx < stageCount ? m_renderGraph[idx].stage.get () : nullptr; };
+
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_FIRST)] = stageAt (0);
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_SECOND)] = stageAt (1);
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_THIRD)] = stageAt (2);
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_PREVIOUS)] = i >= 1 ? stageAt (i - 1) : nullptr;
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_PREVIOUS_MINUS_1)] = i >= 2 ? stageAt (i - 2) : nullptr;
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_CURRENT)] = stageAt (i);
+        linkedStages[static_cast<size_t> (EPipelineLink::LINK_LAST)] = stageAt (stageCount - 1);
+    }
+
+    m_isRenderGraphDirty = false;
+}
+
 } // namespace cilantro
\ No newline at end of file
@@ -40,10 +40,15 @@ void Shader::SetDefaults ()
     SetStaticParameter ("CILANTRO_MAX_SPOT_LIGHTS", std::to_string (CILANTRO_MAX_SPOT_LIGHTS));
     SetStaticParameter ("CILANTRO_MAX_DIRECTIONAL_LIGHTS", std::to_string (CILANTRO_MAX_DIRECTIONAL_LIGHTS));
     SetStaticParameter ("CILANTRO_MAX_SPOT_LIGHTS", std::to_string (CILANTRO_MAX_SPOT_LIGHTS));
+    SetStaticParameter ("CILANTRO_LIGHT_CLUSTERS_X", std::to_string (CILANTRO_LIGHT_CLUSTERS_X));
+    SetStaticParameter ("CILANTRO_LIGHT_CLUSTERS_Y", std::to_string (CILANTRO_LIGHT_CLUSTERS_Y));
+    SetStaticParameter ("CILANTRO_LIGHT_CLUSTERS_Z", std::to_string (CILANTRO_LIGHT_CLUSTERS_Z));
     SetStaticParameter ("CILANTRO_COMPUTE_GROUP_SIZE", std::to_string (CILANTRO_COMPUTE_GROUP_SIZE));
 
+    SetStaticParameter ("CILANTRO_GBUFFER_DEPTH_BINDING", std::to_string (CILANTRO_GBUFFER_DEPTH_BINDING));
     SetStaticParameter ("CILANTRO_SHADOW_MAP_BINDING", std::to_string (CILANTRO_SHADOW_MAP_BINDING));
     SetStaticParameter ("CILANTRO_SHADOW_BIAS", std::to_string (CILANTRO_SHADOW_BIAS));
+    SetStaticParameter ("CILANTRO_MAX_SHADOW_CASCADES", std::to_string (CILANTRO_MAX_SHADOW_CASCADES));
 
     SetVariable ("ACTIVE_DIRECTIONAL_LIGHTS", "1");
     SetVariable ("ACTIVE_SPOT_LIGHTS", "1");
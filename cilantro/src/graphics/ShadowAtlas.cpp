@@ -0,0 +1,134 @@
+#include "cilantroengine.h"
+#include "graphics/ShadowAtlas.h"
+#include <algorithm>
+#include <bit>
+
+namespace cilantro {
+
+ShadowAtlas::ShadowAtlas (unsigned int size, unsigned int minTileSize)
+{
+    m_size = std::bit_floor (size);
+    m_minTileSize = std::min (std::bit_ceil (minTileSize), m_size);
+    m_freeTiles.resize (GetLevel (m_minTileSize) + 1);
+
+    Clear ();
+}
+
+ShadowAtlas::~ShadowAtlas ()
+{
+}
+
+SShadowAtlasTile ShadowAtlas::Allocate (unsigned int size)
+{
+    unsigned int tileSize = GetTileSize (size);
+    unsigned int level = GetLevel (tileSize);
+    unsigned int freeLevel = level;
+
+    // smallest free tile which is not smaller than requested
+    while (m_freeTiles[freeLevel].empty ())
+    {
+        if (freeLevel == 0)
+        {
+            return SShadowAtlasTile { 0, 0, 0 };
+        }
+
+        freeLevel--;
+    }
+
+    auto tile = *m_freeTiles[freeLevel].begin ();
+    m_freeTiles[freeLevel].erase (m_freeTiles[freeLevel].begin ());
+
+    // split down to requested level, first quadrant is kept and other three are free
+    for (unsigned int l = freeLevel + 1; l <= level; l++)
+    {
+        unsigned int half = m_size >> l;
+
+        m_freeTiles[l].insert ({ tile.first + half, tile.second });
+        m_freeTiles[l].insert ({ tile.first, tile.second + half });
+        m_freeTiles[l].insert ({ tile.first + half, tile.second + half });
+    }
+
+    return SShadowAtlasTile { tile.first, tile.second, tileSize };
+}
+
+void ShadowAtlas::Free (const SShadowAtlasTile& tile)
+{
+    if (tile.size == 0)
+    {
+        return;
+    }
+
+    unsigned int level = GetLevel (tile.size);
+    unsigned int x = tile.x;
+    unsigned int y = tile.y;
+
+    // merge with siblings as long as all of them are free
+    while (level > 0)
+    {
+        unsigned int parentSize = m_size >> (level - 1);
+        unsigned int half = parentSize >> 1;
+        unsigned int px = x - x % parentSize;
+        unsigned int py = y - y % parentSize;
+        bool isMergeable = true;
+
+        for (unsigned int q = 0; q < 4; q++)
+        {
+            unsigned int qx = px + (q & 1) * half;
+            unsigned int qy = py + (q >> 1) * half;
+
+            if ((qx != x || qy != y) && m_freeTiles[level].find ({ qx, qy }) == m_freeTiles[level].end ())
+            {
+                isMergeable = false;
+                break;
+            }
+        }
+
+        if (!isMergeable)
+        {
+            break;
+        }
+
+        for (unsigned int q = 0; q < 4; q++)
+        {
+            m_freeTiles[level].erase ({ px + (q & 1) * half, py + (q >> 1) * half });
+        }
+
+        x = px;
+        y = py;
+        level--;
+    }
+
+    m_freeTiles[level].insert ({ x, y });
+}
+
+void ShadowAtlas::Clear ()
+{
+    for (auto&& freeTiles : m_freeTiles)
+    {
+        freeTiles.clear ();
+    }
+
+    m_freeTiles[0].insert ({ 0, 0 });
+}
+
+unsigned int ShadowAtlas::GetSize () const
+{
+    return m_size;
+}
+
+unsigned int ShadowAtlas::GetMinTileSize () const
+{
+    return m_minTileSize;
+}
+
+unsigned int ShadowAtlas::GetTileSize (unsigned int size) const
+{
+    return std::clamp (std::bit_ceil (size), m_minTileSize, m_size);
+}
+
+unsigned int ShadowAtlas::GetLevel (unsigned int tileSize) const
+{
+    return static_cast<unsigned int> (std::countr_zero (m_size) - std::countr_zero (tileSize));
+}
+
+} // namespace cilantro
@@ -10,23 +10,22 @@ namespace cilantro {
 ShadowMapRenderStage::ShadowMapRenderStage (std::shared_ptr<IRenderer> renderer)
     : RenderStage (renderer)
 {
-
+    // shadow atlas tiles do not depend on screen resolution
+    m_isRenderScaleEnabled = false;
 }
 
 void ShadowMapRenderStage::Initialize ()
 {
     InitializeFramebuffer ();
 
-    // set callback for new or modified lights
+    // set callback for new or modified lights (atlas is created with first light and kept, lights get tiles in it)
     GetRenderer ()->GetGameScene ()->GetGame ()->GetMessageBus ()->Subscribe<LightUpdateMessage> (
         [&](const std::shared_ptr<LightUpdateMessage>& message) 
         { 
-            if (m_framebuffer != nullptr)
+            if (m_framebuffer == nullptr)
             {
-                m_framebuffer->Deinitialize ();
+                InitializeFramebuffer ();
             }
-
-            InitializeFramebuffer ();
         }
     );
 
@@ -36,14 +35,12 @@ void ShadowMapRenderStage::InitializeFramebuffer ()
 {   
     if (m_isFramebufferEnabled)
     {
-        size_t directionalLightCount = GetRenderer ()->GetDirectionalLightCount ();
-        size_t spotLightCount = GetRenderer ()->GetSpotLightCount ();
-        size_t pointLightCount = GetRenderer ()->GetPointLightCount ();
-        size_t layerCount = directionalLightCount + spotLightCount + pointLightCount * 6; // 6 faces for each point light
+        size_t lightCount = GetRenderer ()->GetDirectionalLightCount () + GetRenderer ()->GetSpotLightCount () + GetRenderer ()->GetPointLightCount ();
 
-        if (layerCount > 0)
+        // single layer atlas, shadow maps of all lights are tiles in it
+        if (lightCount > 0)
         {
-            m_framebuffer = GetRenderer ()->CreateFramebuffer (CILANTRO_SHADOW_MAP_SIZE, CILANTRO_SHADOW_MAP_SIZE, 0, 0, (unsigned int) layerCount, false, m_isMultisampleEnabled);
+            m_framebuffer = GetRenderer ()->CreateFramebuffer (CILANTRO_SHADOW_MAP_SIZE, CILANTRO_SHADOW_MAP_SIZE, 0, 0, 1, false, m_isMultisampleEnabled);
         }
     }
 }
@@ -52,25 +49,29 @@ void ShadowMapRenderStage::OnFrame ()
 {
     RenderStage::OnFrame ();
 
-    // load uniform buffers
+    // load uniform buffers and clear tiles to be redrawn
     GetRenderer ()->UpdateLightViewBuffers ();
 
-    // draw geometry buffers for all 3 light types   
-    if (GetRenderer ()->GetDirectionalLightCount () > 0)
+    // draw casters of all 3 light types (clipped to their tiles), cached tiles are skipped
+    GetRenderer ()->SetClipDistancesEnabled (4);
+
+    if (GetRenderer ()->GetDirectionalLightCount () > 0 && GetRenderer ()->IsShadowMapStale (ELightType::LIGHT_DIRECTIONAL))
     {
-        GetRenderer ()->DrawSceneGeometryBuffers (GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_directional_shader"));
+        GetRenderer ()->DrawShadowCasters (ELightType::LIGHT_DIRECTIONAL, GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_directional_shader"));
     }
 
-    if (GetRenderer ()->GetSpotLightCount () > 0)
+    if (GetRenderer ()->GetSpotLightCount () > 0 && GetRenderer ()->IsShadowMapStale (ELightType::LIGHT_SPOT))
     {
-        GetRenderer ()->DrawSceneGeometryBuffers (GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_spot_shader"));
+        GetRenderer ()->DrawShadowCasters (ELightType::LIGHT_SPOT, GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_spot_shader"));
     }
 
-    if (GetRenderer ()->GetPointLightCount () > 0)
+    if (GetRenderer ()->GetPointLightCount () > 0 && GetRenderer ()->IsShadowMapStale (ELightType::LIGHT_POINT))
     {
-        GetRenderer ()->DrawSceneGeometryBuffers (GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_point_shader"));
+        GetRenderer ()->DrawShadowCasters (ELightType::LIGHT_POINT, GetRenderer ()->GetShaderProgramManager ()->GetByName<IShaderProgram> ("shadowmap_point_shader"));
     }
 
+    GetRenderer ()->SetClipDistancesEnabled (0);
+
     // blit framebuffer
     if (m_framebuffer != nullptr)
     {
@@ -2,6 +2,7 @@
 #include "graphics/IRenderer.h"
 #include "graphics/IFramebuffer.h"
 #include "graphics/ShaderProgram.h"
+#include "math/Vector2f.h"
 
 namespace cilantro {
 
@@ -38,6 +39,7 @@ void SurfaceRenderStage::OnFrame ()
 
     // bind textures of framebuffer linked as previous (input) and draw
     m_shaderProgram->Use ();
+    m_shaderProgram->SetUniformVector2f ("uvScale", Vector2f (GetRenderer ()->GetRenderScale (), GetRenderer ()->GetRenderScale ()));
     m_linkedColorAttachmentsFramebuffer->BindFramebufferColorTexturesAsColor ();
 
     // draw quad
@@ -53,6 +55,7 @@ void SurfaceRenderStage::OnFrame ()
 std::shared_ptr<SurfaceRenderStage> SurfaceRenderStage::SetShaderProgram (const std::string& shaderProgramName)
 {
     m_shaderProgram = GetRenderer ()->GetShaderProgramManager ()->GetByName<ShaderProgram> (shaderProgramName);
+    m_shaderProgram->Prepare ();
 
     return std::dynamic_pointer_cast<SurfaceRenderStage> (shared_from_this ());
 }
@@ -0,0 +1,544 @@
+#include "math/AABBTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cilantro {
+
+namespace {
+
+float SurfaceArea (const float* lower, const float* upper)
+{
+    float dx = upper[0] - lower[0];
+    float dy = upper[1] - lower[1];
+    float dz = upper[2] - lower[2];
+
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+float UnionSurfaceArea (const SAABBTreeNode& a, const SAABBTreeNode& b)
+{
+    float lower[3];
+    float upper[3];
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        lower[i] = std::min (a.lowerBound[i], b.lowerBound[i]);
+        upper[i] = std::max (a.upperBound[i], b.upperBound[i]);
+    }
+
+    return SurfaceArea (lower, upper);
+}
+
+void SetUnion (SAABBTreeNode& node, const SAABBTreeNode& a, const SAABBTreeNode& b)
+{
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        node.lowerBound[i] = std::min (a.lowerBound[i], b.lowerBound[i]);
+        node.upperBound[i] = std::max (a.upperBound[i], b.upperBound[i]);
+    }
+}
+
+} // namespace
+
+AABBTree::AABBTree (float margin)
+    : m_root (CILANTRO_AABB_TREE_NULL_NODE)
+    , m_freeList (CILANTRO_AABB_TREE_NULL_NODE)
+    , m_margin (margin)
+{
+}
+
+AABBTree::~AABBTree ()
+{
+}
+
+int32_t AABBTree::Insert (const AABB& aabb, handle_t userData)
+{
+    int32_t proxy = AllocateNode ();
+    Vector3f lower = aabb.GetLowerBound ();
+    Vector3f upper = aabb.GetUpperBound ();
+    SAABBTreeNode& node = m_nodes[proxy];
+
+    // fatten bounds
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        node.lowerBound[i] = lower[i] - m_margin;
+        node.upperBound[i] = upper[i] + m_margin;
+    }
+
+    node.userData = userData;
+    node.height = 0;
+
+    InsertLeaf (proxy);
+
+    return proxy;
+}
+
+void AABBTree::Remove (int32_t proxy)
+{
+    RemoveLeaf (proxy);
+    FreeNode (proxy);
+}
+
+bool AABBTree::Update (int32_t proxy, const AABB& aabb)
+{
+    Vector3f lower = aabb.GetLowerBound ();
+    Vector3f upper = aabb.GetUpperBound ();
+    SAABBTreeNode& node = m_nodes[proxy];
+
+    // still within fattened bounds
+    if (node.lowerBound[0] <= lower[0] && node.lowerBound[1] <= lower[1] && node.lowerBound[2] <= lower[2] &&
+        node.upperBound[0] >= upper[0] && node.upperBound[1] >= upper[1] && node.upperBound[2] >= upper[2])
+    {
+        return false;
+    }
+
+    RemoveLeaf (proxy);
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        m_nodes[proxy].lowerBound[i] = lower[i] - m_margin;
+        m_nodes[proxy].upperBound[i] = upper[i] + m_margin;
+    }
+
+    InsertLeaf (proxy);
+
+    return true;
+}
+
+void AABBTree::Clear ()
+{
+    m_nodes.clear ();
+    m_root = CILANTRO_AABB_TREE_NULL_NODE;
+    m_freeList = CILANTRO_AABB_TREE_NULL_NODE;
+}
+
+handle_t AABBTree::GetUserData (int32_t proxy) const
+{
+    return m_nodes[proxy].userData;
+}
+
+int32_t AABBTree::GetHeight () const
+{
+    return (m_root == CILANTRO_AABB_TREE_NULL_NODE) ? 0 : m_nodes[m_root].height;
+}
+
+void AABBTree::QueryFrustum (const Frustum& frustum, std::vector<handle_t>& result) const
+{
+    Traverse ([&frustum] (const SAABBTreeNode& node)
+    {
+        Vector3f center ((node.lowerBound[0] + node.upperBound[0]) * 0.5f, (node.lowerBound[1] + node.upperBound[1]) * 0.5f, (node.lowerBound[2] + node.upperBound[2]) * 0.5f);
+        Vector3f extents ((node.upperBound[0] - node.lowerBound[0]) * 0.5f, (node.upperBound[1] - node.lowerBound[1]) * 0.5f, (node.upperBound[2] - node.lowerBound[2]) * 0.5f);
+
+        return frustum.Intersects (center, extents);
+    }, result);
+}
+
+void AABBTree::QuerySphere (const Vector3f& center, float radius, std::vector<handle_t>& result) const
+{
+    float c[3] = { center[0], center[1], center[2] };
+    float radiusSquared = radius * radius;
+
+    Traverse ([&c, radiusSquared] (const SAABBTreeNode& node)
+    {
+        // squared distance from sphere center to closest point of the box
+        float distanceSquared = 0.0f;
+
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            float d = std::max (std::max (node.lowerBound[i] - c[i], 0.0f), c[i] - node.upperBound[i]);
+            distanceSquared += d * d;
+        }
+
+        return distanceSquared <= radiusSquared;
+    }, result);
+}
+
+void AABBTree::QueryBox (const AABB& aabb, std::vector<handle_t>& result) const
+{
+    Vector3f lowerBound = aabb.GetLowerBound ();
+    Vector3f upperBound = aabb.GetUpperBound ();
+    float lower[3] = { lowerBound[0], lowerBound[1], lowerBound[2] };
+    float upper[3] = { upperBound[0], upperBound[1], upperBound[2] };
+
+    Traverse ([&lower, &upper] (const SAABBTreeNode& node)
+    {
+        return node.lowerBound[0] <= upper[0] && node.upperBound[0] >= lower[0] &&
+            node.lowerBound[1] <= upper[1] && node.upperBound[1] >= lower[1] &&
+            node.lowerBound[2] <= upper[2] && node.upperBound[2] >= lower[2];
+    }, result);
+}
+
+void AABBTree::QueryRay (const Vector3f& origin, const Vector3f& direction, float maxDistance, std::vector<handle_t>& result) const
+{
+    float o[3] = { origin[0], origin[1], origin[2] };
+    float invD[3];
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        invD[i] = (direction[i] != 0.0f) ? 1.0f / direction[i] : std::numeric_limits<float>::infinity ();
+    }
+
+    Traverse ([&o, &invD, maxDistance] (const SAABBTreeNode& node)
+    {
+        // slab test
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            float t1 = (node.lowerBound[i] - o[i]) * invD[i];
+            float t2 = (node.upperBound[i] - o[i]) * invD[i];
+
+            // ray parallel to slab and starting in it produces NaN, which is ignored by min/max below
+            if (std::isnan (t1) || std::isnan (t2))
+            {
+                continue;
+            }
+
+            tMin = std::max (tMin, std::min (t1, t2));
+            tMax = std::min (tMax, std::max (t1, t2));
+        }
+
+        return tMin <= tMax;
+    }, result);
+}
+
+int32_t AABBTree::AllocateNode ()
+{
+    int32_t node;
+
+    if (m_freeList == CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        node = static_cast<int32_t> (m_nodes.size ());
+        m_nodes.emplace_back ();
+    }
+    else
+    {
+        node = m_freeList;
+        m_freeList = m_nodes[node].parent;
+    }
+
+    m_nodes[node].parent = CILANTRO_AABB_TREE_NULL_NODE;
+    m_nodes[node].child1 = CILANTRO_AABB_TREE_NULL_NODE;
+    m_nodes[node].child2 = CILANTRO_AABB_TREE_NULL_NODE;
+    m_nodes[node].height = 0;
+    m_nodes[node].userData = 0;
+
+    return node;
+}
+
+void AABBTree::FreeNode (int32_t node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+void AABBTree::InsertLeaf (int32_t leaf)
+{
+    if (m_root == CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = CILANTRO_AABB_TREE_NULL_NODE;
+        return;
+    }
+
+    // find best sibling, descend while it is cheaper than pairing with current node
+    int32_t index = m_root;
+    while (m_nodes[index].child1 != CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        const SAABBTreeNode& node = m_nodes[index];
+        const SAABBTreeNode& leafNode = m_nodes[leaf];
+
+        float area = SurfaceArea (node.lowerBound, node.upperBound);
+        float combinedArea = UnionSurfaceArea (node, leafNode);
+
+        // cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        int32_t children[2] = { node.child1, node.child2 };
+
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            const SAABBTreeNode& child = m_nodes[children[i]];
+
+            if (child.child1 == CILANTRO_AABB_TREE_NULL_NODE)
+            {
+                childCost[i] = UnionSurfaceArea (child, leafNode) + inheritanceCost;
+            }
+            else
+            {
+                childCost[i] = UnionSurfaceArea (child, leafNode) - SurfaceArea (child.lowerBound, child.upperBound) + inheritanceCost;
+            }
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+        {
+            break;
+        }
+
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int32_t sibling = index;
+
+    // create new parent (nodes may be reallocated, so no references are held across allocation)
+    int32_t oldParent = m_nodes[sibling].parent;
+    int32_t newParent = AllocateNode ();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    SetUnion (m_nodes[newParent], m_nodes[leaf], m_nodes[sibling]);
+
+    if (oldParent != CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        if (m_nodes[oldParent].child1 == sibling)
+        {
+            m_nodes[oldParent].child1 = newParent;
+        }
+        else
+        {
+            m_nodes[oldParent].child2 = newParent;
+        }
+    }
+    else
+    {
+        m_root = newParent;
+    }
+
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    // walk back up the tree fixing heights and bounds
+    index = m_nodes[leaf].parent;
+    while (index != CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        index = Balance (index);
+        Refit (index);
+        index = m_nodes[index].parent;
+    }
+}
+
+void AABBTree::RemoveLeaf (int32_t leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = CILANTRO_AABB_TREE_NULL_NODE;
+        return;
+    }
+
+    int32_t parent = m_nodes[leaf].parent;
+    int32_t grandParent = m_nodes[parent].parent;
+    int32_t sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        // replace parent with sibling
+        if (m_nodes[grandParent].child1 == parent)
+        {
+            m_nodes[grandParent].child1 = sibling;
+        }
+        else
+        {
+            m_nodes[grandParent].child2 = sibling;
+        }
+
+        m_nodes[sibling].parent = grandParent;
+        FreeNode (parent);
+
+        // adjust ancestor bounds
+        int32_t index = grandParent;
+        while (index != CILANTRO_AABB_TREE_NULL_NODE)
+        {
+            index = Balance (index);
+            Refit (index);
+            index = m_nodes[index].parent;
+        }
+    }
+    else
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = CILANTRO_AABB_TREE_NULL_NODE;
+        FreeNode (parent);
+    }
+
+    m_nodes[leaf].parent = CILANTRO_AABB_TREE_NULL_NODE;
+}
+
+int32_t AABBTree::Balance (int32_t iA)
+{
+    SAABBTreeNode& a = m_nodes[iA];
+
+    if (a.child1 == CILANTRO_AABB_TREE_NULL_NODE || a.height < 2)
+    {
+        return iA;
+    }
+
+    int32_t iB = a.child1;
+    int32_t iC = a.child2;
+    SAABBTreeNode& b = m_nodes[iB];
+    SAABBTreeNode& c = m_nodes[iC];
+
+    int32_t balance = c.height - b.height;
+
+    // rotate C up
+    if (balance > 1)
+    {
+        int32_t iF = c.child1;
+        int32_t iG = c.child2;
+        SAABBTreeNode& f = m_nodes[iF];
+        SAABBTreeNode& g = m_nodes[iG];
+
+        // swap A and C
+        c.child1 = iA;
+        c.parent = a.parent;
+        a.parent = iC;
+
+        // A's old parent should point to C
+        if (c.parent != CILANTRO_AABB_TREE_NULL_NODE)
+        {
+            if (m_nodes[c.parent].child1 == iA)
+            {
+                m_nodes[c.parent].child1 = iC;
+            }
+            else
+            {
+                m_nodes[c.parent].child2 = iC;
+            }
+        }
+        else
+        {
+            m_root = iC;
+        }
+
+        // rotate
+        if (f.height > g.height)
+        {
+            c.child2 = iF;
+            a.child2 = iG;
+            g.parent = iA;
+            SetUnion (a, b, g);
+            SetUnion (c, a, f);
+            a.height = 1 + std::max (b.height, g.height);
+            c.height = 1 + std::max (a.height, f.height);
+        }
+        else
+        {
+            c.child2 = iG;
+            a.child2 = iF;
+            f.parent = iA;
+            SetUnion (a, b, f);
+            SetUnion (c, a, g);
+            a.height = 1 + std::max (b.height, f.height);
+            c.height = 1 + std::max (a.height, g.height);
+        }
+
+        return iC;
+    }
+
+    // rotate B up
+    if (balance < -1)
+    {
+        int32_t iD = b.child1;
+        int32_t iE = b.child2;
+        SAABBTreeNode& d = m_nodes[iD];
+        SAABBTreeNode& e = m_nodes[iE];
+
+        // swap A and B
+        b.child1 = iA;
+        b.parent = a.parent;
+        a.parent = iB;
+
+        // A's old parent should point to B
+        if (b.parent != CILANTRO_AABB_TREE_NULL_NODE)
+        {
+            if (m_nodes[b.parent].child1 == iA)
+            {
+                m_nodes[b.parent].child1 = iB;
+            }
+            else
+            {
+                m_nodes[b.parent].child2 = iB;
+            }
+        }
+        else
+        {
+            m_root = iB;
+        }
+
+        // rotate
+        if (d.height > e.height)
+        {
+            b.child2 = iD;
+            a.child1 = iE;
+            e.parent = iA;
+            SetUnion (a, c, e);
+            SetUnion (b, a, d);
+            a.height = 1 + std::max (c.height, e.height);
+            b.height = 1 + std::max (a.height, d.height);
+        }
+        else
+        {
+            b.child2 = iE;
+            a.child1 = iD;
+            d.parent = iA;
+            SetUnion (a, c, d);
+            SetUnion (b, a, e);
+            a.height = 1 + std::max (c.height, d.height);
+            b.height = 1 + std::max (a.height, e.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void AABBTree::Refit (int32_t node)
+{
+    SAABBTreeNode& n = m_nodes[node];
+
+    n.height = 1 + std::max (m_nodes[n.child1].height, m_nodes[n.child2].height);
+    SetUnion (n, m_nodes[n.child1], m_nodes[n.child2]);
+}
+
+template <typename F>
+void AABBTree::Traverse (F overlaps, std::vector<handle_t>& result) const
+{
+    if (m_root == CILANTRO_AABB_TREE_NULL_NODE)
+    {
+        return;
+    }
+
+    m_stack.clear ();
+    m_stack.push_back (m_root);
+
+    while (!m_stack.empty ())
+    {
+        const SAABBTreeNode& node = m_nodes[m_stack.back ()];
+        m_stack.pop_back ();
+
+        if (!overlaps (node))
+        {
+            continue;
+        }
+
+        if (node.child1 == CILANTRO_AABB_TREE_NULL_NODE)
+        {
+            result.push_back (node.userData);
+        }
+        else
+        {
+            m_stack.push_back (node.child1);
+            m_stack.push_back (node.child2);
+        }
+    }
+}
+
+} // namespace cilantro
@@ -0,0 +1,118 @@
+#include "math/Frustum.h"
+#include "math/Vector3f.h"
+#include <cmath>
+
+#if defined (__SSE__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CILANTRO_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace cilantro {
+
+Frustum::Frustum ()
+{
+    // padding planes (0, 0, 0, 1) never reject anything
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        m_planeX[i] = m_planeY[i] = m_planeZ[i] = 0.0f;
+        m_absPlaneX[i] = m_absPlaneY[i] = m_absPlaneZ[i] = 0.0f;
+        m_planeW[i] = 1.0f;
+    }
+}
+
+Frustum::Frustum (const Matrix4f& viewProjection) : Frustum ()
+{
+    SetViewProjection (viewProjection);
+}
+
+Frustum::~Frustum ()
+{
+}
+
+void Frustum::SetViewProjection (const Matrix4f& viewProjection)
+{
+    const float* r0 = viewProjection[0];
+    const float* r1 = viewProjection[1];
+    const float* r2 = viewProjection[2];
+    const float* r3 = viewProjection[3];
+
+    // planes are sums and differences of matrix rows (Gribb & Hartmann)
+    // left, right, bottom, top, near, far
+    const float* rows[3] = { r0, r1, r2 };
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        const float* r = rows[i / 2];
+
+        m_planeX[i] = r3[0] + sign * r[0];
+        m_planeY[i] = r3[1] + sign * r[1];
+        m_planeZ[i] = r3[2] + sign * r[2];
+        m_planeW[i] = r3[3] + sign * r[3];
+
+        m_absPlaneX[i] = std::fabs (m_planeX[i]);
+        m_absPlaneY[i] = std::fabs (m_planeY[i]);
+        m_absPlaneZ[i] = std::fabs (m_planeZ[i]);
+    }
+}
+
+bool Frustum::Intersects (const AABB& aabb) const
+{
+    Vector3f lower = aabb.GetLowerBound ();
+    Vector3f upper = aabb.GetUpperBound ();
+
+    // empty box (never extended by any vertex)
+    if (lower[0] > upper[0])
+    {
+        return false;
+    }
+
+    return Intersects ((lower + upper) * 0.5f, (upper - lower) * 0.5f);
+}
+
+bool Frustum::Intersects (const Vector3f& center, const Vector3f& extents) const
+{
+    // box is outside of a plane if its center distance plus projected extents is negative
+#if defined (CILANTRO_FRUSTUM_SSE)
+    __m128 cx = _mm_set1_ps (center[0]);
+    __m128 cy = _mm_set1_ps (center[1]);
+    __m128 cz = _mm_set1_ps (center[2]);
+    __m128 ex = _mm_set1_ps (extents[0]);
+    __m128 ey = _mm_set1_ps (extents[1]);
+    __m128 ez = _mm_set1_ps (extents[2]);
+    __m128 outside = _mm_setzero_ps ();
+
+    for (unsigned int i = 0; i < 8; i += 4)
+    {
+        __m128 d = _mm_add_ps (
+            _mm_add_ps (_mm_mul_ps (_mm_load_ps (m_planeX + i), cx), _mm_mul_ps (_mm_load_ps (m_planeY + i), cy)),
+            _mm_add_ps (_mm_mul_ps (_mm_load_ps (m_planeZ + i), cz), _mm_load_ps (m_planeW + i)));
+        __m128 r = _mm_add_ps (
+            _mm_add_ps (_mm_mul_ps (_mm_load_ps (m_absPlaneX + i), ex), _mm_mul_ps (_mm_load_ps (m_absPlaneY + i), ey)),
+            _mm_mul_ps (_mm_load_ps (m_absPlaneZ + i), ez));
+
+        outside = _mm_or_ps (outside, _mm_cmplt_ps (_mm_add_ps (d, r), _mm_setzero_ps ()));
+    }
+
+    return _mm_movemask_ps (outside) == 0;
+#else
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        float d = m_planeX[i] * center[0] + m_planeY[i] * center[1] + m_planeZ[i] * center[2] + m_planeW[i];
+        float r = m_absPlaneX[i] * extents[0] + m_absPlaneY[i] * extents[1] + m_absPlaneZ[i] * extents[2];
+
+        if (d + r < 0.0f)
+        {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+Vector4f Frustum::GetPlane (unsigned int index) const
+{
+    return Vector4f (m_planeX[index], m_planeY[index], m_planeZ[index], m_planeW[index]);
+}
+
+} // namespace cilantro
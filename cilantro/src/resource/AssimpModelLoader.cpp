@@ -1,6 +1,7 @@
 #include "resource/AssimpModelLoader.h"
 #include "system/LogMessage.h"
 #include "system/Game.h"
+#include "system/Profiler.h"
 #include "math/Mathf.h"
 #include "resource/Bone.h"
 #include "resource/Mesh.h"
@@ -33,6 +34,7 @@ AssimpModelLoader::~AssimpModelLoader ()
 
 void AssimpModelLoader::Load (std::string sceneName, std::string path)
 {
+    CILANTRO_PROFILE_ZONE ("Load model " + path);
     const aiScene* scene = m_importer.ReadFile (path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights);
     m_gameScene = m_game->GetGameSceneManager ()->GetByName<GameScene> (sceneName);
 
@@ -17,6 +17,13 @@ namespace cilantro {
 Mesh::Mesh () : Resource ()
 {
     this->smoothNormals = false;
+    this->version = 0;
+
+    // subscribed first, so mesh users notified by the hook already see the new version
+    SubscribeHook ("OnUpdateMesh", [&] ()
+    {
+        this->version++;
+    });
 }
 
 Mesh::~Mesh ()
@@ -209,6 +216,11 @@ size_t Mesh::GetIndexCount () const
     return indices.size ();
 }
 
+size_t Mesh::GetVersion () const
+{
+    return version;
+}
+
 float* Mesh::GetVerticesData ()
 {
     return vertices.data ();
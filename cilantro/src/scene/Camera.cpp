@@ -42,6 +42,11 @@ std::array<Vector3f, 8> Camera::GetFrustumVertices (unsigned int xRes, unsigned
     return frustumVertices;
 }
 
+Frustum Camera::GetFrustum (unsigned int xRes, unsigned int yRes) const
+{
+    return Frustum (GetProjectionMatrix (xRes, yRes) * GetViewMatrix ());
+}
+
 } // namespace cilantro
 
 
@@ -1,21 +1,110 @@
 #include "cilantroengine.h"
 #include "scene/DirectionalLight.h"
+#include "scene/GameScene.h"
 #include "graphics/Renderer.h"
+#include "math/Mathf.h"
+#include "math/Vector4f.h"
+#include "system/Game.h"
+#include <algorithm>
+#include <cmath>
 
 namespace cilantro {
 
 DirectionalLight::DirectionalLight (std::shared_ptr<GameScene> gameScene) : Light (gameScene)
 {
+    m_shadowCascadeCount = 3;
+    m_shadowCascadeSplitLambda = 0.75f;
 }
 
 DirectionalLight::~DirectionalLight ()
 {
 }
 
+std::shared_ptr<DirectionalLight> DirectionalLight::SetShadowCascadeCount (unsigned int cascadeCount)
+{
+    m_shadowCascadeCount = std::clamp (cascadeCount, 1u, static_cast<unsigned int> (CILANTRO_MAX_SHADOW_CASCADES));
+    GetGameScene ()->GetGame ()->GetMessageBus ()->Publish<LightUpdateMessage> (std::make_shared<LightUpdateMessage> (this->GetHandle ()));
+
+    return std::dynamic_pointer_cast<DirectionalLight> (shared_from_this ());
+}
+
+std::shared_ptr<DirectionalLight> DirectionalLight::SetShadowCascadeSplitLambda (float lambda)
+{
+    m_shadowCascadeSplitLambda = std::clamp (lambda, 0.0f, 1.0f);
+    GetGameScene ()->GetGame ()->GetMessageBus ()->Publish<LightUpdateMessage> (std::make_shared<LightUpdateMessage> (this->GetHandle ()));
+
+    return std::dynamic_pointer_cast<DirectionalLight> (shared_from_this ());
+}
+
+unsigned int DirectionalLight::GetShadowCascadeCount () const
+{
+    return m_shadowCascadeCount;
+}
+
+float DirectionalLight::GetShadowCascadeSplitLambda () const
+{
+    return m_shadowCascadeSplitLambda;
+}
+
+float DirectionalLight::GetShadowCascadeSplit (unsigned int cascade, float nearPlane, float farPlane) const
+{
+    float ratio = static_cast<float> (cascade) / static_cast<float> (m_shadowCascadeCount);
+    float logSplit = nearPlane * std::pow (farPlane / nearPlane, ratio);
+    float uniformSplit = nearPlane + (farPlane - nearPlane) * ratio;
+
+    return m_shadowCascadeSplitLambda * logSplit + (1.0f - m_shadowCascadeSplitLambda) * uniformSplit;
+}
+
+Matrix4f DirectionalLight::GenCascadeViewProjectionMatrix (const std::array<Vector3f, 8>& frustumVertices, float nearPlane, float farPlane, unsigned int cascade, const AABB& sceneAABB, unsigned int resolution)
+{
+    Matrix4f lightView = Mathf::GenCameraViewMatrix (GetPosition (), GetPosition () + GetForward (), GetUp ());
+
+    // cut cascade from frustum edges (near and far vertex of each edge are adjacent), view depth is linear along edges
+    float t0 = (GetShadowCascadeSplit (cascade, nearPlane, farPlane) - nearPlane) / (farPlane - nearPlane);
+    float t1 = (GetShadowCascadeSplit (cascade + 1, nearPlane, farPlane) - nearPlane) / (farPlane - nearPlane);
+    std::array<Vector3f, 8> cascadeVertices;
+
+    for (size_t e = 0; e < 4; e++)
+    {
+        Vector3f edge = frustumVertices[e * 2 + 1] - frustumVertices[e * 2];
+        cascadeVertices[e * 2] = frustumVertices[e * 2] + edge * t0;
+        cascadeVertices[e * 2 + 1] = frustumVertices[e * 2] + edge * t1;
+    }
+
+    // bounding sphere keeps size of cascade constant when camera rotates
+    Vector3f center (0.0f, 0.0f, 0.0f);
+    for (auto&& v : cascadeVertices)
+    {
+        center += v;
+    }
+    center /= 8.0f;
+
+    float radius = 0.0f;
+    for (auto&& v : cascadeVertices)
+    {
+        radius = std::max (radius, Mathf::Length (v - center));
+    }
+    radius = std::ceil (radius * 16.0f) / 16.0f;
+
+    // move cascade in light space by whole texels
+    Vector4f lightSpaceCenter = lightView * Vector4f (center, 1.0f);
+    float texelSize = 2.0f * radius / static_cast<float> (resolution);
+    float x = std::floor (lightSpaceCenter[0] / texelSize) * texelSize;
+    float y = std::floor (lightSpaceCenter[1] / texelSize) * texelSize;
+
+    // depth range includes casters of the whole scene between light and cascade
+    AABB aabbLightSpace = sceneAABB.ToSpace (lightView);
+    float minZ = std::min (aabbLightSpace.GetLowerBound ()[2], lightSpaceCenter[2] - radius);
+    float maxZ = std::max (aabbLightSpace.GetUpperBound ()[2], lightSpaceCenter[2] + radius);
+
+    // light looks along negative z axis of its view space
+    return Mathf::GenOrthographicProjectionMatrix (x - radius, x + radius, y - radius, y + radius, -maxZ, -minZ) * lightView;
+}
+
 void DirectionalLight::OnUpdate (IRenderer& renderer)
 {
     Light::OnUpdate (renderer);
     renderer.Update (std::dynamic_pointer_cast<DirectionalLight> (shared_from_this ()));
 }
 
-} // namespace cilantro
\ No newline at end of file
+} // namespace cilantro
@@ -1,11 +1,14 @@
 #include "cilantroengine.h"
 #include "scene/GameScene.h"
 #include "scene/GameObject.h"
+#include "scene/InstancedMeshObject.h"
 #include "scene/Camera.h"
 #include "scene/Material.h"
 #include "scene/PBRMaterial.h"
 #include "scene/PhongMaterial.h"
+#include "resource/Mesh.h"
 #include "system/LogMessage.h"
+#include "system/Profiler.h"
 
 #include <vector>
 
@@ -21,6 +24,29 @@ GameScene::GameScene(std::shared_ptr<Game> game)
     m_materialManager = std::make_shared<ResourceManager<Material>> ();
 
     m_renderer = nullptr;
+
+    // moved or reparented objects and their descendants need new bounds in spatial index
+    GetGame ()->GetMessageBus ()->Subscribe<TransformUpdateMessage> (
+        [&](const std::shared_ptr<TransformUpdateMessage>& message) 
+        { 
+            InvalidateSpatialIndex (message->GetHandle ());
+        }
+    );
+    GetGame ()->GetMessageBus ()->Subscribe<SceneGraphUpdateMessage> (
+        [&](const std::shared_ptr<SceneGraphUpdateMessage>& message) 
+        { 
+            InvalidateSpatialIndex (message->GetHandle ());
+        }
+    );
+
+    // modified mesh, model space bounds are recalculated on next index update
+    GetGame ()->GetMessageBus ()->Subscribe<MeshObjectUpdateMessage> (
+        [&](const std::shared_ptr<MeshObjectUpdateMessage>& message) 
+        { 
+            m_modelSpaceBounds.erase (message->GetHandle ());
+            m_spatialIndexDirtyObjects.insert (message->GetHandle ());
+        }
+    );
 }
 
 GameScene::~GameScene()
@@ -41,13 +67,18 @@ void GameScene::OnStart ()
 
 void GameScene::OnFrame ()
 {
+    CILANTRO_PROFILE_ZONE ("GameScene::OnFrame");
+
     m_timer->Tick ();
 
     for (auto gameObject : m_gameObjectManager)
     {
+        CILANTRO_PROFILE_ZONE ("GameObject::OnFrame");
         gameObject->OnFrame ();
     }
 
+    UpdateSpatialIndex ();
+
     m_renderer->RenderFrame ();
 
     m_timer->Tock ();
@@ -102,5 +133,106 @@ std::shared_ptr<Camera> GameScene::GetActiveCamera () const
     return camera;
 }
 
+void GameScene::UpdateSpatialIndex ()
+{
+    for (handle_t objectHandle : m_spatialIndexDirtyObjects)
+    {
+        auto gameObject = m_gameObjectManager->GetByHandle<GameObject> (objectHandle);
+        auto meshObject = std::dynamic_pointer_cast<MeshObject> (gameObject);
+        auto proxy = m_spatialIndexProxies.find (objectHandle);
+
+        auto instancedMeshObject = std::dynamic_pointer_cast<InstancedMeshObject> (gameObject);
+
+        // objects without geometry, skinned meshes (bounds change with every pose) and empty instanced meshes are not indexed
+        if (meshObject == nullptr || !meshObject->GetMesh ()->GetMeshBones ().empty () || (instancedMeshObject != nullptr && instancedMeshObject->GetInstanceCount () == 0))
+        {
+            if (proxy == m_spatialIndexProxies.end ())
+            {
+                m_spatialIndexProxies[objectHandle] = CILANTRO_AABB_TREE_NULL_NODE;
+                m_unindexedObjects.push_back (objectHandle);
+            }
+            else if (proxy->second != CILANTRO_AABB_TREE_NULL_NODE)
+            {
+                m_spatialIndex.Remove (proxy->second);
+                proxy->second = CILANTRO_AABB_TREE_NULL_NODE;
+                m_unindexedObjects.push_back (objectHandle);
+            }
+
+            continue;
+        }
+
+        AABB worldSpaceBounds;
+        if (instancedMeshObject != nullptr)
+        {
+            worldSpaceBounds = instancedMeshObject->GetInstancesBounds (GetModelSpaceBounds (meshObject)).ToSpace (meshObject->GetWorldTransformMatrix ());
+        }
+        else
+        {
+            worldSpaceBounds = GetModelSpaceBounds (meshObject).ToSpace (meshObject->GetWorldTransformMatrix ());
+        }
+
+        if (proxy == m_spatialIndexProxies.end ())
+        {
+            m_spatialIndexProxies[objectHandle] = m_spatialIndex.Insert (worldSpaceBounds, objectHandle);
+        }
+        else if (proxy->second == CILANTRO_AABB_TREE_NULL_NODE)
+        {
+            std::erase (m_unindexedObjects, objectHandle);
+            proxy->second = m_spatialIndex.Insert (worldSpaceBounds, objectHandle);
+        }
+        else
+        {
+            m_spatialIndex.Update (proxy->second, worldSpaceBounds);
+        }
+    }
+
+    m_spatialIndexDirtyObjects.clear ();
+}
+
+const AABB& GameScene::GetModelSpaceBounds (std::shared_ptr<MeshObject> meshObject)
+{
+    auto bounds = m_modelSpaceBounds.find (meshObject->GetHandle ());
+
+    if (bounds == m_modelSpaceBounds.end ())
+    {
+        auto mesh = meshObject->GetMesh ();
+        float* data = mesh->GetVerticesData ();
+        AABB modelSpaceBounds;
+
+        for (size_t v = 0; v < mesh->GetVertexCount (); v++)
+        {
+            modelSpaceBounds.AddVertex (Vector3f (data[v * 3], data[v * 3 + 1], data[v * 3 + 2]));
+        }
+
+        bounds = m_modelSpaceBounds.insert ({ meshObject->GetHandle (), modelSpaceBounds }).first;
+    }
+
+    return bounds->second;
+}
+
+const AABBTree& GameScene::GetSpatialIndex () const
+{
+    return m_spatialIndex;
+}
+
+const std::vector<handle_t>& GameScene::GetUnindexedObjects () const
+{
+    return m_unindexedObjects;
+}
+
+void GameScene::InvalidateSpatialIndex (handle_t objectHandle)
+{
+    // world transforms of descendants are recalculated without a message
+    m_spatialIndexDirtyObjects.insert (objectHandle);
+
+    for (auto&& child : m_gameObjectManager->GetByHandle<GameObject> (objectHandle)->GetChildren ())
+    {
+        if (auto c = child.lock ())
+        {
+            InvalidateSpatialIndex (c->GetHandle ());
+        }
+    }
+}
+
 } // namespace cilantro
 
@@ -0,0 +1,121 @@
+#include "cilantroengine.h"
+#include "scene/GameScene.h"
+#include "scene/InstancedMeshObject.h"
+#include "math/Vector3f.h"
+#include "system/Game.h"
+#include "system/LogMessage.h"
+
+#include <cmath>
+
+namespace cilantro
+{
+
+InstancedMeshObject::InstancedMeshObject (std::shared_ptr<GameScene> gameScene, const std::string& meshName, const std::string& materialName)
+    : MeshObject (gameScene, meshName, materialName)
+{
+    m_instanceTransformsVersion = 0;
+}
+
+InstancedMeshObject::~InstancedMeshObject ()
+{
+}
+
+size_t InstancedMeshObject::AddInstance (const Matrix4f& transform)
+{
+    m_instanceTransforms.push_back (transform);
+    InvalidateInstances ();
+
+    return m_instanceTransforms.size () - 1;
+}
+
+std::shared_ptr<InstancedMeshObject> InstancedMeshObject::SetInstanceTransform (size_t index, const Matrix4f& transform)
+{
+    if (index >= m_instanceTransforms.size ())
+    {
+        LogMessage (MSG_LOCATION, EXIT_FAILURE) << "Invalid instance index" << index;
+    }
+
+    m_instanceTransforms[index] = transform;
+    InvalidateInstances ();
+
+    return std::dynamic_pointer_cast<InstancedMeshObject> (shared_from_this ());
+}
+
+std::shared_ptr<InstancedMeshObject> InstancedMeshObject::ClearInstances ()
+{
+    m_instanceTransforms.clear ();
+    InvalidateInstances ();
+
+    return std::dynamic_pointer_cast<InstancedMeshObject> (shared_from_this ());
+}
+
+const Matrix4f& InstancedMeshObject::GetInstanceTransform (size_t index) const
+{
+    return m_instanceTransforms[index];
+}
+
+const std::vector<Matrix4f>& InstancedMeshObject::GetInstanceTransforms () const
+{
+    return m_instanceTransforms;
+}
+
+size_t InstancedMeshObject::GetInstanceCount () const
+{
+    return m_instanceTransforms.size ();
+}
+
+size_t InstancedMeshObject::GetInstanceTransformsVersion () const
+{
+    return m_instanceTransformsVersion;
+}
+
+AABB InstancedMeshObject::GetInstancesBounds (const AABB& meshBounds) const
+{
+    Vector3f lower = meshBounds.GetLowerBound ();
+    Vector3f upper = meshBounds.GetUpperBound ();
+    Vector3f center = (lower + upper) * 0.5f;
+    Vector3f extents = (upper - lower) * 0.5f;
+    AABB bounds;
+
+    for (auto&& m : m_instanceTransforms)
+    {
+        // transform box center and project extents on transformed axes
+        Vector3f c, e;
+        for (unsigned int r = 0; r < 3; r++)
+        {
+            c[r] = m[r][0] * center[0] + m[r][1] * center[1] + m[r][2] * center[2] + m[r][3];
+            e[r] = std::fabs (m[r][0]) * extents[0] + std::fabs (m[r][1]) * extents[1] + std::fabs (m[r][2]) * extents[2];
+        }
+
+        bounds.AddVertex (c - e);
+        bounds.AddVertex (c + e);
+    }
+
+    return bounds;
+}
+
+AABB InstancedMeshObject::GetAABB ()
+{
+    if (m_aabbDirty)
+    {
+        auto self = std::dynamic_pointer_cast<MeshObject> (shared_from_this ());
+
+        m_aabb = m_instanceTransforms.empty () ? AABB () : GetInstancesBounds (GetGameScene ()->GetModelSpaceBounds (self)).ToSpace (GetWorldTransformMatrix ());
+        m_aabbDirty = false;
+
+        InvalidateHierarchyAABB ();
+    }
+
+    return m_aabb;
+}
+
+void InstancedMeshObject::InvalidateInstances ()
+{
+    m_instanceTransformsVersion++;
+    InvalidateAABB ();
+
+    // instances move together with the object, so they are reported as its transform update
+    GetGameScene ()->GetGame ()->GetMessageBus ()->Publish<TransformUpdateMessage> (std::make_shared<TransformUpdateMessage> (this->GetHandle ()));
+}
+
+} // namespace cilantro
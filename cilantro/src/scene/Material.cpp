@@ -38,6 +38,14 @@ std::shared_ptr<Material> Material::SetDeferredLightingPassShaderProgram (const
     return std::dynamic_pointer_cast<Material> (shared_from_this ());
 }
 
+std::shared_ptr<Material> Material::SetDeferredLightVolumeShaderProgram (const std::string& name)
+{
+    m_deferredLightVolumeShaderProgram = name;
+    GetGameScene ()->GetGame ()->GetMessageBus ()->Publish<MaterialUpdateMessage> (std::make_shared<MaterialUpdateMessage> (this->GetHandle ()));
+
+    return std::dynamic_pointer_cast<Material> (shared_from_this ());
+}
+
 std::string Material::GetForwardShaderProgram () const
 {
     return m_forwardShaderProgram;
@@ -53,6 +61,11 @@ std::string Material::GetDeferredLightingPassShaderProgram () const
     return m_deferredLightingPassShaderProgram;
 }
 
+std::string Material::GetDeferredLightVolumeShaderProgram () const
+{
+    return m_deferredLightVolumeShaderProgram;
+}
+
 std::shared_ptr<GameScene> Material::GetGameScene () const
 {
     return m_gameScene.lock ();
@@ -88,6 +101,7 @@ std::shared_ptr<Material> Material::SetProperty (const std::string& propertyName
 std::shared_ptr<Material> Material::SetProperty (const std::string& propertyName, Vector3f propertyValue)
 {
     m_properties[propertyName] = {propertyValue[0], propertyValue[1], propertyValue[2]};
+    GetGameScene ()->GetGame ()->GetMessageBus ()->Publish<MaterialUpdateMessage> (std::make_shared<MaterialUpdateMessage> (this->GetHandle ()));
 
     return std::dynamic_pointer_cast<Material> (shared_from_this ());
 }
@@ -13,6 +13,7 @@ PBRMaterial::PBRMaterial (std::shared_ptr<GameScene> scene) : Material (scene)
     m_forwardShaderProgram = "pbr_forward_shader";
     m_deferredGeometryPassShaderProgram = "pbr_deferred_geometrypass_shader";
     m_deferredLightingPassShaderProgram = "pbr_deferred_lightingpass_shader";
+    m_deferredLightVolumeShaderProgram = "pbr_deferred_lightingpass_lightvolume_shader";
     
     m_albedo = std::make_shared<Texture> (1, 1, Vector3f (1.0f, 1.0f, 1.0f));
     m_normal = std::make_shared<Texture> (1, 1, Vector3f (0.5f, 0.5f, 1.0f));
@@ -13,6 +13,7 @@ PhongMaterial::PhongMaterial (std::shared_ptr<GameScene> scene) : Material (scen
     m_forwardShaderProgram = "blinnphong_forward_shader";
     m_deferredGeometryPassShaderProgram = "blinnphong_deferred_geometrypass_shader";
     m_deferredLightingPassShaderProgram = "blinnphong_deferred_lightingpass_shader";
+    m_deferredLightVolumeShaderProgram = "blinnphong_deferred_lightingpass_lightvolume_shader";
 
     m_properties["fSpecularShininess"] = {32.0f};
 
@@ -111,7 +112,7 @@ std::shared_ptr<Texture> PhongMaterial::GetSpecular ()
 
 float PhongMaterial::GetSpecularShininess ()
 {
-    return m_properties["tSpecularShininess"][0];
+    return m_properties["fSpecularShininess"][0];
 }
 
 std::shared_ptr<Texture> PhongMaterial::GetEmissive ()
@@ -2,6 +2,7 @@
 #include "scene/GameScene.h"
 #include "input/InputController.h"
 #include "system/LogMessage.h"
+#include "system/Profiler.h"
 
 namespace cilantro {
 
@@ -102,11 +103,16 @@ void Game::Stop ()
 
 void Game::Step ()
 {
+    CILANTRO_PROFILE_ZONE ("Game::Step");
+
     // step current scene
     m_currentGameScene.lock ()->OnFrame ();
 
-    // process input
-    m_inputController->OnFrame ();
+    // process input (headless games have no input controller)
+    if (m_inputController != nullptr)
+    {
+        m_inputController->OnFrame ();
+    }
 }
 
 bool Game::IsRunning ()
@@ -0,0 +1,230 @@
+#include "cilantroengine.h"
+#include "system/Profiler.h"
+#include "system/LogMessage.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cilantro {
+
+struct SProfilerEvent
+{
+    char name[CILANTRO_PROFILER_NAME_LENGTH];
+    int64_t startTime;
+    int64_t endTime;
+};
+
+// ring buffer of zones recorded by single thread (written only by that thread, without locking)
+struct SProfilerThreadBuffer
+{
+    std::vector<SProfilerEvent> events;
+    std::atomic<uint64_t> eventCount;
+    std::atomic<uint64_t> firstEvent;
+    std::atomic<bool> isWriting;
+    size_t threadId;
+};
+
+// buffers of all threads which recorded zones (kept after their thread exits, so that its zones can still be written)
+struct SProfilerRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<SProfilerThreadBuffer>> buffers;
+    std::atomic<bool> isRecording { true };
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now ();
+};
+
+static SProfilerRegistry& GetProfilerRegistry ()
+{
+    static SProfilerRegistry registry;
+
+    return registry;
+}
+
+static SProfilerThreadBuffer* GetProfilerThreadBuffer ()
+{
+    thread_local SProfilerThreadBuffer* buffer = nullptr;
+
+    // registered on first zone of thread
+    if (buffer == nullptr)
+    {
+        SProfilerRegistry& registry = GetProfilerRegistry ();
+        std::lock_guard<std::mutex> lock (registry.mutex);
+
+        auto newBuffer = std::make_unique<SProfilerThreadBuffer> ();
+        newBuffer->events.resize (CILANTRO_PROFILER_EVENTS);
+        newBuffer->eventCount = 0;
+        newBuffer->firstEvent = 0;
+        newBuffer->isWriting = false;
+        newBuffer->threadId = registry.buffers.size ();
+
+        buffer = newBuffer.get ();
+        registry.buffers.push_back (std::move (newBuffer));
+    }
+
+    return buffer;
+}
+
+static void WriteJSONString (std::ofstream& file, const char* value)
+{
+    file << '"';
+
+    for (const char* c = value; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            file << '\\' << *c;
+        }
+        else if (static_cast<unsigned char> (*c) < 0x20)
+        {
+            file << ' ';
+        }
+        else
+        {
+            file << *c;
+        }
+    }
+
+    file << '"';
+}
+
+void Profiler::RecordZone (const char* name, int64_t startTime, int64_t endTime)
+{
+    SProfilerRegistry& registry = GetProfilerRegistry ();
+
+    // zones ending while trace is copied are dropped
+    if (!registry.isRecording.load (std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    SProfilerThreadBuffer* buffer = GetProfilerThreadBuffer ();
+
+    // announce write before checking flag again (pairs with WriteChromeTrace, which clears flag before waiting for writes)
+    buffer->isWriting.store (true);
+    if (!registry.isRecording.load ())
+    {
+        buffer->isWriting.store (false, std::memory_order_release);
+        return;
+    }
+
+    uint64_t index = buffer->eventCount.load (std::memory_order_relaxed);
+    SProfilerEvent& event = buffer->events[index % CILANTRO_PROFILER_EVENTS];
+
+    std::strncpy (event.name, name, CILANTRO_PROFILER_NAME_LENGTH - 1);
+    event.name[CILANTRO_PROFILER_NAME_LENGTH - 1] = '\0';
+    event.startTime = startTime;
+    event.endTime = endTime;
+
+    // publish event to WriteChromeTrace
+    buffer->eventCount.store (index + 1, std::memory_order_release);
+    buffer->isWriting.store (false, std::memory_order_release);
+}
+
+int64_t Profiler::GetTime ()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - GetProfilerRegistry ().startTime).count ();
+}
+
+bool Profiler::WriteChromeTrace (const std::string& path)
+{
+    SProfilerRegistry& registry = GetProfilerRegistry ();
+    std::vector<std::pair<size_t, SProfilerEvent>> events;
+    char timing[64];
+    bool isFirst = true;
+
+    // pause recording and wait for writes in progress, then copy zones while no thread writes them
+    {
+        std::lock_guard<std::mutex> lock (registry.mutex);
+
+        registry.isRecording.store (false);
+
+        for (auto&& buffer : registry.buffers)
+        {
+            while (buffer->isWriting.load ())
+            {
+                std::this_thread::yield ();
+            }
+
+            uint64_t eventCount = buffer->eventCount.load (std::memory_order_acquire);
+            uint64_t firstEvent = std::max (buffer->firstEvent.load (), eventCount > CILANTRO_PROFILER_EVENTS ? eventCount - CILANTRO_PROFILER_EVENTS : 0);
+
+            for (uint64_t i = firstEvent; i < eventCount; i++)
+            {
+                events.emplace_back (buffer->threadId, buffer->events[i % CILANTRO_PROFILER_EVENTS]);
+            }
+        }
+
+        registry.isRecording.store (true, std::memory_order_release);
+    }
+
+    std::ofstream file (path, std::ios::trunc);
+    if (!file.is_open ())
+    {
+        LogMessage ("Profiler::WriteChromeTrace") << "Unable to open" << path;
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (auto&& [threadId, event] : events)
+    {
+        // complete events, timestamps and durations are in microseconds
+        std::snprintf (timing, sizeof (timing), "%.3f,\"dur\":%.3f", event.startTime / 1000.0, (event.endTime - event.startTime) / 1000.0);
+
+        file << (isFirst ? "" : ",") << "\n{\"name\":";
+        WriteJSONString (file, event.name);
+        file << ",\"cat\":\"cilantro\",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadId << ",\"ts\":" << timing << "}";
+        isFirst = false;
+    }
+
+    file << "\n]}\n";
+
+    if (!file.good ())
+    {
+        LogMessage ("Profiler::WriteChromeTrace") << "Unable to write" << path;
+        return false;
+    }
+
+    LogMessage ("Profiler::WriteChromeTrace") << "Written trace" << path;
+
+    return true;
+}
+
+void Profiler::Clear ()
+{
+    SProfilerRegistry& registry = GetProfilerRegistry ();
+    std::lock_guard<std::mutex> lock (registry.mutex);
+
+    // recording threads are not interrupted, their zones before this point are skipped
+    for (auto&& buffer : registry.buffers)
+    {
+        buffer->firstEvent = buffer->eventCount.load ();
+    }
+}
+
+ProfilerZone::ProfilerZone (const char* name)
+    : m_name (name)
+    , m_startTime (Profiler::GetTime ())
+{
+}
+
+ProfilerZone::ProfilerZone (std::string name)
+    : m_nameStorage (std::move (name))
+    , m_name (m_nameStorage.c_str ())
+    , m_startTime (Profiler::GetTime ())
+{
+}
+
+ProfilerZone::~ProfilerZone ()
+{
+    Profiler::RecordZone (m_name, m_startTime, Profiler::GetTime ());
+}
+
+} // namespace cilantro
@@ -24,6 +24,7 @@
 #include "scene/GameScene.h"
 #include "scene/GameObject.h"
 #include "scene/MeshObject.h"
+#include "scene/InstancedMeshObject.h"
 #include "scene/Camera.h"
 #include "scene/PerspectiveCamera.h"
 #include "scene/Transform.h"
@@ -247,6 +248,7 @@ PYBIND11_MODULE(pycilantro, m) {
         .def("AddGameObject", &c::GameScene::Add<c::GameObject>, py::return_value_policy::automatic)
         .def("SetActiveCamera", &c::GameScene::SetActiveCamera)
         .def("CreateMeshObject", &c::GameScene::Create<c::MeshObject, const std::string&, const std::string&>, py::return_value_policy::automatic)
+        .def("CreateInstancedMeshObject", &c::GameScene::Create<c::InstancedMeshObject, const std::string&, const std::string&>, py::return_value_policy::automatic)
         .def("CreatePointLight", &c::GameScene::Create<c::PointLight>, py::return_value_policy::automatic)
         .def("CreateDirectionalLight", &c::GameScene::Create<c::DirectionalLight>, py::return_value_policy::automatic)
         .def("CreateSpotLight", &c::GameScene::Create<c::SpotLight>, py::return_value_policy::automatic)
@@ -322,6 +324,12 @@ PYBIND11_MODULE(pycilantro, m) {
 
     py::class_<c::MeshObject, c::GameObject, std::shared_ptr<c::MeshObject>>(m, "MeshObject");
 
+    py::class_<c::InstancedMeshObject, c::MeshObject, std::shared_ptr<c::InstancedMeshObject>>(m, "InstancedMeshObject")
+        .def("AddInstance", &c::InstancedMeshObject::AddInstance)
+        .def("SetInstanceTransform", &c::InstancedMeshObject::SetInstanceTransform, py::return_value_policy::automatic)
+        .def("ClearInstances", &c::InstancedMeshObject::ClearInstances, py::return_value_policy::automatic)
+        .def("GetInstanceCount", &c::InstancedMeshObject::GetInstanceCount);
+
     py::class_<c::Camera, c::GameObject, std::shared_ptr<c::Camera>>(m, "Camera");
 
     py::class_<c::Light, c::GameObject, std::shared_ptr<c::Light>>(m, "Light")
@@ -341,7 +349,11 @@ PYBIND11_MODULE(pycilantro, m) {
         .def("GetQuadraticAttenuationFactor", &c::PointLight::GetQuadraticAttenuationFactor);
 
     py::class_<c::DirectionalLight, c::Light, std::shared_ptr<c::DirectionalLight>>(m, "DirectionalLight")
-        .def(py::init<std::shared_ptr<c::GameScene>>());
+        .def(py::init<std::shared_ptr<c::GameScene>>())
+        .def("SetShadowCascadeCount", &c::DirectionalLight::SetShadowCascadeCount, py::return_value_policy::automatic)
+        .def("SetShadowCascadeSplitLambda", &c::DirectionalLight::SetShadowCascadeSplitLambda, py::return_value_policy::automatic)
+        .def("GetShadowCascadeCount", &c::DirectionalLight::GetShadowCascadeCount)
+        .def("GetShadowCascadeSplitLambda", &c::DirectionalLight::GetShadowCascadeSplitLambda);
 
     py::class_<c::SpotLight, c::PointLight, std::shared_ptr<c::SpotLight>>(m, "SpotLight")
         .def(py::init<std::shared_ptr<c::GameScene>>())